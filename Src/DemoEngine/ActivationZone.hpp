@@ -0,0 +1,173 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef ACTIVATIONZONE_HPP
+#define ACTIVATIONZONE_HPP
+
+#include <memory>
+#include <vector>
+#include "GameObject.hpp"
+#include "Vector2.hpp"
+
+namespace DemoEngine
+{
+    using std::shared_ptr;
+    using std::vector;
+
+    /// Keeps objects outside of an activation band (viewport + margin) asleep.
+    /// Sleeping objects are not updated, their position is evaluated from the
+    /// position and speed they had when they fell asleep.
+    class CActivationZone
+    {
+        public:
+            typedef shared_ptr<CGameObjectFloat> Object_t;
+
+            CActivationZone() : m_vSleepers(), m_vWoken() {};
+            ~CActivationZone() {};
+
+            /** \brief Sets the active area (usually the viewport) and the margin around it.
+             *
+             * \param x int - Left edge of the area.
+             * \param y int - Top edge of the area.
+             * \param w int - Width of the area.
+             * \param h int - Height of the area.
+             * \param iMargin int - Objects closer than this to the area are active too.
+             * \return void
+             *
+             */
+            void SetBounds( int x, int y, int w, int h, int iMargin )
+            {
+                m_fMinX = x - iMargin;
+                m_fMinY = y - iMargin;
+                m_fMaxX = x + w + iMargin;
+                m_fMaxY = y + h + iMargin;
+            }
+
+            inline bool IsActive( float x, float y ) const
+            {
+                return ( x >= m_fMinX && x <= m_fMaxX && y >= m_fMinY && y <= m_fMaxY );
+            }
+
+            /** \brief Puts object to sleep if it is outside of the activation band.
+             *
+             * \param obj const Object_t& - Object to test.
+             * \param fTime float - Current game time in seconds.
+             * \return bool - true if the object was put to sleep.
+             *
+             */
+            bool Sleep( const Object_t& obj, float fTime )
+            {
+                if ( obj->IsSleeping() || IsActive( obj->GetPosition()[0], obj->GetPosition()[1] ) ) {
+                    return false;
+                }
+                Sleeper_t sleeper = { obj, obj->GetPosition(), obj->GetSpeed(), fTime };
+                m_vSleepers.push_back( sleeper );
+                obj->SetSleeping( true );
+                return true;
+            }
+
+            /** \brief Removes a sleeping object without waking it up (i.e. when the object dies).
+             *
+             * \param obj const Object_t& - Object to remove.
+             * \return void
+             *
+             */
+            void Remove( const Object_t& obj )
+            {
+                for ( size_t i = 0; i < m_vSleepers.size(); ++i ) {
+                    if ( m_vSleepers[i].obj == obj ) {
+                        m_vSleepers[i] = m_vSleepers.back();
+                        m_vSleepers.pop_back();
+                        break;
+                    }
+                }
+                obj->SetSleeping( false );
+            }
+
+            /** \brief Moves sleeping objects to their position at fTime and wakes up the ones that entered the band.
+             *
+             * \param fTime float - Current game time in seconds.
+             * \return vector<Object_t>& - Objects woken up by this call (valid until the next call).
+             *
+             */
+            vector<Object_t>& Advance( float fTime )
+            {
+                m_vWoken.clear();
+                size_t i = 0;
+                while ( i < m_vSleepers.size() ) {
+                    Sleeper_t& s = m_vSleepers[i];
+                    float fElapsed = fTime - s.fTime;
+                    auto& pos = s.obj->GetPosition();
+                    pos[0] = s.vPosition[0] + s.vSpeed[0] * fElapsed;
+                    pos[1] = s.vPosition[1] + s.vSpeed[1] * fElapsed;
+                    if ( IsActive( pos[0], pos[1] ) ) {
+                        s.obj->SetSleeping( false );
+                        s.obj->UpdateBoundingBox();
+                        m_vWoken.push_back( s.obj );
+                        m_vSleepers[i] = m_vSleepers.back();
+                        m_vSleepers.pop_back();
+                    } else {
+                        ++i;
+                    }
+                }
+                return m_vWoken;
+            }
+
+            inline size_t Count() const { return m_vSleepers.size(); }
+
+            void Reserve( size_t nSize )
+            {
+                m_vSleepers.reserve( nSize );
+                m_vWoken.reserve( nSize );
+            }
+
+            void Clear()
+            {
+                for ( auto& s : m_vSleepers ) {
+                    s.obj->SetSleeping( false );
+                }
+                m_vSleepers.clear();
+                m_vWoken.clear();
+            }
+
+        protected:
+        private:
+            typedef struct {
+                Object_t obj;
+                CVector2f vPosition;    // position when put to sleep
+                CVector2f vSpeed;
+                float fTime;            // time when put to sleep
+            } Sleeper_t;
+
+            vector<Sleeper_t> m_vSleepers;
+            vector<Object_t> m_vWoken;
+            float m_fMinX = 0.0f;
+            float m_fMinY = 0.0f;
+            float m_fMaxX = 0.0f;
+            float m_fMaxY = 0.0f;
+    };
+}
+
+#endif // ACTIVATIONZONE_HPP
@@ -0,0 +1,62 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include <cstdlib>
+#include <new>
+#include "AllocationCounter.hpp"
+
+namespace DemoEngine {
+
+    std::atomic<unsigned int> CAllocationCounter::s_nCount( 0 );
+
+}
+
+#ifdef DEBUG_ALLOCATIONS
+
+void* operator new( std::size_t nSize ) throw( std::bad_alloc )
+{
+    DemoEngine::CAllocationCounter::Add();
+    void* p = std::malloc( nSize ? nSize : 1 );
+    if ( p == nullptr )
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[]( std::size_t nSize ) throw( std::bad_alloc )
+{
+    return ::operator new( nSize );
+}
+
+void operator delete( void* p ) throw()
+{
+    std::free( p );
+}
+
+void operator delete[]( void* p ) throw()
+{
+    std::free( p );
+}
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <atomic>
+
+namespace DemoEngine {
+
+    /// Counts heap allocations made through the global operator new.
+    /// The counting operator new is compiled in only when DEBUG_ALLOCATIONS is defined,
+    /// otherwise the count stays at zero.
+    class CAllocationCounter
+    {
+        public:
+            static unsigned int GetCount() { return s_nCount.load(); }
+            static void Add() { s_nCount++; }
+        private:
+            static std::atomic<unsigned int> s_nCount;
+    };
+
+    /// Reports the number of allocations between Begin() and End().
+    /// Note that allocations done by other threads (explosion thread, sound) are counted too.
+    class CAllocationGuard
+    {
+        public:
+            CAllocationGuard() {};
+            ~CAllocationGuard() {};
+
+            inline void Begin() { m_nStart = CAllocationCounter::GetCount(); }
+            inline unsigned int End() const { return CAllocationCounter::GetCount() - m_nStart; }
+
+        private:
+            unsigned int m_nStart = 0;
+    };
+
+}
+
+#endif // ALLOCATIONCOUNTER_HPP
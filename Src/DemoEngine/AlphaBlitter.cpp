@@ -0,0 +1,682 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include "AlphaBlitter.hpp"
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || ( defined(__GNUC__) && ( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) ) && ( defined(__i386__) || defined(__x86_64__) ) )
+#define ALPHABLITTER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace DemoEngine {
+
+    namespace {
+
+        /** \brief a * b / 255 rounded
+         */
+        inline Uint32 Multiply255( Uint32 a, Uint32 b )
+        {
+            Uint32 x = a * b + 128;
+            return ( ( x + ( x >> 8 ) ) >> 8 );
+        }
+
+        /** \brief Whether the rows of the source can be drawn on the destination as they are
+         *
+         * Both are 32-bit with the same RGB layout, the destination has no alpha channel.
+         */
+        inline bool SameLayout( const SDL_Surface* pSource, const SDL_Surface* pDest )
+        {
+            const SDL_PixelFormat* sf = pSource->format;
+            const SDL_PixelFormat* df = pDest->format;
+            if ( sf->BytesPerPixel != 4 || df->BytesPerPixel != 4 || df->Amask != 0 ) return false;
+            if ( sf->Rmask != df->Rmask || sf->Gmask != df->Gmask || sf->Bmask != df->Bmask ) return false;
+            if ( ( sf->Rmask | sf->Gmask | sf->Bmask ) != 0x00ffffff ) return false;
+            return ( !SDL_MUSTLOCK( pSource ) );
+        }
+
+        /** \brief Blends the RGB channels, same as SDL's BlitRGBtoRGBPixelAlpha
+         */
+        inline Uint32 Blend( Uint32 s, Uint32 d, Uint32 alpha )
+        {
+            Uint32 s1 = s & 0xff00ff;
+            Uint32 d1 = d & 0xff00ff;
+            d1 = ( d1 + ( ( s1 - d1 ) * alpha >> 8 ) ) & 0xff00ff;
+            s &= 0xff00;
+            d &= 0xff00;
+            d = ( d + ( ( s - d ) * alpha >> 8 ) ) & 0xff00;
+            return ( d1 | d );
+        }
+
+        void PixelAlphaRow( const Uint32* src, Uint32* dst, int w, Uint32 global )
+        {
+            for ( int i = 0; i < w; ++i ) {
+                Uint32 s = src[i];
+                Uint32 alpha = s >> 24;
+                if ( global < 255 ) alpha = Multiply255( alpha, global );
+                if ( alpha == 0 ) continue;
+                if ( alpha == 255 ) dst[i] = ( s & 0xffffff ) | ( dst[i] & 0xff000000 );
+                else dst[i] = Blend( s, dst[i], alpha ) | ( dst[i] & 0xff000000 );
+            }
+        }
+
+        void SurfaceAlphaRow( const Uint32* src, Uint32* dst, int w, Uint32 alpha )
+        {
+            for ( int i = 0; i < w; ++i )
+                dst[i] = Blend( src[i], dst[i], alpha ) | 0xff000000;
+        }
+
+        void ColorkeyRow( const Uint32* src, Uint32* dst, int w, Uint32 key )
+        {
+            for ( int i = 0; i < w; ++i ) {
+                if ( ( src[i] & 0xffffff ) != key ) dst[i] = src[i];
+            }
+        }
+
+        /** \brief Scales every channel of s by the same channel of m, c * (m + 1) >> 8
+         */
+        inline Uint32 Modulate( Uint32 s, Uint32 m )
+        {
+            Uint32 r = 0;
+            for ( int shift = 0; shift < 32; shift += 8 )
+                r |= ( ( ( s >> shift ) & 0xff ) * ( ( ( m >> shift ) & 0xff ) + 1 ) >> 8 ) << shift;
+            return ( r );
+        }
+
+        /** \brief Premultiplied blend, d * (256 - a) >> 8 + s
+         *
+         * The color channels of a premultiplied pixel are never above its alpha, so the sum
+         * can't overflow into the next channel. modulate is the fade in the top byte and the
+         * tint (already scaled by the fade) below it, 0xffffffff for none.
+         */
+        void PremultipliedRow( const Uint32* src, Uint32* dst, int w, Uint32 modulate )
+        {
+            bool bModulate = ( modulate != 0xffffffff );
+            for ( int i = 0; i < w; ++i ) {
+                Uint32 s = src[i];
+                if ( bModulate ) s = Modulate( s, modulate );
+                Uint32 alpha = s >> 24;
+                if ( alpha == 0 ) continue;
+                Uint32 d = dst[i];
+                Uint32 inv = 256 - alpha;
+                Uint32 d1 = ( ( d & 0xff00ff ) * inv >> 8 ) & 0xff00ff;
+                Uint32 d2 = ( ( d & 0xff00 ) * inv >> 8 ) & 0xff00;
+                dst[i] = ( ( s & 0xffffff ) + ( d1 | d2 ) ) | ( d & 0xff000000 );
+            }
+        }
+
+        #ifdef ALPHABLITTER_SSE2
+
+        /** \brief (d * (256 - a) + s * a) >> 8 for 16-bit channels, equal to Blend for a in 0..256
+         */
+        __attribute__((target("sse2"))) inline __m128i Blend16( __m128i s, __m128i d, __m128i a )
+        {
+            __m128i inv = _mm_sub_epi16( _mm_set1_epi16( 256 ), a );
+            return _mm_srli_epi16( _mm_add_epi16( _mm_mullo_epi16( d, inv ), _mm_mullo_epi16( s, a ) ), 8 );
+        }
+
+        /** \brief Per-pixel alpha of two pixels in every channel, 255 is turned into 256 for exact copies
+         */
+        __attribute__((target("sse2"))) inline __m128i Alpha16( __m128i s, __m128i global, bool bGlobal )
+        {
+            __m128i a = _mm_shufflehi_epi16( _mm_shufflelo_epi16( s, 0xff ), 0xff );
+            if ( bGlobal ) {
+                a = _mm_add_epi16( _mm_mullo_epi16( a, global ), _mm_set1_epi16( 128 ) );
+                a = _mm_srli_epi16( _mm_add_epi16( a, _mm_srli_epi16( a, 8 ) ), 8 );
+            }
+            return _mm_sub_epi16( a, _mm_cmpeq_epi16( a, _mm_set1_epi16( 255 ) ) );
+        }
+
+        __attribute__((target("sse2"))) void PixelAlphaRowSSE2( const Uint32* src, Uint32* dst, int w, Uint32 global )
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i rgb = _mm_set1_epi32( 0x00ffffff );
+            const __m128i g = _mm_set1_epi16( (short)global );
+            bool bGlobal = ( global < 255 );
+            int i = 0;
+            for ( ; i + 4 <= w; i += 4 ) {
+                __m128i s = _mm_loadu_si128( (const __m128i*)( src + i ) );
+                __m128i d = _mm_loadu_si128( (const __m128i*)( dst + i ) );
+                __m128i slo = _mm_unpacklo_epi8( s, zero );
+                __m128i shi = _mm_unpackhi_epi8( s, zero );
+                __m128i lo = Blend16( slo, _mm_unpacklo_epi8( d, zero ), Alpha16( slo, g, bGlobal ) );
+                __m128i hi = Blend16( shi, _mm_unpackhi_epi8( d, zero ), Alpha16( shi, g, bGlobal ) );
+                __m128i r = _mm_packus_epi16( lo, hi );
+                r = _mm_or_si128( _mm_and_si128( r, rgb ), _mm_andnot_si128( rgb, d ) );
+                _mm_storeu_si128( (__m128i*)( dst + i ), r );
+            }
+            PixelAlphaRow( src + i, dst + i, w - i, global );
+        }
+
+        __attribute__((target("sse2"))) void SurfaceAlphaRowSSE2( const Uint32* src, Uint32* dst, int w, Uint32 alpha )
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i a = _mm_set1_epi16( (short)alpha );
+            const __m128i opaque = _mm_set1_epi32( (int)0xff000000 );
+            int i = 0;
+            for ( ; i + 4 <= w; i += 4 ) {
+                __m128i s = _mm_loadu_si128( (const __m128i*)( src + i ) );
+                __m128i d = _mm_loadu_si128( (const __m128i*)( dst + i ) );
+                __m128i lo = Blend16( _mm_unpacklo_epi8( s, zero ), _mm_unpacklo_epi8( d, zero ), a );
+                __m128i hi = Blend16( _mm_unpackhi_epi8( s, zero ), _mm_unpackhi_epi8( d, zero ), a );
+                _mm_storeu_si128( (__m128i*)( dst + i ), _mm_or_si128( _mm_packus_epi16( lo, hi ), opaque ) );
+            }
+            SurfaceAlphaRow( src + i, dst + i, w - i, alpha );
+        }
+
+        __attribute__((target("sse2"))) void PremultipliedRowSSE2( const Uint32* src, Uint32* dst, int w, Uint32 modulate )
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i rgb = _mm_set1_epi32( 0x00ffffff );
+            const __m128i full = _mm_set1_epi16( 256 );
+            const __m128i m = _mm_add_epi16( _mm_unpacklo_epi8( _mm_set1_epi32( (int)modulate ), zero ), _mm_set1_epi16( 1 ) );
+            bool bModulate = ( modulate != 0xffffffff );
+            int i = 0;
+            for ( ; i + 4 <= w; i += 4 ) {
+                __m128i s = _mm_loadu_si128( (const __m128i*)( src + i ) );
+                __m128i d = _mm_loadu_si128( (const __m128i*)( dst + i ) );
+                __m128i slo = _mm_unpacklo_epi8( s, zero );
+                __m128i shi = _mm_unpackhi_epi8( s, zero );
+                if ( bModulate ) {
+                    slo = _mm_srli_epi16( _mm_mullo_epi16( slo, m ), 8 );
+                    shi = _mm_srli_epi16( _mm_mullo_epi16( shi, m ), 8 );
+                }
+                __m128i invlo = _mm_sub_epi16( full, _mm_shufflehi_epi16( _mm_shufflelo_epi16( slo, 0xff ), 0xff ) );
+                __m128i invhi = _mm_sub_epi16( full, _mm_shufflehi_epi16( _mm_shufflelo_epi16( shi, 0xff ), 0xff ) );
+                __m128i lo = _mm_add_epi16( slo, _mm_srli_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( d, zero ), invlo ), 8 ) );
+                __m128i hi = _mm_add_epi16( shi, _mm_srli_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( d, zero ), invhi ), 8 ) );
+                __m128i r = _mm_packus_epi16( lo, hi );
+                r = _mm_or_si128( _mm_and_si128( r, rgb ), _mm_andnot_si128( rgb, d ) );
+                _mm_storeu_si128( (__m128i*)( dst + i ), r );
+            }
+            PremultipliedRow( src + i, dst + i, w - i, modulate );
+        }
+
+        __attribute__((target("sse2"))) void ColorkeyRowSSE2( const Uint32* src, Uint32* dst, int w, Uint32 key )
+        {
+            const __m128i rgb = _mm_set1_epi32( 0x00ffffff );
+            const __m128i k = _mm_set1_epi32( (int)key );
+            int i = 0;
+            for ( ; i + 4 <= w; i += 4 ) {
+                __m128i s = _mm_loadu_si128( (const __m128i*)( src + i ) );
+                __m128i d = _mm_loadu_si128( (const __m128i*)( dst + i ) );
+                __m128i mask = _mm_cmpeq_epi32( _mm_and_si128( s, rgb ), k );
+                _mm_storeu_si128( (__m128i*)( dst + i ), _mm_or_si128( _mm_and_si128( mask, d ), _mm_andnot_si128( mask, s ) ) );
+            }
+            ColorkeyRow( src + i, dst + i, w - i, key );
+        }
+
+        #endif
+
+    }
+
+    CAlphaBlitter::CAlphaBlitter()
+    {
+        #ifdef ALPHABLITTER_SSE2
+        m_bHasSSE2 = ( SDL_HasSSE2() != 0 );
+        #endif
+        m_bSSE2 = m_bHasSSE2;
+    }
+
+    /** \brief Returns how a blit between the surfaces would be done with their current state
+     *
+     * A premultiplied source doesn't need to have SDL_SRCALPHA set and the destination
+     * may need locking (Blit locks it).
+     *
+     * \param pSource SDL_Surface*
+     * \param pDest SDL_Surface*
+     * \param bPremultiplied bool - The source has premultiplied alpha.
+     * \return int - MODE, MODE_NONE if SDL should do the blit.
+     *
+     */
+    int CAlphaBlitter::GetMode( SDL_Surface* pSource, SDL_Surface* pDest, bool bPremultiplied ) const
+    {
+        if ( !m_bEnabled && !bPremultiplied ) return( MODE_NONE );
+        if ( !SameLayout( pSource, pDest ) ) return( MODE_NONE );
+        const SDL_PixelFormat* sf = pSource->format;
+        if ( bPremultiplied ) return( sf->Amask == 0xff000000 ? MODE_PREMULTIPLIED : MODE_NONE );
+        if ( SDL_MUSTLOCK( pDest ) ) return( MODE_NONE );
+
+        if ( sf->Amask == 0xff000000 ) {
+            return( ( pSource->flags & SDL_SRCALPHA ) ? MODE_PIXELALPHA : MODE_NONE );
+        }
+        if ( sf->Amask != 0 ) return( MODE_NONE );
+        bool bAlpha = ( pSource->flags & SDL_SRCALPHA ) && sf->alpha != 255;
+        bool bColorkey = ( pSource->flags & SDL_SRCCOLORKEY ) != 0;
+        if ( bAlpha && !bColorkey ) return( MODE_SURFACEALPHA );
+        if ( bColorkey && !bAlpha ) return( MODE_COLORKEY );
+        return( MODE_NONE );
+    }
+
+    /** \brief Clips and blits like SDL_BlitSurface
+     *
+     * \param pSource SDL_Surface*
+     * \param pSrcRect const SDL_Rect* - Source area or nullptr for the whole surface.
+     * \param pDest SDL_Surface*
+     * \param pDstRect SDL_Rect* - Position, on return the clipped area that was drawn.
+     * \param cAlpha Uint8 - Image alpha, scales the per-pixel alpha when below kOpaqueAlpha.
+     * \param pSpans const CSpanSprite* - Spans of the source or nullptr.
+     * \param bPremultiplied bool - The source has premultiplied alpha.
+     * \param nTint Uint32 - Tint of a premultiplied source.
+     * \return bool - false if the blit was not done (the formats or the blend are not supported).
+     *
+     */
+    bool CAlphaBlitter::Blit( SDL_Surface* pSource, const SDL_Rect* pSrcRect, SDL_Surface* pDest, SDL_Rect* pDstRect, Uint8 cAlpha,
+                              const CSpanSprite* pSpans, bool bPremultiplied, Uint32 nTint )
+    {
+        int iMode = GetMode( pSource, pDest, bPremultiplied );
+        if ( iMode == MODE_NONE ) return( false );
+
+        int srcx, srcy, w, h;
+        int dstx = pDstRect->x;
+        int dsty = pDstRect->y;
+        if ( pSrcRect ) {
+            srcx = pSrcRect->x;
+            w = pSrcRect->w;
+            if ( srcx < 0 ) {
+                w += srcx;
+                dstx -= srcx;
+                srcx = 0;
+            }
+            if ( pSource->w - srcx < w ) w = pSource->w - srcx;
+            srcy = pSrcRect->y;
+            h = pSrcRect->h;
+            if ( srcy < 0 ) {
+                h += srcy;
+                dsty -= srcy;
+                srcy = 0;
+            }
+            if ( pSource->h - srcy < h ) h = pSource->h - srcy;
+        } else {
+            srcx = srcy = 0;
+            w = pSource->w;
+            h = pSource->h;
+        }
+
+        const SDL_Rect& clip = pDest->clip_rect;
+        int dx = clip.x - dstx;
+        if ( dx > 0 ) {
+            w -= dx;
+            dstx += dx;
+            srcx += dx;
+        }
+        dx = dstx + w - clip.x - clip.w;
+        if ( dx > 0 ) w -= dx;
+        int dy = clip.y - dsty;
+        if ( dy > 0 ) {
+            h -= dy;
+            dsty += dy;
+            srcy += dy;
+        }
+        dy = dsty + h - clip.y - clip.h;
+        if ( dy > 0 ) h -= dy;
+
+        pDstRect->x = (Sint16)dstx;
+        pDstRect->y = (Sint16)dsty;
+        if ( w <= 0 || h <= 0 ) {
+            pDstRect->w = pDstRect->h = 0;
+            return( true );
+        }
+        pDstRect->w = (Uint16)w;
+        pDstRect->h = (Uint16)h;
+        SDL_Rect src = { (Sint16)srcx, (Sint16)srcy, (Uint16)w, (Uint16)h };
+        bool bLock = SDL_MUSTLOCK( pDest );
+        if ( bLock && SDL_LockSurface( pDest ) < 0 ) return( true );
+        LowerBlit( pSource, src, pDest, *pDstRect, cAlpha, pSpans, bPremultiplied, nTint );
+        if ( bLock ) SDL_UnlockSurface( pDest );
+        ++m_nBlits[iMode];
+        if ( m_bSpans && pSpans && pSpans->Matches( pSource ) ) ++m_nSpanBlits;
+        return( true );
+    }
+
+    /** \brief Blits already clipped rectangles (like SDL_LowerBlit)
+     *
+     * Every row is drawn the same way no matter which rows are drawn, so a blit split into
+     * horizontal bands gives the same pixels as one blit.
+     *
+     * \param pSource SDL_Surface*
+     * \param src const SDL_Rect&
+     * \param pDest SDL_Surface*
+     * \param dst const SDL_Rect& - Only x and y are used.
+     * \param cAlpha Uint8 - Image alpha, scales the per-pixel alpha when below kOpaqueAlpha.
+     * \param pSpans const CSpanSprite* - Spans of the source or nullptr, used if they match the surface.
+     * \param bPremultiplied bool - The source has premultiplied alpha.
+     * \param nTint Uint32 - Tint of a premultiplied source.
+     * \return bool - false if the blit was not done.
+     *
+     */
+    bool CAlphaBlitter::LowerBlit( SDL_Surface* pSource, const SDL_Rect& src, SDL_Surface* pDest, const SDL_Rect& dst, Uint8 cAlpha,
+                                   const CSpanSprite* pSpans, bool bPremultiplied, Uint32 nTint )
+    {
+        int iMode = GetMode( pSource, pDest, bPremultiplied );
+        if ( iMode == MODE_NONE ) return( false );
+
+        Uint32 nParam = 0;
+        Row_t row = GetRow( iMode, pSource, cAlpha, nTint, nParam );
+        if ( m_bSpans && pSpans && iMode != MODE_SURFACEALPHA && pSpans->Matches( pSource ) ) {
+            SpanBlit( pSpans, src, pDest, dst, row, nParam, CanCopyOpaque( iMode, nParam ) );
+            return( true );
+        }
+
+        const Uint8* pSrc = (const Uint8*)pSource->pixels + src.y * pSource->pitch + src.x * 4;
+        Uint8* pDst = (Uint8*)pDest->pixels + dst.y * pDest->pitch + dst.x * 4;
+        for ( int y = 0; y < src.h; ++y ) {
+            row( (const Uint32*)pSrc, (Uint32*)pDst, src.w, nParam );
+            pSrc += pSource->pitch;
+            pDst += pDest->pitch;
+        }
+        return( true );
+    }
+
+    /** \brief Selects the row function of a blend mode and its parameter
+     *
+     * \param iMode int - MODE, not MODE_NONE.
+     * \param pSource SDL_Surface*
+     * \param cAlpha Uint8 - Image alpha, scales the per-pixel alpha when below kOpaqueAlpha.
+     * \param nTint Uint32 - Tint of a premultiplied source.
+     * \param nParam Uint32& - Parameter for the row function.
+     * \return Row_t
+     *
+     */
+    CAlphaBlitter::Row_t CAlphaBlitter::GetRow( int iMode, SDL_Surface* pSource, Uint8 cAlpha, Uint32 nTint, Uint32& nParam ) const
+    {
+        Row_t row = nullptr;
+        switch ( iMode ) {
+            case MODE_PIXELALPHA:
+                row = PixelAlphaRow;
+                nParam = ( cAlpha >= kOpaqueAlpha ? 255 : cAlpha );
+                break;
+            case MODE_SURFACEALPHA:
+                row = SurfaceAlphaRow;
+                nParam = pSource->format->alpha;
+                break;
+            case MODE_COLORKEY:
+                row = ColorkeyRow;
+                nParam = pSource->format->colorkey & 0xffffff;
+                break;
+            case MODE_PREMULTIPLIED:
+            {
+                // The tint is scaled by the fade so the colors stay premultiplied
+                Uint32 nFade = ( cAlpha >= kOpaqueAlpha ? 255 : cAlpha );
+                row = PremultipliedRow;
+                nParam = nFade << 24;
+                for ( int shift = 0; shift < 24; shift += 8 )
+                    nParam |= Multiply255( ( nTint >> shift ) & 0xff, nFade ) << shift;
+                break;
+            }
+            default:
+                break;
+        }
+        #ifdef ALPHABLITTER_SSE2
+        if ( m_bSSE2 ) {
+            switch ( iMode ) {
+                case MODE_PIXELALPHA: row = PixelAlphaRowSSE2; break;
+                case MODE_SURFACEALPHA: row = SurfaceAlphaRowSSE2; break;
+                case MODE_COLORKEY: row = ColorkeyRowSSE2; break;
+                case MODE_PREMULTIPLIED: row = PremultipliedRowSSE2; break;
+                default: break;
+            }
+        }
+        #endif
+        return( row );
+    }
+
+    /** \brief Whether opaque spans can be copied instead of blended
+     *
+     * Colorkey spans are all opaque, per-pixel alpha spans blend with the image alpha
+     * and premultiplied spans with the fade and tint.
+     *
+     * \param iMode int
+     * \param nParam Uint32 - Parameter of the row function, see GetRow.
+     * \return bool
+     *
+     */
+    bool CAlphaBlitter::CanCopyOpaque( int iMode, Uint32 nParam )
+    {
+        if ( iMode == MODE_PIXELALPHA ) return( nParam == 255 );
+        return( iMode == MODE_COLORKEY || nParam == 0xffffffff );
+    }
+
+    /** \brief Fills a rectangle with the source repeated in both directions
+     *
+     * Every destination row is drawn in one pass, split only where the source wraps around.
+     * Opaque sources (no alpha or colorkey) are copied with memcpy, the others are blended
+     * with the same rows (and spans) as Blit.
+     *
+     * \param pSource SDL_Surface*
+     * \param iOffsetX int - Source pixel at the top left corner of the rectangle, wrapped into the source.
+     * \param iOffsetY int
+     * \param pDest SDL_Surface*
+     * \param pDstRect SDL_Rect* - Area to fill, on return the clipped area that was drawn.
+     * \param cAlpha Uint8 - Image alpha, scales the per-pixel alpha when below kOpaqueAlpha.
+     * \param pSpans const CSpanSprite* - Spans of the source or nullptr.
+     * \param bPremultiplied bool - The source has premultiplied alpha.
+     * \param nTint Uint32 - Tint of a premultiplied source.
+     * \return bool - false if nothing was drawn (the formats or the blend are not supported).
+     *
+     */
+    bool CAlphaBlitter::WrapBlit( SDL_Surface* pSource, int iOffsetX, int iOffsetY, SDL_Surface* pDest, SDL_Rect* pDstRect, Uint8 cAlpha,
+                                  const CSpanSprite* pSpans, bool bPremultiplied, Uint32 nTint )
+    {
+        int iMode = GetMode( pSource, pDest, bPremultiplied );
+        bool bCopy = false;
+        if ( iMode == MODE_NONE ) {
+            // Blit leaves opaque copies to SDL, here they are the rows copied as they are
+            if ( !m_bEnabled || ( pSource->flags & ( SDL_SRCALPHA | SDL_SRCCOLORKEY ) ) || !SameLayout( pSource, pDest ) )
+                return( false );
+            bCopy = true;
+        }
+
+        int dstx = pDstRect->x;
+        int dsty = pDstRect->y;
+        int w = pDstRect->w;
+        int h = pDstRect->h;
+        const SDL_Rect& clip = pDest->clip_rect;
+        int dx = clip.x - dstx;
+        if ( dx > 0 ) {
+            w -= dx;
+            dstx += dx;
+            iOffsetX += dx;
+        }
+        dx = dstx + w - clip.x - clip.w;
+        if ( dx > 0 ) w -= dx;
+        int dy = clip.y - dsty;
+        if ( dy > 0 ) {
+            h -= dy;
+            dsty += dy;
+            iOffsetY += dy;
+        }
+        dy = dsty + h - clip.y - clip.h;
+        if ( dy > 0 ) h -= dy;
+
+        pDstRect->x = (Sint16)dstx;
+        pDstRect->y = (Sint16)dsty;
+        if ( w <= 0 || h <= 0 || pSource->w <= 0 || pSource->h <= 0 ) {
+            pDstRect->w = pDstRect->h = 0;
+            return( true );
+        }
+        pDstRect->w = (Uint16)w;
+        pDstRect->h = (Uint16)h;
+        int sx0 = iOffsetX % pSource->w;
+        int sy = iOffsetY % pSource->h;
+        if ( sx0 < 0 ) sx0 += pSource->w;
+        if ( sy < 0 ) sy += pSource->h;
+
+        Uint32 nParam = 0;
+        Row_t row = nullptr;
+        bool bSpans = false;
+        if ( !bCopy ) {
+            row = GetRow( iMode, pSource, cAlpha, nTint, nParam );
+            bSpans = ( m_bSpans && pSpans && iMode != MODE_SURFACEALPHA && pSpans->Matches( pSource ) );
+        }
+        bool bCopyOpaque = ( bSpans && CanCopyOpaque( iMode, nParam ) );
+
+        bool bLock = SDL_MUSTLOCK( pDest );
+        if ( bLock && SDL_LockSurface( pDest ) < 0 ) return( true );
+        Uint8* pDstRow = (Uint8*)pDest->pixels + dsty * pDest->pitch + dstx * 4;
+        for ( int y = 0; y < h; ++y, pDstRow += pDest->pitch ) {
+            Uint32* pDst = (Uint32*)pDstRow;
+            const Uint32* pSrc = (const Uint32*)( (const Uint8*)pSource->pixels + sy * pSource->pitch );
+            int sx = sx0;
+            for ( int x = 0; x < w; ) {
+                int n = std::min( pSource->w - sx, w - x );
+                if ( bCopy )
+                    memcpy( pDst + x, pSrc + sx, n * sizeof( Uint32 ) );
+                else if ( bSpans )
+                    SpanRow( pSpans, sy, sx, sx + n, pDst + x - sx, row, nParam, bCopyOpaque );
+                else
+                    row( pSrc + sx, pDst + x, n, nParam );
+                x += n;
+                sx = 0;
+            }
+            if ( ++sy == pSource->h ) sy = 0;
+        }
+        if ( bLock ) SDL_UnlockSurface( pDest );
+        if ( !bCopy ) ++m_nBlits[iMode];
+        ++m_nWrapBlits;
+        return( true );
+    }
+
+    /** \brief Draws the spans inside the source rectangle
+     *
+     * Opaque spans are copied when allowed, everything else is blended with the same row
+     * as the blit without spans, so the result is the same (only the unused top byte of
+     * the screen pixels may differ).
+     *
+     * \param pSpans const CSpanSprite*
+     * \param src const SDL_Rect& - Clipped source rectangle.
+     * \param pDest SDL_Surface*
+     * \param dst const SDL_Rect& - Position of the clipped rectangle.
+     * \param blend Row_t - Row function of the blit.
+     * \param nParam Uint32 - Parameter of the row function.
+     * \param bCopyOpaque bool - Opaque spans can be copied (no image alpha or tint).
+     * \return void
+     *
+     */
+    void CAlphaBlitter::SpanBlit( const CSpanSprite* pSpans, const SDL_Rect& src, SDL_Surface* pDest, const SDL_Rect& dst,
+                                  Row_t blend, Uint32 nParam, bool bCopyOpaque ) const
+    {
+        Uint8* pDstRow = (Uint8*)pDest->pixels + dst.y * pDest->pitch;
+        for ( int y = src.y; y < src.y + src.h; ++y, pDstRow += pDest->pitch )
+            SpanRow( pSpans, y, src.x, src.x + src.w, (Uint32*)pDstRow + dst.x - src.x, blend, nParam, bCopyOpaque );
+    }
+
+    /** \brief Draws the spans of a source row between iLeft and iRight
+     *
+     * \param pSpans const CSpanSprite*
+     * \param y int - Source row, in the surface the spans match (see CSpanSprite::Rebase).
+     * \param iLeft int - First source column.
+     * \param iRight int - Source column after the last one.
+     * \param pDst Uint32* - Destination of source column zero.
+     * \param blend Row_t - Row function of the blit.
+     * \param nParam Uint32 - Parameter of the row function.
+     * \param bCopyOpaque bool - Opaque spans can be copied (no image alpha or tint).
+     * \return void
+     *
+     */
+    void CAlphaBlitter::SpanRow( const CSpanSprite* pSpans, int y, int iLeft, int iRight, Uint32* pDst,
+                                 Row_t blend, Uint32 nParam, bool bCopyOpaque ) const
+    {
+        y -= pSpans->GetY();
+        iLeft -= pSpans->GetX();
+        iRight -= pSpans->GetX();
+        pDst += pSpans->GetX();
+        Uint32 nEnd = pSpans->GetRowBegin( y + 1 );
+        for ( Uint32 n = pSpans->GetRowBegin( y ); n < nEnd; ++n ) {
+            const CSpanSprite::Span_t& span = pSpans->GetSpan( n );
+            if ( span.x >= iRight ) break;
+            int x0 = std::max( (int)span.x, iLeft );
+            int x1 = std::min( span.x + span.w, iRight );
+            if ( x0 >= x1 ) continue;
+            const Uint32* pSrc = pSpans->GetPixels( span.nOffset + ( x0 - span.x ) );
+            if ( span.iType == CSpanSprite::SPAN_OPAQUE && bCopyOpaque )
+                memcpy( pDst + x0, pSrc, ( x1 - x0 ) * sizeof( Uint32 ) );
+            else
+                blend( pSrc, pDst + x0, x1 - x0, nParam );
+        }
+    }
+
+    /** \brief Converts a 32-bit surface with the alpha in the top byte to premultiplied alpha
+     *
+     * Every color channel is multiplied by the alpha (rounded), fully transparent pixels become zero.
+     *
+     * \param pSurface SDL_Surface*
+     * \return void
+     *
+     */
+    void CAlphaBlitter::Premultiply( SDL_Surface* pSurface )
+    {
+        if ( pSurface->format->BytesPerPixel != 4 || pSurface->format->Amask != 0xff000000 ) return;
+        if ( SDL_MUSTLOCK( pSurface ) && SDL_LockSurface( pSurface ) < 0 ) return;
+        Uint8* pRow = (Uint8*)pSurface->pixels;
+        for ( int y = 0; y < pSurface->h; ++y, pRow += pSurface->pitch ) {
+            Uint32* p = (Uint32*)pRow;
+            for ( int x = 0; x < pSurface->w; ++x ) {
+                Uint32 alpha = p[x] >> 24;
+                if ( alpha == 255 ) continue;
+                Uint32 c = p[x] & 0xff000000;
+                for ( int shift = 0; shift < 24; shift += 8 )
+                    c |= Multiply255( ( p[x] >> shift ) & 0xff, alpha ) << shift;
+                p[x] = c;
+            }
+        }
+        if ( SDL_MUSTLOCK( pSurface ) ) SDL_UnlockSurface( pSurface );
+    }
+
+    /** \brief Converts a premultiplied 32-bit surface with the alpha in the top byte back to straight alpha
+     *
+     * Every color channel is divided by the alpha (rounded), fully transparent pixels become zero.
+     *
+     * \param pSurface SDL_Surface*
+     * \return void
+     *
+     */
+    void CAlphaBlitter::Unpremultiply( SDL_Surface* pSurface )
+    {
+        if ( pSurface->format->BytesPerPixel != 4 || pSurface->format->Amask != 0xff000000 ) return;
+        if ( SDL_MUSTLOCK( pSurface ) && SDL_LockSurface( pSurface ) < 0 ) return;
+        Uint8* pRow = (Uint8*)pSurface->pixels;
+        for ( int y = 0; y < pSurface->h; ++y, pRow += pSurface->pitch ) {
+            Uint32* p = (Uint32*)pRow;
+            for ( int x = 0; x < pSurface->w; ++x ) {
+                Uint32 alpha = p[x] >> 24;
+                if ( alpha == 255 ) continue;
+                if ( alpha == 0 ) {
+                    p[x] = 0;
+                    continue;
+                }
+                Uint32 c = p[x] & 0xff000000;
+                for ( int shift = 0; shift < 24; shift += 8 ) {
+                    Uint32 value = ( ( ( p[x] >> shift ) & 0xff ) * 255 + alpha / 2 ) / alpha;
+                    c |= ( value > 255 ? 255 : value ) << shift;
+                }
+                p[x] = c;
+            }
+        }
+        if ( SDL_MUSTLOCK( pSurface ) ) SDL_UnlockSurface( pSurface );
+    }
+
+}
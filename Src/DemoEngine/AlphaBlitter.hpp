@@ -0,0 +1,131 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef ALPHABLITTER_HPP
+#define ALPHABLITTER_HPP
+
+#include <iostream>
+#include <SDL.h>
+#include "Singleton.hpp"
+#include "SpanSprite.hpp"
+
+namespace DemoEngine {
+
+    using std::cout;
+    using std::endl;
+
+    /// Blitter for 32-bit sources to a 32-bit screen with the same RGB layout (XRGB, XBGR).
+    /// Handles the blends SDL 1.2 does with its generic per-pixel loops: per-pixel alpha,
+    /// per-pixel alpha scaled by the image alpha, per-surface alpha and colorkey.
+    /// The blend math is the same as in SDL's C blitters, the SSE2 rows are selected at
+    /// runtime and give the same result as the plain rows.
+    ///
+    /// Other formats (and opaque copies) return false and are left to SDL_BlitSurface.
+    /// When the image has a CSpanSprite only its spans are visited: transparent pixels are
+    /// skipped, opaque runs are copied and only the translucent runs are blended.
+    ///
+    /// Premultiplied alpha sources (see CImageAlpha) can't be drawn by SDL, so they are
+    /// always drawn here, even when the blitter is disabled. Their blend is d * (256 - a) / 256 + s
+    /// and the image alpha (fade) and tint scale the source channels before it.
+    class CAlphaBlitter
+    {
+        friend class CSingleton<CAlphaBlitter>;
+
+        public:
+            typedef enum {
+                MODE_NONE = 0,      // Not handled, use SDL
+                MODE_PIXELALPHA,    // Per-pixel alpha (scaled by the image alpha when it is below kOpaqueAlpha)
+                MODE_SURFACEALPHA,  // Per-surface alpha
+                MODE_COLORKEY,      // Colorkey copy
+                MODE_PREMULTIPLIED, // Per-pixel premultiplied alpha, faded by the image alpha and tinted
+                MODE_COUNT
+            } MODE;
+
+            CAlphaBlitter();
+            virtual ~CAlphaBlitter() {};
+
+            int GetMode( SDL_Surface* pSource, SDL_Surface* pDest, bool bPremultiplied = false ) const;
+            bool Blit( SDL_Surface* pSource, const SDL_Rect* pSrcRect, SDL_Surface* pDest, SDL_Rect* pDstRect, Uint8 cAlpha,
+                       const CSpanSprite* pSpans = nullptr, bool bPremultiplied = false, Uint32 nTint = kNoTint );
+            bool LowerBlit( SDL_Surface* pSource, const SDL_Rect& src, SDL_Surface* pDest, const SDL_Rect& dst, Uint8 cAlpha,
+                            const CSpanSprite* pSpans = nullptr, bool bPremultiplied = false, Uint32 nTint = kNoTint );
+            bool WrapBlit( SDL_Surface* pSource, int iOffsetX, int iOffsetY, SDL_Surface* pDest, SDL_Rect* pDstRect, Uint8 cAlpha,
+                           const CSpanSprite* pSpans = nullptr, bool bPremultiplied = false, Uint32 nTint = kNoTint );
+            static void Premultiply( SDL_Surface* pSurface );
+            static void Unpremultiply( SDL_Surface* pSurface );
+
+            inline void SetEnabled( bool bEnabled ) { m_bEnabled = bEnabled; }
+            inline bool IsEnabled() const { return m_bEnabled; }
+            inline void SetSSE2( bool bSSE2 ) { m_bSSE2 = bSSE2 && m_bHasSSE2; }
+            inline bool IsSSE2() const { return m_bSSE2; }
+            inline void SetSpans( bool bSpans ) { m_bSpans = bSpans; }
+            inline bool IsSpans() const { return m_bSpans; }
+            // Alpha images are premultiplied when converted to the display format (if the format allows it)
+            inline void SetPremultiplied( bool bPremultiplied ) { m_bPremultiplied = bPremultiplied; }
+            inline bool IsPremultiplied() const { return m_bPremultiplied; }
+            inline unsigned int GetBlits( int iMode ) const { return m_nBlits[iMode]; }
+            inline unsigned int GetSpanBlits() const { return m_nSpanBlits; }
+            inline unsigned int GetWrapBlits() const { return m_nWrapBlits; }
+
+            void Print() const
+            {
+                cout << "Alpha blitter (" << ( m_bSSE2 ? "SSE2" : "C" ) << "): "
+                     << m_nBlits[MODE_PIXELALPHA] << " per-pixel alpha, "
+                     << m_nBlits[MODE_SURFACEALPHA] << " surface alpha, "
+                     << m_nBlits[MODE_COLORKEY] << " colorkey, "
+                     << m_nBlits[MODE_PREMULTIPLIED] << " premultiplied, "
+                     << m_nSpanBlits << " of them with spans, "
+                     << m_nWrapBlits << " wrapped" << endl;
+            }
+
+            // Image alpha at or above this blends with the per-pixel alpha only (as SDL does)
+            const Uint8 kOpaqueAlpha = 254;
+            // Tint (RGB in the surface channel order) that leaves the colors as they are
+            static const Uint32 kNoTint = 0xffffff;
+
+        protected:
+        private:
+            typedef void (*Row_t)( const Uint32*, Uint32*, int, Uint32 );
+
+            Row_t GetRow( int iMode, SDL_Surface* pSource, Uint8 cAlpha, Uint32 nTint, Uint32& nParam ) const;
+            static bool CanCopyOpaque( int iMode, Uint32 nParam );
+            void SpanBlit( const CSpanSprite* pSpans, const SDL_Rect& src, SDL_Surface* pDest, const SDL_Rect& dst,
+                           Row_t blend, Uint32 nParam, bool bCopyOpaque ) const;
+            void SpanRow( const CSpanSprite* pSpans, int y, int iLeft, int iRight, Uint32* pDst,
+                          Row_t blend, Uint32 nParam, bool bCopyOpaque ) const;
+
+            bool m_bEnabled = true;
+            bool m_bSpans = true;
+            bool m_bPremultiplied = true;
+            bool m_bHasSSE2 = false;
+            bool m_bSSE2 = false;
+            unsigned int m_nBlits[MODE_COUNT] = { 0, 0, 0, 0, 0 };
+            unsigned int m_nSpanBlits = 0;
+            unsigned int m_nWrapBlits = 0;
+    };
+
+}
+
+#endif // ALPHABLITTER_HPP
@@ -0,0 +1,335 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef BULLETPATTERN_HPP
+#define BULLETPATTERN_HPP
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <SDL.h>
+#include "Math.hpp"
+
+namespace DemoEngine
+{
+    using std::vector;
+
+    /// Data description of a bullet pattern.
+    /// Angles are in degrees, 0 points down the screen and 180 points up.
+    class CBulletPattern
+    {
+        public:
+            CBulletPattern() : vSubEmitters() {};
+            ~CBulletPattern() {};
+
+            int nCount = 1;                 // bullets per shot
+            float fSpread = 0.0f;           // angle between the first and the last bullet
+            float fSpacing = 0.0f;          // sideways distance between bullets in pixels
+            float fAngle = 0.0f;            // facing of the emitter
+            float fRotationSpeed = 0.0f;    // added to the direction on every shot
+            float fSpeed = 100.0f;          // projectile speed in pixels per second
+            float fOffsetX = 0.0f;          // emitter offset from the origin
+            float fOffsetY = 0.0f;
+            int nEvery = 1;                 // fire only on every n:th shot
+            int iJitter = 0;                // random direction variation in degrees (total width)
+            bool bAimed = false;            // aim at the target instead of fAngle
+            bool bForwardOnly = false;      // never fire backwards from fAngle
+            int nProjectile = 0;            // resource id of the projectile image
+            int nDamage = 1;
+
+            vector<CBulletPattern> vSubEmitters;   // fired together with this emitter
+    };
+
+    /// Flat instruction list compiled from a CBulletPattern and the interpreter that runs it.
+    class CBulletPatternProgram
+    {
+        public:
+            /// Projectile to be spawned
+            typedef struct {
+                float x;
+                float y;
+                float vx;
+                float vy;
+                Uint32 nOwner;
+                int nProjectile;
+                int nDamage;
+            } Spawn_t;
+
+            /// Target for aimed instructions (position and velocity are used for leading)
+            typedef struct {
+                float x;
+                float y;
+                float vx;
+                float vy;
+                float fMinX;    // predicted x outside of [fMinX,fMaxX] falls back to the current position
+                float fMaxX;
+            } Target_t;
+
+            /// Position and owner of an emitter (see the batch Execute)
+            typedef struct {
+                float x;
+                float y;
+                Uint32 nOwner;
+            } Origin_t;
+
+            CBulletPatternProgram() : m_vInstructions() {};
+            ~CBulletPatternProgram() {};
+
+            /** \brief Compiles pattern and its sub-emitters to a flat instruction list.
+             *
+             * \param pattern const CBulletPattern& - Pattern description.
+             * \return void
+             *
+             */
+            void Compile( const CBulletPattern& pattern )
+            {
+                m_vInstructions.clear();
+                m_bAimed = false;
+                Emit( pattern, 0.0f, 0.0f, 0.0f, 0.0f, 1 );
+            }
+
+            inline size_t Size() const { return m_vInstructions.size(); }
+            inline bool Empty() const { return m_vInstructions.empty(); }
+            // Whether any instruction needs a target
+            inline bool IsAimed() const { return m_bAimed; }
+
+            /** \brief Runs the program once and appends the spawned projectiles to vSpawns.
+             *
+             * \param x float - Origin of the pattern.
+             * \param y float - Origin of the pattern.
+             * \param nShot Uint32 - Running shot counter (used by rotation and nEvery).
+             * \param pTarget const Target_t* - Target for aimed instructions, aimed instructions are skipped if nullptr.
+             * \param nOwner Uint32 - Owner id stored to the spawns.
+             * \param vSpawns vector<Spawn_t>& - Spawn list to append to.
+             * \return size_t - Number of spawns added.
+             *
+             */
+            size_t Execute( float x, float y, Uint32 nShot, const Target_t* pTarget, Uint32 nOwner, vector<Spawn_t>& vSpawns ) const
+            {
+                Origin_t origin = { x, y, nOwner };
+                return Run( &origin, 1, nShot, pTarget, vSpawns );
+            }
+
+            /** \brief Runs the program once for every origin in one batch.
+             *
+             * The values of an instruction that don't depend on the origin are computed once
+             * for the whole batch.
+             *
+             * \param vOrigins const vector<Origin_t>& - Origins of the emitters firing this shot.
+             * \param nShot Uint32 - Running shot counter (used by rotation and nEvery).
+             * \param pTarget const Target_t* - Target for aimed instructions, aimed instructions are skipped if nullptr.
+             * \param vSpawns vector<Spawn_t>& - Spawn list to append to.
+             * \return size_t - Number of spawns added.
+             *
+             */
+            size_t Execute( const vector<Origin_t>& vOrigins, Uint32 nShot, const Target_t* pTarget, vector<Spawn_t>& vSpawns ) const
+            {
+                return ( vOrigins.empty() ? 0 : Run( &vOrigins[0], vOrigins.size(), nShot, pTarget, vSpawns ) );
+            }
+
+        protected:
+        private:
+            typedef struct {
+                float fOffsetX;
+                float fOffsetY;
+                float fFaceX;       // facing of the emitter
+                float fFaceY;
+                float fDirX;        // direction relative to the center direction
+                float fDirY;
+                float fSpeed;
+                int iRotation;      // degrees per shot
+                int iJitter;
+                int nEvery;
+                int nProjectile;
+                int nDamage;
+                bool bAimed;
+                bool bForwardOnly;
+            } Instruction_t;
+
+            void Emit( const CBulletPattern& pattern, float fOffsetX, float fOffsetY, float fAngle, float fRotation, int nEvery )
+            {
+                fOffsetX += pattern.fOffsetX;
+                fOffsetY += pattern.fOffsetY;
+                fAngle += pattern.fAngle;
+                fRotation += pattern.fRotationSpeed;
+                nEvery = Lcm( nEvery, pattern.nEvery > 0 ? pattern.nEvery : 1 );
+
+                float fRadians = fAngle * Math::kPI / 180;
+                float fFaceX = sin( fRadians );
+                float fFaceY = cos( fRadians );
+
+                for ( int i = 0; i < pattern.nCount; ++i ) {
+                    float t = pattern.nCount > 1 ? (float)i / (float)(pattern.nCount-1) - 0.5f : 0.0f;
+                    float fSide = ( (float)i - (float)(pattern.nCount-1) / 2 ) * pattern.fSpacing;
+                    float fRelative = t * pattern.fSpread * Math::kPI / 180;
+
+                    Instruction_t ins;
+                    // Bullets are spaced perpendicular to the facing
+                    ins.fOffsetX = fOffsetX + fFaceY * fSide;
+                    ins.fOffsetY = fOffsetY - fFaceX * fSide;
+                    ins.fFaceX = fFaceX;
+                    ins.fFaceY = fFaceY;
+                    ins.fDirX = sin( fRelative );
+                    ins.fDirY = cos( fRelative );
+                    ins.fSpeed = pattern.fSpeed;
+                    ins.iRotation = static_cast<int>( fRotation );
+                    ins.iJitter = pattern.iJitter;
+                    ins.nEvery = nEvery;
+                    ins.nProjectile = pattern.nProjectile;
+                    ins.nDamage = pattern.nDamage;
+                    ins.bAimed = pattern.bAimed;
+                    m_bAimed = m_bAimed || pattern.bAimed;
+                    ins.bForwardOnly = pattern.bForwardOnly;
+                    m_vInstructions.push_back( ins );
+                }
+
+                for ( auto& sub : pattern.vSubEmitters ) {
+                    Emit( sub, fOffsetX, fOffsetY, fAngle, fRotation, nEvery );
+                }
+            }
+
+            // Interpreter loop, instructions outside and origins inside
+            size_t Run( const Origin_t* pOrigins, size_t nOrigins, Uint32 nShot, const Target_t* pTarget, vector<Spawn_t>& vSpawns ) const
+            {
+                size_t nSpawned = 0;
+                for ( auto& ins : m_vInstructions ) {
+
+                    if ( nShot % ins.nEvery != 0 ) continue;
+                    if ( ins.bAimed && pTarget == nullptr ) continue;
+
+                    // Unaimed instructions without jitter fire the same velocity from every origin
+                    int iRotation = ins.iRotation * static_cast<int>( nShot % 360 );
+                    bool bFixed = ( !ins.bAimed && ins.iJitter <= 0 );
+                    Spawn_t spawn;
+                    spawn.nProjectile = ins.nProjectile;
+                    spawn.nDamage = ins.nDamage;
+                    if ( bFixed ) {
+                        GetVelocity( ins, ins.fFaceX, ins.fFaceY, iRotation, spawn.vx, spawn.vy );
+                    }
+
+                    for ( size_t n = 0; n < nOrigins; ++n ) {
+
+                        spawn.x = pOrigins[n].x + ins.fOffsetX;
+                        spawn.y = pOrigins[n].y + ins.fOffsetY;
+                        spawn.nOwner = pOrigins[n].nOwner;
+
+                        if ( !bFixed ) {
+                            // Center direction of the emitter
+                            float cx = ins.fFaceX;
+                            float cy = ins.fFaceY;
+                            if ( ins.bAimed ) {
+                                // Lead the target by the time it takes the projectile to reach it
+                                float dx = pTarget->x - spawn.x;
+                                float dy = pTarget->y - spawn.y;
+                                float fFlyTime = sqrt( dx*dx + dy*dy ) / ins.fSpeed;
+                                float tx = pTarget->x + pTarget->vx * fFlyTime;
+                                float ty = pTarget->y + pTarget->vy * fFlyTime;
+                                if ( tx < pTarget->fMinX || tx > pTarget->fMaxX ) {
+                                    tx = pTarget->x;
+                                    ty = pTarget->y;
+                                }
+                                dx = tx - spawn.x;
+                                dy = ty - spawn.y;
+                                float fLength = sqrt( dx*dx + dy*dy );
+                                if ( fLength > 0.0f ) {
+                                    cx = dx / fLength;
+                                    cy = dy / fLength;
+                                }
+                            }
+
+                            // Random variation
+                            int iDegrees = iRotation;
+                            if ( ins.iJitter > 0 ) {
+                                iDegrees += -ins.iJitter/2 + rand()%ins.iJitter;
+                            }
+                            GetVelocity( ins, cx, cy, iDegrees, spawn.vx, spawn.vy );
+                        }
+
+                        vSpawns.push_back( spawn );
+                        nSpawned++;
+                    }
+                }
+                return nSpawned;
+            }
+
+            // Velocity of an instruction fired towards the center direction ( cx, cy ), rotated by iDegrees
+            static void GetVelocity( const Instruction_t& ins, float cx, float cy, int iDegrees, float& fVelocityX, float& fVelocityY )
+            {
+                // Spread offset relative to the center direction
+                float vx = cx * ins.fDirY + cy * ins.fDirX;
+                float vy = cy * ins.fDirY - cx * ins.fDirX;
+
+                if ( iDegrees != 0 ) {
+                    Rotate( vx, vy, iDegrees );
+                }
+
+                if ( ins.bForwardOnly && ( vx * ins.fFaceX + vy * ins.fFaceY ) < 0.0f ) {
+                    vx = ins.fFaceX;
+                    vy = ins.fFaceY;
+                }
+
+                fVelocityX = vx * ins.fSpeed;
+                fVelocityY = vy * ins.fSpeed;
+            }
+
+            // Rotates unit vector by whole degrees using precalculated tables
+            static void Rotate( float& vx, float& vy, int iDegrees )
+            {
+                static const vector<float> vSin = BuildSinTable( 0 );
+                static const vector<float> vCos = BuildSinTable( 90 );
+                int i = iDegrees % 360;
+                if ( i < 0 ) i += 360;
+                float x = vx * vCos[i] + vy * vSin[i];
+                float y = vy * vCos[i] - vx * vSin[i];
+                vx = x;
+                vy = y;
+            }
+
+            static vector<float> BuildSinTable( int iPhase )
+            {
+                vector<float> vTable( 360 );
+                for ( int i = 0; i < 360; ++i ) {
+                    vTable[i] = sin( (i + iPhase) * Math::kPI / 180 );
+                }
+                return vTable;
+            }
+
+            static int Lcm( int a, int b )
+            {
+                int x = a, y = b;
+                while ( y != 0 ) {
+                    int t = x % y;
+                    x = y;
+                    y = t;
+                }
+                return a / x * b;
+            }
+
+            vector<Instruction_t> m_vInstructions;
+            bool m_bAimed = false;
+    };
+}
+
+#endif // BULLETPATTERN_HPP
@@ -0,0 +1,186 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef DIRTYRECTANGLES_HPP
+#define DIRTYRECTANGLES_HPP
+
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+
+namespace DemoEngine
+{
+    using std::vector;
+    using std::min;
+    using std::max;
+
+    /// Collects screen regions touched during a frame and merges them into a
+    /// small set of rectangles that can be handed to SDL_UpdateRects.
+    class CDirtyRectangles
+    {
+        public:
+            CDirtyRectangles() : m_vRects() {};
+            ~CDirtyRectangles() {};
+
+            /** \brief Sets the area the rectangles are clipped to (usually the screen).
+             *
+             * \param w int
+             * \param h int
+             * \return void
+             *
+             */
+            void SetBounds( int w, int h )
+            {
+                m_iWidth = w;
+                m_iHeight = h;
+            }
+
+            /** \brief Adds a region, clipped to the bounds. Empty regions are ignored.
+             *
+             * \param x int
+             * \param y int
+             * \param w int
+             * \param h int
+             * \return void
+             *
+             */
+            void Add( int x, int y, int w, int h )
+            {
+                int x1 = max( x, 0 );
+                int y1 = max( y, 0 );
+                int x2 = min( x + w, m_iWidth );
+                int y2 = min( y + h, m_iHeight );
+                if ( x2 <= x1 || y2 <= y1 ) return;
+                SDL_Rect r = { (Sint16)x1, (Sint16)y1, (Uint16)(x2-x1), (Uint16)(y2-y1) };
+                m_vRects.push_back( r );
+            }
+
+            inline void Add( const SDL_Rect& r ) { Add( r.x, r.y, r.w, r.h ); }
+
+            inline void AddAll() { Clear(); Add( 0, 0, m_iWidth, m_iHeight ); }
+
+            /** \brief Appends all regions from another set.
+             *
+             * \param other const CDirtyRectangles&
+             * \return void
+             *
+             */
+            void Add( const CDirtyRectangles& other )
+            {
+                m_vRects.insert( m_vRects.end(), other.m_vRects.begin(), other.m_vRects.end() );
+            }
+
+            /** \brief Merges overlapping and nearby rectangles.
+             *
+             * Two rectangles are replaced by their bounding box when the box does not
+             * waste much more area than the two rectangles cover together.
+             * Repeats until no pair can be merged.
+             *
+             * \return void
+             *
+             */
+            void Merge()
+            {
+                bool bMerged = true;
+                while ( bMerged )
+                {
+                    bMerged = false;
+                    for ( size_t i = 0; i < m_vRects.size(); ++i )
+                    {
+                        for ( size_t j = i + 1; j < m_vRects.size(); )
+                        {
+                            SDL_Rect box;
+                            if ( ShouldMerge( m_vRects[i], m_vRects[j], box ) )
+                            {
+                                m_vRects[i] = box;
+                                m_vRects[j] = m_vRects.back();
+                                m_vRects.pop_back();
+                                bMerged = true;
+                            }
+                            else
+                            {
+                                ++j;
+                            }
+                        }
+                    }
+                }
+            }
+
+            /** \brief Returns the covered fraction of the bounds (0..1).
+             *
+             * Overlaps left after merging are counted twice, so this is an upper bound.
+             *
+             * \return float
+             *
+             */
+            float Coverage() const
+            {
+                if ( m_iWidth <= 0 || m_iHeight <= 0 ) return 0.0f;
+                long nArea = 0;
+                for ( auto& r : m_vRects )
+                    nArea += Area( r );
+                return min( 1.0f, nArea / (float)( (long)m_iWidth * m_iHeight ) );
+            }
+
+            inline void Clear() { m_vRects.clear(); }
+            inline size_t Count() const { return m_vRects.size(); }
+            inline bool IsEmpty() const { return m_vRects.empty(); }
+            inline vector<SDL_Rect>& Get() { return m_vRects; }
+            inline void Swap( CDirtyRectangles& other ) { m_vRects.swap( other.m_vRects ); }
+
+        protected:
+        private:
+            static inline long Area( const SDL_Rect& r ) { return (long)r.w * r.h; }
+
+            bool ShouldMerge( const SDL_Rect& a, const SDL_Rect& b, SDL_Rect& box ) const
+            {
+                int x1 = min( a.x, b.x );
+                int y1 = min( a.y, b.y );
+                int x2 = max( a.x + a.w, b.x + b.w );
+                int y2 = max( a.y + a.h, b.y + b.h );
+                long nBox = (long)( x2 - x1 ) * ( y2 - y1 );
+                // Area covered by the pair (intersection counted once)
+                int ix = min( a.x + a.w, b.x + b.w ) - max( a.x, b.x );
+                int iy = min( a.y + a.h, b.y + b.h ) - max( a.y, b.y );
+                long nOverlap = ( ix > 0 && iy > 0 ) ? (long)ix * iy : 0;
+                long nCovered = Area( a ) + Area( b ) - nOverlap;
+                if ( nBox - nCovered > nCovered / 4 + kMergeSlack ) return false;
+                box.x = (Sint16)x1;
+                box.y = (Sint16)y1;
+                box.w = (Uint16)( x2 - x1 );
+                box.h = (Uint16)( y2 - y1 );
+                return true;
+            }
+
+            // Extra pixels a merged box may waste regardless of the rectangle sizes
+            const long kMergeSlack = 1024;
+
+            vector<SDL_Rect> m_vRects;
+            int m_iWidth = 0;
+            int m_iHeight = 0;
+    };
+}
+
+#endif // DIRTYRECTANGLES_HPP
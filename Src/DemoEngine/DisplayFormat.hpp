@@ -0,0 +1,98 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef DISPLAYFORMAT_HPP
+#define DISPLAYFORMAT_HPP
+
+#include <iostream>
+#include <SDL.h>
+#include "Singleton.hpp"
+
+namespace DemoEngine {
+
+    using std::cout;
+    using std::endl;
+
+    /// Tracks the current video mode for surface conversion and collects conversion stats.
+    /// The generation is bumped every time the video mode is set, images compare it to
+    /// the generation they were converted for and convert themselves again when it differs.
+    class CDisplayFormat
+    {
+        friend class CSingleton<CDisplayFormat>;
+
+        public:
+            typedef enum {
+                OPAQUE = 0,         // SDL_DisplayFormat
+                COLORKEY,           // SDL_DisplayFormat, colorkey is mapped to the new format
+                ALPHA,              // SDL_DisplayFormatAlpha (per-pixel alpha)
+                COUNT
+            } CONVERSION;
+
+            CDisplayFormat() {};
+            virtual ~CDisplayFormat() {};
+
+            inline void ModeChanged() { ++m_nGeneration; }
+            inline Uint32 GetGeneration() const { return m_nGeneration; }
+
+            /** \brief Records a conversion
+             *
+             * \param type CONVERSION
+             * \param bSuccess bool - false if SDL could not convert the surface.
+             * \param nMilliseconds Uint32 - Time spent converting.
+             * \return void
+             *
+             */
+            void Record( CONVERSION type, bool bSuccess, Uint32 nMilliseconds )
+            {
+                if ( bSuccess ) ++m_nConverted[type];
+                else ++m_nFailed;
+                m_nMilliseconds += nMilliseconds;
+            }
+
+            inline unsigned int GetConverted( CONVERSION type ) const { return m_nConverted[type]; }
+            inline unsigned int GetFailed() const { return m_nFailed; }
+            inline Uint32 GetMilliseconds() const { return m_nMilliseconds; }
+
+            void Print() const
+            {
+                cout << "Display format conversions (mode " << m_nGeneration << "): "
+                     << m_nConverted[OPAQUE] << " opaque, "
+                     << m_nConverted[COLORKEY] << " colorkey, "
+                     << m_nConverted[ALPHA] << " alpha, "
+                     << m_nFailed << " failed, "
+                     << m_nMilliseconds << " ms" << endl;
+            }
+
+        protected:
+        private:
+            Uint32 m_nGeneration = 0;       // 0 = no video mode set yet
+            unsigned int m_nConverted[COUNT] = { 0, 0, 0 };
+            unsigned int m_nFailed = 0;
+            Uint32 m_nMilliseconds = 0;
+    };
+
+}
+
+#endif // DISPLAYFORMAT_HPP
@@ -0,0 +1,230 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include "FrameRecorder.hpp"
+
+namespace DemoEngine {
+
+    CFrameRecorder::CFrameRecorder() : m_sPath(), m_vSlots(), m_vSlotFrames(), m_vPlanes(), m_nCaptured( 0 ), m_nWritten( 0 ) {
+    }
+
+    CFrameRecorder::~CFrameRecorder() {
+        Stop();
+    }
+
+    /** \brief Maps a format name to FORMAT
+     *
+     * \param sFormat const string& - "y4m" or "bmp"
+     * \return int - FORMAT_BMP for unknown names.
+     *
+     */
+    int CFrameRecorder::ParseFormat( const string& sFormat ) {
+        string s( sFormat );
+        std::transform( s.begin(), s.end(), s.begin(), ::tolower );
+        return ( s == "y4m" ? FORMAT_Y4M : FORMAT_BMP );
+    }
+
+    /** \brief Allocates the ring and starts the writer thread
+     *
+     * \param sPath const string& - Directory for BMP sequences, file name for Y4M streams.
+     * \param iFormat int - FORMAT_BMP or FORMAT_Y4M
+     * \param pScreen const SDL_Surface* - Frames must have the size and format of this surface.
+     * \param nSlots size_t - Frames that can wait for the writer before frames are dropped.
+     * \param nFps Uint32 - Frame rate written to the Y4M header.
+     * \return void
+     *
+     * \throw runtime_error if the surfaces can't be allocated or the stream can't be opened
+     *
+     */
+    void CFrameRecorder::Start( const string& sPath, int iFormat, const SDL_Surface* pScreen, size_t nSlots, Uint32 nFps ) throw(runtime_error) {
+        Stop();
+        m_sPath = sPath;
+        m_iFormat = iFormat;
+        m_nWrite = m_nRead = 0;
+        m_nFrame = m_nDropped = m_nErrors = 0;
+        m_nCaptured = m_nWritten = 0;
+
+        const SDL_PixelFormat* format = pScreen->format;
+        for ( size_t i = 0; i < std::max( nSlots, (size_t)1 ); ++i ) {
+            SDL_Surface* pSlot = SDL_CreateRGBSurface( SDL_SWSURFACE, pScreen->w, pScreen->h, format->BitsPerPixel,
+                                                       format->Rmask, format->Gmask, format->Bmask, format->Amask );
+            if ( pSlot == nullptr ) {
+                Free();
+                throw runtime_error( string( SDL_GetError() ) );
+            }
+            if ( format->palette )
+                SDL_SetColors( pSlot, format->palette->colors, 0, format->palette->ncolors );
+            m_vSlots.push_back( pSlot );
+        }
+        m_vSlotFrames.assign( m_vSlots.size(), 0 );
+
+        if ( m_iFormat == FORMAT_Y4M ) {
+            m_vPlanes.resize( pScreen->w * pScreen->h * 3 );
+            m_pFile = fopen( m_sPath.c_str(), "wb" );
+            if ( m_pFile == nullptr ) {
+                Free();
+                throw runtime_error( "Can't open " + m_sPath + " for recording" );
+            }
+            fprintf( m_pFile, "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C444\n", pScreen->w, pScreen->h, (unsigned int)nFps );
+        }
+
+        m_pFree = SDL_CreateSemaphore( (Uint32)m_vSlots.size() );
+        m_pFilled = SDL_CreateSemaphore( 0 );
+        StartThread();
+    }
+
+    /** \brief Writes the frames still in the ring and stops the writer thread
+     *
+     * \return void
+     *
+     */
+    void CFrameRecorder::Stop() {
+        if ( IsThreadRunning() ) {
+            StopThread();
+            SDL_SemPost( m_pFilled );
+            WaitThread();
+        }
+        Free();
+    }
+
+    void CFrameRecorder::Free() {
+        for ( auto pSlot : m_vSlots )
+            SDL_FreeSurface( pSlot );
+        m_vSlots.clear();
+        if ( m_pFile != nullptr ) {
+            fclose( m_pFile );
+            m_pFile = nullptr;
+        }
+        if ( m_pFree != nullptr ) {
+            SDL_DestroySemaphore( m_pFree );
+            m_pFree = nullptr;
+        }
+        if ( m_pFilled != nullptr ) {
+            SDL_DestroySemaphore( m_pFilled );
+            m_pFilled = nullptr;
+        }
+    }
+
+    /** \brief Copies the screen into the ring
+     *
+     * Never waits for the writer, the frame is dropped if no slot is free.
+     * The screen must be locked by the caller if needed.
+     *
+     * \param pScreen SDL_Surface*
+     * \return bool - false if the frame was dropped.
+     *
+     */
+    bool CFrameRecorder::Capture( SDL_Surface* pScreen ) {
+        if ( !IsRecording() ) return false;
+        unsigned int nFrame = m_nFrame++;
+        SDL_Surface* pSlot = m_vSlots[m_nWrite];
+        if ( pSlot->w != pScreen->w || pSlot->h != pScreen->h || pSlot->format->BytesPerPixel != pScreen->format->BytesPerPixel ||
+             SDL_SemTryWait( m_pFree ) != 0 ) {
+            ++m_nDropped;
+            return false;
+        }
+        const size_t nRowBytes = pScreen->w * pScreen->format->BytesPerPixel;
+        if ( pSlot->pitch == pScreen->pitch )
+            memcpy( pSlot->pixels, pScreen->pixels, pScreen->pitch * pScreen->h );
+        else
+            for ( int y = 0; y < pScreen->h; ++y )
+                memcpy( (Uint8*)pSlot->pixels + y * pSlot->pitch, (const Uint8*)pScreen->pixels + y * pScreen->pitch, nRowBytes );
+        m_vSlotFrames[m_nWrite] = nFrame;
+        m_nWrite = ( m_nWrite + 1 ) % m_vSlots.size();
+        ++m_nCaptured;
+        SDL_SemPost( m_pFilled );
+        return true;
+    }
+
+    /** \brief Writer thread, one frame per post of m_pFilled
+     *
+     * Stop posts once more after the last frame, the thread quits when it gets
+     * a post with every captured frame written.
+     *
+     * \return int
+     *
+     */
+    int CFrameRecorder::Execute() {
+        while ( true ) {
+            SDL_SemWait( m_pFilled );
+            if ( m_nWritten == m_nCaptured ) break;
+            Write( m_vSlots[m_nRead], m_vSlotFrames[m_nRead] );
+            m_nRead = ( m_nRead + 1 ) % m_vSlots.size();
+            ++m_nWritten;
+            SDL_SemPost( m_pFree );
+        }
+        return( 0 );
+    }
+
+    void CFrameRecorder::Write( SDL_Surface* pFrame, unsigned int nFrame ) {
+        if ( m_iFormat == FORMAT_Y4M ) {
+            WriteY4M( pFrame );
+            return;
+        }
+        char szName[32];
+        snprintf( szName, sizeof(szName), "/frame_%05u.bmp", nFrame );
+        if ( SDL_SaveBMP( pFrame, ( m_sPath + szName ).c_str() ) != 0 )
+            ++m_nErrors;
+    }
+
+    /** \brief Converts the frame to YCbCr (BT.601, studio range) and appends it to the stream
+     */
+    void CFrameRecorder::WriteY4M( SDL_Surface* pFrame ) {
+        const size_t nPixels = pFrame->w * pFrame->h;
+        const int bpp = pFrame->format->BytesPerPixel;
+        Uint8* pY = m_vPlanes.data();
+        Uint8* pU = pY + nPixels;
+        Uint8* pV = pU + nPixels;
+        for ( int y = 0; y < pFrame->h; ++y ) {
+            const Uint8* p = (const Uint8*)pFrame->pixels + y * pFrame->pitch;
+            for ( int x = 0; x < pFrame->w; ++x, p += bpp ) {
+                Uint32 pixel;
+                switch ( bpp ) {
+                    case 1: pixel = *p; break;
+                    case 2: pixel = *(const Uint16*)p; break;
+                    case 3:
+                        #if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                        pixel = p[0] | ( p[1] << 8 ) | ( p[2] << 16 );
+                        #else
+                        pixel = ( p[0] << 16 ) | ( p[1] << 8 ) | p[2];
+                        #endif
+                        break;
+                    default: pixel = *(const Uint32*)p; break;
+                }
+                Uint8 r, g, b;
+                SDL_GetRGB( pixel, pFrame->format, &r, &g, &b );
+                *pY++ = ( ( 66 * r + 129 * g + 25 * b + 128 ) >> 8 ) + 16;
+                *pU++ = ( ( -38 * r - 74 * g + 112 * b + 128 ) >> 8 ) + 128;
+                *pV++ = ( ( 112 * r - 94 * g - 18 * b + 128 ) >> 8 ) + 128;
+            }
+        }
+        if ( fputs( "FRAME\n", m_pFile ) < 0 || fwrite( m_vPlanes.data(), 1, m_vPlanes.size(), m_pFile ) != m_vPlanes.size() )
+            ++m_nErrors;
+    }
+
+}
@@ -0,0 +1,98 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef FRAMERECORDER_HPP
+#define FRAMERECORDER_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <SDL.h>
+#include "Threaded.hpp"
+
+namespace DemoEngine {
+
+    using std::string;
+    using std::vector;
+    using std::runtime_error;
+
+    /// Records presented frames without stalling the game. Capture copies the screen into the next
+    /// free surface of a preallocated ring (one copy per frame) and a background thread writes the
+    /// filled surfaces out, either as a BMP sequence (a directory of frame_NNNNN.bmp) or as one raw
+    /// YUV4MPEG2 (4:4:4) stream. When the writer falls behind and the ring is full, frames are dropped.
+    class CFrameRecorder : public CThreaded
+    {
+        public:
+            enum FORMAT {
+                FORMAT_BMP = 0,
+                FORMAT_Y4M
+            };
+
+            CFrameRecorder();
+            virtual ~CFrameRecorder();
+
+            void Start( const string& sPath, int iFormat, const SDL_Surface* pScreen, size_t nSlots, Uint32 nFps ) throw(runtime_error);
+            void Stop();
+            inline bool IsRecording() const { return IsThreadRunning(); }
+            bool Capture( SDL_Surface* pScreen );
+            int Execute() override;
+
+            static int ParseFormat( const string& sFormat );
+
+            inline unsigned int GetCaptured() const { return m_nCaptured; }
+            inline unsigned int GetWritten() const { return m_nWritten; }
+            inline unsigned int GetDropped() const { return m_nDropped; }
+            inline unsigned int GetErrors() const { return m_nErrors; }
+
+            CFrameRecorder(const CFrameRecorder& other)=delete;
+            CFrameRecorder& operator=(const CFrameRecorder& other)=delete;
+        protected:
+        private:
+            void Write( SDL_Surface* pFrame, unsigned int nFrame );
+            void WriteY4M( SDL_Surface* pFrame );
+            void Free();
+
+            string m_sPath;
+            int m_iFormat = FORMAT_BMP;
+            FILE* m_pFile = nullptr;                // Y4M stream
+            vector<SDL_Surface*> m_vSlots;
+            vector<unsigned int> m_vSlotFrames;     // Frame number of each slot
+            vector<Uint8> m_vPlanes;                // Y, U and V planes of one frame (writer thread)
+            SDL_sem* m_pFree = nullptr;             // Slots the main thread can fill
+            SDL_sem* m_pFilled = nullptr;           // Slots waiting for the writer
+            size_t m_nWrite = 0;                    // Next slot to fill (main thread)
+            size_t m_nRead = 0;                     // Next slot to write (writer thread)
+            unsigned int m_nFrame = 0;              // Frames offered to Capture
+            std::atomic<unsigned int> m_nCaptured;
+            std::atomic<unsigned int> m_nWritten;
+            unsigned int m_nDropped = 0;
+            unsigned int m_nErrors = 0;             // Frames the writer failed to save
+    };
+
+}
+
+#endif // FRAMERECORDER_HPP
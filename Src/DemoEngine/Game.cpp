@@ -29,7 +29,7 @@ namespace DemoEngine {
 
     /** \brief Ctor initializes graphics and sound systems. Sets framerate to 60fps and sets keyboard repeat delays to zero.
      */
-    CGame::CGame() : m_Handlers(), m_fpsManager(), m_Timer(), m_mapNameToScene() {
+    CGame::CGame() : m_Handlers(), m_fpsManager(), m_Timer(), m_mapNameToScene(), m_sDumpPath(), m_sGoldenPath(), m_ImageDiff() {
         #ifdef DEBUGCTORS
         cout << "CGame ctor called!" << endl;
         #endif
@@ -52,8 +52,23 @@ namespace DemoEngine {
         properties->Property( "Game", "Speed" ) = (float)1.0f;
         properties->Property( "Game", "Music" ) = (bool)true;
 
+        // Headless runs render into memory without a display or audio device
+        m_bHeadless = (bool)properties->Property( "Video", "Headless", (bool)false );
+        m_nMaxFrames = (Uint32)properties->Property( "Game", "MaxFrames", (Uint32)0 );
+        m_nCaptureInterval = (Uint32)properties->Property( "Video", "CaptureInterval", (Uint32)1 );
+        if ( m_nCaptureInterval == 0 ) m_nCaptureInterval = 1;
+        m_sDumpPath = (string)properties->Property( "Video", "DumpPath", string("") );
+        m_sGoldenPath = (string)properties->Property( "Video", "GoldenPath", string("") );
+        m_ImageDiff.SetTolerance( (Uint8)(Uint32)properties->Property( "Video", "DiffTolerance", (Uint32)0 ) );
+        m_ImageDiff.SetMaxDifferingRatio( (float)properties->Property( "Video", "DiffRatio", (float)0.0f ) );
+        if ( m_bHeadless ) {
+            static char szAudioDriver[] = "SDL_AUDIODRIVER=dummy";
+            SDL_putenv( szAudioDriver );
+        }
+
         // Initialize Systems
         auto& renderer = CSingleton<CRenderer>::Instance();
+        renderer->SetHeadless( m_bHeadless );
         renderer->Init();
 
         auto& sound = CSingleton<CSoundServer>::Instance();
@@ -63,6 +78,12 @@ namespace DemoEngine {
         SDL_initFramerate( &m_fpsManager );
         SDL_setFramerate( &m_fpsManager, 60 );
 
+        // Headless frames advance the game clock by a fixed 1/60s and use a fixed random seed so runs are repeatable
+        if ( m_bHeadless ) {
+            CSingleton<CClock>::Instance()->SetFixedStep( 1000 / 60 );
+            CSingleton<CRandom>::Instance()->Seed( (Uint32)properties->Property( "Game", "Seed", (Uint32)0 ) );
+        }
+
         // Set key delay to zero
         SDL_EnableKeyRepeat( 0, 0 );
 
@@ -75,8 +96,24 @@ namespace DemoEngine {
         if ( fs )
             flag = SDL_FULLSCREEN;
 
+        // Width and Height are the internal resolution, the window is Scale times larger
+        renderer->SetScale( (Uint32)properties->Property("Video","Scale", (Uint32)1) );
         renderer->OpenWindow( w, h, b, SDL_HWSURFACE|SDL_DOUBLEBUF|flag );
         renderer->SetClearColor( 0, 0, 0 );
+        renderer->SetQueueEnabled( (bool)properties->Property("Video","RenderQueue", (bool)true) );
+        renderer->SetDirtyRectangleThreshold( (float)properties->Property("Video","DirtyRectangleCoverage", (float)0.5f) );
+        CSingleton<CAlphaBlitter>::Instance()->SetEnabled( (bool)properties->Property("Video","AlphaBlitter", (bool)true) );
+        CSingleton<CAlphaBlitter>::Instance()->SetSpans( (bool)properties->Property("Video","SpanSprites", (bool)true) );
+        CSingleton<CAlphaBlitter>::Instance()->SetPremultiplied( (bool)properties->Property("Video","PremultipliedAlpha", (bool)true) );
+        renderer->SetCompositorThreads( (Uint32)properties->Property("Video","CompositorThreads", (Uint32)0) );
+
+        // Record the presented frames (RecordPath is a directory for BMP sequences, a file for Y4M)
+        string sRecordPath = (string)properties->Property( "Video", "RecordPath", string("") );
+        if ( !sRecordPath.empty() )
+            renderer->StartRecording( sRecordPath, CFrameRecorder::ParseFormat( (string)properties->Property( "Video", "RecordFormat", string("bmp") ) ),
+                                      (Uint32)properties->Property( "Video", "RecordBuffer", (Uint32)8 ),
+                                      (Uint32)properties->Property( "Video", "RecordFps", (Uint32)60 ) );
+        m_nStartTicks = SDL_GetTicks();
     }
 
     /** \brief Gets the current scene listing (std::map)
@@ -264,10 +301,21 @@ namespace DemoEngine {
      */
     void CGame::HandleEvents()
     {
+        // Mouse coordinates are converted from the window to the internal resolution
+        int iScale = CSingleton<CRenderer>::Instance()->GetScale();
+
         // Poll events
         SDL_Event ev;
         while ( SDL_PollEvent( &ev ) )
         {
+            if ( iScale > 1 ) {
+                if ( ev.type == SDL_MOUSEMOTION ) {
+                    ev.motion.x /= iScale; ev.motion.y /= iScale;
+                    ev.motion.xrel /= iScale; ev.motion.yrel /= iScale;
+                } else if ( ev.type == SDL_MOUSEBUTTONDOWN || ev.type == SDL_MOUSEBUTTONUP ) {
+                    ev.button.x /= iScale; ev.button.y /= iScale;
+                }
+            }
             switch( ev.type )
             {
                 case SDL_KEYUP:
@@ -344,6 +392,7 @@ namespace DemoEngine {
             CSingleton<CPerformanceCounter>::Instance()->Get( PERFORMANCECOUNTERID::UPDATE ).SetStart();
             #endif
 
+            CSingleton<CClock>::Instance()->Step();
             m_Timer.SetSpeed( (float)CSingleton<CProperties>::Instance()->Property( "Game", "Speed" ) );
             m_Timer.Update();
             m_fLastFrameTime = m_Timer.GetPassedTimeReal();
@@ -362,17 +411,34 @@ namespace DemoEngine {
         }
 
         /// RENDER
+        unsigned int nDrawn = 0;
+        unsigned int nCulled = 0;
         {
             #ifdef DEBUG_PERFORMANCE
             CSingleton<CPerformanceCounter>::Instance()->Get( PERFORMANCECOUNTERID::RENDER ).SetStart();
             #endif
 
+            // Partial screen updates are used only when every running scene supports them
+            auto& renderer = CSingleton<CRenderer>::Instance();
+            bool bDirtyRectangles = (bool)CSingleton<CProperties>::Instance()->Property( "Video", "DirtyRectangles", (bool)true );
+            int nRunning = 0;
+            for( auto& scene : m_mapNameToScene ) {
+                if ( !scene.second->IsRunning() ) continue;
+                if ( !scene.second->UsesDirtyRectangles() ) bDirtyRectangles = false;
+                ++nRunning;
+            }
+            if ( nRunning == 0 ) bDirtyRectangles = false;
+            renderer->SetDirtyRectangles( bDirtyRectangles );
+
             PreRender();
             Render();
-            auto& renderer = CSingleton<CRenderer>::Instance();
             for( auto& scene : m_mapNameToScene ) {
                 if ( scene.second->IsRunning() ) scene.second->Render( );
-                if ( scene.second->IsRunning() ) scene.second->Render( renderer );
+                if ( scene.second->IsRunning() ) {
+                    scene.second->Render( renderer );
+                    nDrawn += scene.second->GetDrawnCount();
+                    nCulled += scene.second->GetCulledCount();
+                }
                 if ( scene.second->IsRunning() ) scene.second->PostRender( );
             }
             PostRender();
@@ -387,14 +453,85 @@ namespace DemoEngine {
         #ifdef DEBUG_PERFORMANCE
         CSingleton<CPerformanceCounter>::Instance()->EndFrame();
         float fps = ( CSingleton<CPerformanceCounter>::Instance()->GetFrameCount()/(float)(CSingleton<CPerformanceCounter>::Instance()->GetElapsedAsMilliseconds()) ) * 1000;
-        cout << "\rFPS: " << fps << "   ";
+        cout << "\rFPS: " << fps << ", drawn: " << nDrawn << ", culled: " << nCulled << "   ";
+        #else
+        DISCARD_UNUNSED_PARAMETER( nDrawn );
+        DISCARD_UNUNSED_PARAMETER( nCulled );
         #endif
 
-        SDL_framerateDelay( &m_fpsManager );
+        ++m_nFrame;
+        if ( !m_sDumpPath.empty() || !m_sGoldenPath.empty() )
+            if ( m_nFrame % m_nCaptureInterval == 0 ) CaptureFrame();
+
+        if ( m_nMaxFrames != 0 && m_nFrame >= m_nMaxFrames )
+            SetRunning( false );
+
+        // Headless runs are benchmarks, don't wait for the next frame
+        if ( !m_bHeadless )
+            SDL_framerateDelay( &m_fpsManager );
+        else if ( !bIsRunning() ) {
+            Uint32 nTicks = SDL_GetTicks() - m_nStartTicks;
+            cout << "Headless: " << m_nFrame << " frames in " << nTicks << " ms ("
+                 << ( m_nFrame ? nTicks / (float)m_nFrame : 0.0f ) << " ms/frame), "
+                 << m_nGoldenFailures << " golden image failures" << endl;
+        }
+
+        // Finish writing the recording before the game quits
+        auto& renderer = CSingleton<CRenderer>::Instance();
+        if ( !bIsRunning() && renderer->GetRecorder().IsRecording() ) {
+            renderer->StopRecording();
+            const CFrameRecorder& recorder = renderer->GetRecorder();
+            cout << "Recording: " << recorder.GetWritten() << " frames written, " << recorder.GetDropped() << " dropped, "
+                 << recorder.GetErrors() << " write errors" << endl;
+        }
+
+        #ifdef DEBUG
+        if ( !bIsRunning() ) CSingleton<CAlphaBlitter>::Instance()->Print();
+        #endif
 
         return ( bIsRunning() );
     }
 
+    /** \brief Dumps the current frame and compares it against the golden image with the same name
+     *
+     * Frames are named frame_NNNNN.bmp by the frame number. Missing golden images count as failures,
+     * a failed dump stops the dumping.
+     *
+     * \return void
+     *
+     */
+    void CGame::CaptureFrame()
+    {
+        auto& renderer = CSingleton<CRenderer>::Instance();
+        char szName[32];
+        snprintf( szName, sizeof(szName), "frame_%05u.bmp", (unsigned int)m_nFrame );
+
+        if ( !m_sDumpPath.empty() ) {
+            try {
+                renderer->DumpFrame( m_sDumpPath + "/" + szName );
+            }
+            catch ( runtime_error& ex ) {
+                // Don't try again for every frame
+                cout << "Dump: " << szName << " " << ex.what() << ", frames are no longer dumped" << endl;
+                m_sDumpPath.clear();
+            }
+        }
+
+        if ( !m_sGoldenPath.empty() ) {
+            try {
+                if ( !m_ImageDiff.Compare( renderer->GetScreen(), m_sGoldenPath + "/" + szName ) ) {
+                    ++m_nGoldenFailures;
+                    cout << "Golden: " << szName << " differs, " << m_ImageDiff.GetDifferingPixels() << "/" << m_ImageDiff.GetPixels()
+                         << " pixels, max delta " << (int)m_ImageDiff.GetMaxDelta() << ", mean error " << m_ImageDiff.GetMeanError() << endl;
+                }
+            }
+            catch ( runtime_error& ex ) {
+                ++m_nGoldenFailures;
+                cout << "Golden: " << szName << " " << ex.what() << endl;
+            }
+        }
+    }
+
     // Local handlers
 
     void CGame::Update( float fSeconds, float fRealSeconds )
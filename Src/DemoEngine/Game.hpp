@@ -41,6 +41,7 @@
 #include "CollisionDetector.hpp"
 #include "Properties.hpp"
 #include "Random.hpp"
+#include "ImageDiff.hpp"
 
 #ifdef DEBUG_PERFORMANCE
 #include "PerformanceCounter.hpp"
@@ -116,6 +117,10 @@ namespace DemoEngine {
             // Event management
             void SendCustomEvent( int nEventCode );
 
+            // Headless runs (frame dumps and golden image comparison)
+            inline Uint32 GetFrameCount() const { return m_nFrame; }
+            inline Uint32 GetGoldenFailures() const { return m_nGoldenFailures; }
+
             /// Hashtables to store event handler callbacks (i.e. labmda functions)
             // store State to lambda function mappings
             typedef map<STATE_t, std::function<void(SDL_Event&)>> StateAndFunction_t;
@@ -126,6 +131,8 @@ namespace DemoEngine {
             FPSmanager m_fpsManager;
 
         protected:
+            virtual void CaptureFrame();
+
         private:
             bool m_bInitialized = false;
             float m_fLastFrameTime = 0.0f;
@@ -134,6 +141,17 @@ namespace DemoEngine {
             bool m_bRunning = true;   // C++11 allows member variable initialization here
             CTimer m_Timer;
             mapNameToScene_t m_mapNameToScene;
+
+            // Headless runs
+            bool m_bHeadless = false;
+            Uint32 m_nFrame = 0;
+            Uint32 m_nMaxFrames = 0;            // Quit after this many frames (0 = run until quit)
+            Uint32 m_nCaptureInterval = 1;      // Dump and compare every Nth frame
+            Uint32 m_nStartTicks = 0;
+            Uint32 m_nGoldenFailures = 0;
+            string m_sDumpPath;
+            string m_sGoldenPath;
+            CImageDiff m_ImageDiff;
     };
 
 }
@@ -26,6 +26,7 @@
 #ifndef GAMEOBJECT_HPP
 #define GAMEOBJECT_HPP
 
+#include <vector>
 #include "Positional.hpp"
 #include "Accelerational.hpp"
 #include "IRenderable.hpp"
@@ -36,6 +37,8 @@
 
 namespace DemoEngine {
 
+    using std::vector;
+
     class CGameObjectFloat : public CPositional<float>, public CAccelerational<float>, public IRenderable, public IUpdateable
     {
         public:
@@ -48,8 +51,15 @@ namespace DemoEngine {
             inline CRectangle& GetBounds() { return m_Bounds; }
 
             inline Uint32 GetID() { return m_ObjectID; }
-            inline void SetDead( bool bDead ) { m_bDead = bDead; }
+            inline void SetDead( bool bDead ) {
+                if ( bDead && !m_bDead && m_pFreeList != nullptr ) m_pFreeList->push_back( m_ObjectID );
+                m_bDead = bDead;
+            }
+            // Pooled objects push their id to the free list of the pool when they die
+            inline void SetFreeList( vector<Uint32>* pFreeList ) { m_pFreeList = pFreeList; }
             inline bool IsDead() { return m_bDead; }
+            inline void SetSleeping( bool bSleeping ) { m_bSleeping = bSleeping; }
+            inline bool IsSleeping() { return m_bSleeping; }
 
             inline Uint32 GetMaxHealth() { return m_iMaxHealth; }
             inline void SetHealth( Uint32 health ) { m_iHealth = health; m_iMaxHealth = health; }
@@ -68,6 +78,9 @@ namespace DemoEngine {
             void SetOwner( int nOwner ) { m_nOwnerID = nOwner; }
             Uint32 GetOwner() { return m_nOwnerID; }
 
+            CGameObjectFloat(const CGameObjectFloat& other)=delete;             // The free list pointer must not be shared by copies.
+            CGameObjectFloat& operator=(const CGameObjectFloat& other)=delete;  // The free list pointer must not be shared by copies.
+
         protected:
         private:
             Uint32 m_nOwnerID = 0;
@@ -77,6 +90,8 @@ namespace DemoEngine {
             Uint32 m_iHealth = 1;
             Uint32 m_iMaxHealth = 1;
             bool m_bDead = false;
+            bool m_bSleeping = false;
+            vector<Uint32>* m_pFreeList = nullptr;
     };
 
     class CGameObjectInt : public CPositional<int>, public CAccelerational<float>, public IRenderable, public IUpdateable
@@ -91,8 +106,15 @@ namespace DemoEngine {
             inline CRectangle& GetBounds() { return m_Bounds; }
 
             inline Uint32 GetID() { return m_ObjectID; }
-            inline void SetDead( bool bDead ) { m_bDead = bDead; }
+            inline void SetDead( bool bDead ) {
+                if ( bDead && !m_bDead && m_pFreeList != nullptr ) m_pFreeList->push_back( m_ObjectID );
+                m_bDead = bDead;
+            }
+            // Pooled objects push their id to the free list of the pool when they die
+            inline void SetFreeList( vector<Uint32>* pFreeList ) { m_pFreeList = pFreeList; }
             inline bool IsDead() { return m_bDead; }
+            inline void SetSleeping( bool bSleeping ) { m_bSleeping = bSleeping; }
+            inline bool IsSleeping() { return m_bSleeping; }
 
             inline Uint32 GetMaxHealth() { return m_iMaxHealth; }
             inline void SetHealth( Uint32 health ) { m_iHealth = health; m_iMaxHealth = health; }
@@ -111,6 +133,9 @@ namespace DemoEngine {
             void SetOwner( int nOwner ) { m_nOwnerID = nOwner; }
             Uint32 GetOwner() { return m_nOwnerID; }
 
+            CGameObjectInt(const CGameObjectInt& other)=delete;             // The free list pointer must not be shared by copies.
+            CGameObjectInt& operator=(const CGameObjectInt& other)=delete;  // The free list pointer must not be shared by copies.
+
         protected:
         private:
             Uint32 m_nOwnerID = 0;
@@ -120,6 +145,8 @@ namespace DemoEngine {
             Uint32 m_iHealth = 1;
             Uint32 m_iMaxHealth = 1;
             bool m_bDead = false;
+            bool m_bSleeping = false;
+            vector<Uint32>* m_pFreeList = nullptr;
     };
 
 }
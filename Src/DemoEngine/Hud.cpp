@@ -0,0 +1,255 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include "Hud.hpp"
+#include <algorithm>
+
+namespace DemoEngine {
+
+    namespace {
+
+        inline bool Intersects( const SDL_Rect& a, const SDL_Rect& b )
+        {
+            return ( a.w > 0 && a.h > 0 && b.w > 0 && b.h > 0 &&
+                     a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h );
+        }
+
+        inline void Union( SDL_Rect& a, const SDL_Rect& b )
+        {
+            if ( b.w == 0 || b.h == 0 ) return;
+            if ( a.w == 0 || a.h == 0 ) {
+                a = b;
+                return;
+            }
+            int x1 = std::min( a.x, b.x );
+            int y1 = std::min( a.y, b.y );
+            int x2 = std::max( a.x + a.w, b.x + b.w );
+            int y2 = std::max( a.y + a.h, b.y + b.h );
+            a = { (Sint16)x1, (Sint16)y1, (Uint16)( x2 - x1 ), (Uint16)( y2 - y1 ) };
+        }
+
+        // Fills a screen rectangle of the HUD surface
+        inline void Fill( SDL_Surface* pTarget, int iOffsetX, int iOffsetY, int x, int y, int w, int h, Uint32 nColor )
+        {
+            if ( w <= 0 || h <= 0 ) return;
+            SDL_Rect rect = { (Sint16)( x - iOffsetX ), (Sint16)( y - iOffsetY ), (Uint16)w, (Uint16)h };
+            SDL_FillRect( pTarget, &rect, nColor );
+        }
+
+    }
+
+    CHudText::CHudText( unique_ptr<CFont>& font, Uint8 r, Uint8 g, Uint8 b, int x, int y, int iAlign ) :
+        m_Color(), m_sText(), m_Surface()
+    {
+        m_pFont = font->GetFontPointer();
+        m_Color = { r, g, b, 255 };
+        m_iX = x;
+        m_iY = y;
+        m_iAlign = iAlign;
+        m_Rect = { (Sint16)x, (Sint16)y, 0, 0 };
+    }
+
+    /** \brief Sets the text, the text surface is rendered again only if the text changes
+     *
+     * \param text const string&
+     * \return void
+     *
+     * \throw runtime_error if SDL_ttf fails to render the text
+     *
+     */
+    void CHudText::SetText( const string& text ) throw( runtime_error )
+    {
+        if ( text == m_sText && m_Surface.GetSurfacePointer() != nullptr ) return;
+        m_sText = text;
+        Invalidate();
+        if ( text.empty() ) {
+            m_Surface.Free();
+            m_Rect = { (Sint16)m_iX, (Sint16)m_iY, 0, 0 };
+            return;
+        }
+        SDL_Surface* pSurface = TTF_RenderText_Blended( m_pFont, text.c_str(), m_Color );
+        if ( pSurface == nullptr ) {
+            throw runtime_error( "CHudText::Cannot render text: " + string( TTF_GetError() ) );
+        }
+        // Copied into the HUD with the alpha channel, not blended
+        SDL_SetAlpha( pSurface, 0, 255 );
+        m_Surface.SetSurfacePointer( pSurface );
+        int x = m_iX;
+        if ( m_iAlign == ALIGN_RIGHT ) x -= pSurface->w;
+        else if ( m_iAlign == ALIGN_CENTER ) x -= pSurface->w / 2;
+        m_Rect = { (Sint16)x, (Sint16)m_iY, (Uint16)pSurface->w, (Uint16)pSurface->h };
+    }
+
+    void CHudText::Draw( SDL_Surface* pTarget, int iOffsetX, int iOffsetY )
+    {
+        SDL_Surface* pSurface = m_Surface.GetSurfacePointer();
+        if ( pSurface == nullptr ) return;
+        SDL_Rect dst = { (Sint16)( m_Rect.x - iOffsetX ), (Sint16)( m_Rect.y - iOffsetY ), 0, 0 };
+        SDL_BlitSurface( pSurface, NULL, pTarget, &dst );
+    }
+
+    CHudBar::CHudBar( int x, int y, int iHeight )
+    {
+        m_iX = x;
+        m_iY = y;
+        m_iHeight = iHeight;
+        m_Rect = { (Sint16)( x - 1 ), (Sint16)( y - 1 ), 2, (Uint16)( iHeight + 2 ) };
+    }
+
+    void CHudBar::SetColors( const SDL_Color& frame, const SDL_Color& filled, const SDL_Color& empty )
+    {
+        m_Frame = frame;
+        m_Filled = filled;
+        m_Empty = empty;
+        Invalidate();
+    }
+
+    void CHudBar::SetValue( int iValue, int iMax )
+    {
+        if ( iMax < 0 ) iMax = 0;
+        if ( iValue < 0 ) iValue = 0;
+        if ( iValue > iMax ) iValue = iMax;
+        if ( iValue == m_iValue && iMax == m_iMax ) return;
+        m_iValue = iValue;
+        m_iMax = iMax;
+        m_Rect.w = (Uint16)( iMax + 2 );
+        Invalidate();
+    }
+
+    void CHudBar::Draw( SDL_Surface* pTarget, int iOffsetX, int iOffsetY )
+    {
+        const SDL_PixelFormat* format = pTarget->format;
+        // The frame is filled whole, the inside is then overwritten
+        Fill( pTarget, iOffsetX, iOffsetY, m_Rect.x, m_Rect.y, m_Rect.w, m_Rect.h,
+              SDL_MapRGBA( format, m_Frame.r, m_Frame.g, m_Frame.b, m_Frame.unused ) );
+        Fill( pTarget, iOffsetX, iOffsetY, m_iX, m_iY, m_iValue, m_iHeight,
+              SDL_MapRGBA( format, m_Filled.r, m_Filled.g, m_Filled.b, m_Filled.unused ) );
+        Fill( pTarget, iOffsetX, iOffsetY, m_iX + m_iValue, m_iY, m_iMax - m_iValue, m_iHeight,
+              SDL_MapRGBA( format, m_Empty.r, m_Empty.g, m_Empty.b, m_Empty.unused ) );
+    }
+
+    void CHud::Add( const shared_ptr<CHudWidget>& pWidget )
+    {
+        m_vWidgets.push_back( pWidget );
+        m_bCreated = false;
+    }
+
+    void CHud::Clear()
+    {
+        m_vWidgets.clear();
+        m_bCreated = false;
+    }
+
+    /** \brief Draws every widget again on the next Render (e.g. after the video mode changed)
+     */
+    void CHud::Invalidate()
+    {
+        m_bCreated = false;
+    }
+
+    /** \brief Updates the HUD surface if any widget changed and draws it
+     *
+     * \param renderer unique_ptr<CRenderer>&
+     * \return void
+     *
+     */
+    void CHud::Render( unique_ptr<CRenderer>& renderer ) throw( runtime_error )
+    {
+        Composite();
+        if ( m_Area.w == 0 || m_Area.h == 0 ) return;
+        renderer->Render( m_pImage, m_Area.x, m_Area.y );
+    }
+
+    /** \brief Draws the changed widgets into the HUD surface
+     *
+     * The surface covers the bounding box of the widgets, it is created again (and all the
+     * widgets drawn) when the box grows. Otherwise only the old and new areas of the changed
+     * widgets are cleared, and the widgets touching them are drawn again.
+     *
+     * \return void
+     *
+     * \throw runtime_error if the surface can't be created
+     *
+     */
+    void CHud::Composite() throw( runtime_error )
+    {
+        bool bDirty = !m_bCreated;
+        SDL_Rect area = { 0, 0, 0, 0 };
+        for ( auto& widget : m_vWidgets ) {
+            Union( area, widget->GetRect() );
+            if ( widget->IsDirty() ) bDirty = true;
+        }
+        if ( !bDirty ) return;
+
+        bool bInside = m_bCreated && area.x >= m_Area.x && area.y >= m_Area.y &&
+                       area.x + area.w <= m_Area.x + m_Area.w && area.y + area.h <= m_Area.y + m_Area.h;
+        if ( !bInside ) {
+            m_Area = area;
+            m_bCreated = false;
+            if ( m_Area.w == 0 || m_Area.h == 0 ) return;
+            SDL_Surface* pScreen = SDL_GetVideoSurface();
+            bool bMasks = ( pScreen != nullptr && pScreen->format->BytesPerPixel == 4 );
+            SDL_Surface* pSurface = SDL_CreateRGBSurface( SDL_SWSURFACE, m_Area.w, m_Area.h, 32,
+                                                          bMasks ? pScreen->format->Rmask : 0x00ff0000,
+                                                          bMasks ? pScreen->format->Gmask : 0x0000ff00,
+                                                          bMasks ? pScreen->format->Bmask : 0x000000ff,
+                                                          0xff000000 );
+            if ( pSurface == nullptr ) {
+                throw runtime_error( "CHud::Cannot create surface: " + string( SDL_GetError() ) );
+            }
+            m_pImage->SetSurface( pSurface );
+            m_pImage->ConvertToDisplayFormat();
+        }
+
+        SDL_Surface* pTarget = m_pImage->GetSurface();
+        if ( !m_bCreated ) {
+            SDL_FillRect( pTarget, NULL, 0 );
+            for ( auto& widget : m_vWidgets ) {
+                widget->Draw( pTarget, m_Area.x, m_Area.y );
+                widget->SetDrawn();
+            }
+            m_bCreated = true;
+        } else {
+            // Clear the old and new areas of the changed widgets
+            SDL_Rect cleared = { 0, 0, 0, 0 };
+            for ( auto& widget : m_vWidgets ) {
+                if ( !widget->IsDirty() ) continue;
+                for ( const SDL_Rect* pRect : { &widget->GetDrawnRect(), &widget->GetRect() } ) {
+                    Fill( pTarget, m_Area.x, m_Area.y, pRect->x, pRect->y, pRect->w, pRect->h, 0 );
+                    Union( cleared, *pRect );
+                }
+            }
+            for ( auto& widget : m_vWidgets ) {
+                if ( widget->IsDirty() || Intersects( widget->GetRect(), cleared ) ) {
+                    widget->Draw( pTarget, m_Area.x, m_Area.y );
+                    widget->SetDrawn();
+                }
+            }
+        }
+        m_pImage->BuildSpans();
+        ++m_nComposites;
+    }
+
+}
@@ -0,0 +1,151 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef HUD_HPP
+#define HUD_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <SDL.h>
+#include "Font.hpp"
+#include "Surface.hpp"
+#include "ImageAlpha.hpp"
+#include "Renderer.hpp"
+
+namespace DemoEngine {
+
+    using std::string;
+    using std::vector;
+    using std::shared_ptr;
+    using std::unique_ptr;
+    using std::runtime_error;
+
+    /// Element of a CHud. A widget only changes (and gets drawn into the HUD surface again)
+    /// when its value changes. Widgets write their pixels including alpha, so the widgets
+    /// of one HUD should not overlap.
+    class CHudWidget
+    {
+        public:
+            CHudWidget() : m_Rect(), m_DrawnRect() {};
+            virtual ~CHudWidget() {};
+            // Draws the widget into the HUD surface, the surface is at iOffsetX,iOffsetY on the screen
+            virtual void Draw( SDL_Surface* pTarget, int iOffsetX, int iOffsetY ) = 0;
+            inline bool IsDirty() const { return m_bDirty; }
+            inline void Invalidate() { m_bDirty = true; }
+            inline void SetDrawn() { m_DrawnRect = m_Rect; m_bDirty = false; }
+            // Screen area of the widget now and when it was last drawn
+            inline const SDL_Rect& GetRect() const { return m_Rect; }
+            inline const SDL_Rect& GetDrawnRect() const { return m_DrawnRect; }
+        protected:
+            SDL_Rect m_Rect;
+            SDL_Rect m_DrawnRect;
+            bool m_bDirty = true;
+    };
+
+    /// Text rendered with SDL_ttf, the surface is created again only when the text changes
+    class CHudText : public CHudWidget
+    {
+        public:
+            typedef enum {
+                ALIGN_LEFT = 0,     // x is the left edge
+                ALIGN_RIGHT,        // x is the right edge
+                ALIGN_CENTER        // x is the center
+            } ALIGN;
+
+            CHudText( unique_ptr<CFont>& font, Uint8 r, Uint8 g, Uint8 b, int x, int y, int iAlign = ALIGN_LEFT );
+            void SetText( const string& text ) throw( runtime_error );
+            inline const string& GetText() const { return m_sText; }
+            void Draw( SDL_Surface* pTarget, int iOffsetX, int iOffsetY ) override;
+
+            CHudText(const CHudText& other)=delete;
+            CHudText& operator=(const CHudText& other)=delete;
+        protected:
+        private:
+            TTF_Font* m_pFont = nullptr;
+            SDL_Color m_Color;
+            int m_iX = 0;
+            int m_iY = 0;
+            int m_iAlign = ALIGN_LEFT;
+            string m_sText;
+            CSurface m_Surface;
+    };
+
+    /// Horizontal bar with a one pixel frame, the filled part on the left and the empty part on the right
+    class CHudBar : public CHudWidget
+    {
+        public:
+            CHudBar( int x, int y, int iHeight );
+            void SetColors( const SDL_Color& frame, const SDL_Color& filled, const SDL_Color& empty );
+            // Both in pixels, iMax is the inner width of the bar
+            void SetValue( int iValue, int iMax );
+            void Draw( SDL_Surface* pTarget, int iOffsetX, int iOffsetY ) override;
+        protected:
+        private:
+            int m_iX = 0;
+            int m_iY = 0;
+            int m_iHeight = 0;
+            int m_iValue = 0;
+            int m_iMax = 0;
+            SDL_Color m_Frame = { 255, 255, 255, 255 };
+            SDL_Color m_Filled = { 255, 255, 255, 255 };
+            SDL_Color m_Empty = { 0, 0, 0, 255 };
+    };
+
+    /// Retained HUD: the widgets are composited into one cached surface (sized to the
+    /// widgets) that is drawn with a single blit. The surface is only updated where
+    /// widgets have changed since the previous frame.
+    class CHud
+    {
+        public:
+            CHud() : m_vWidgets(), m_pImage( new CImageAlpha ), m_Area() {
+                // Widgets write straight alpha into the surface
+                m_pImage->SetPremultiply( false );
+            };
+            virtual ~CHud() {};
+
+            void Add( const shared_ptr<CHudWidget>& pWidget );
+            void Clear();
+            void Invalidate();
+            void Render( unique_ptr<CRenderer>& renderer ) throw( runtime_error );
+            inline unsigned int GetCompositeCount() const { return m_nComposites; }
+
+            CHud(const CHud& other)=delete;
+            CHud& operator=(const CHud& other)=delete;
+        protected:
+        private:
+            void Composite() throw( runtime_error );
+
+            vector<shared_ptr<CHudWidget>> m_vWidgets;
+            unique_ptr<CImageAlpha> m_pImage;
+            SDL_Rect m_Area;
+            bool m_bCreated = false;
+            unsigned int m_nComposites = 0;
+    };
+
+}
+
+#endif // HUD_HPP
@@ -27,6 +27,8 @@
 #define IRENDERABLE_HPP
 
 #include <memory>
+#include <SDL.h>
+#include "Macros.hpp"
 
 namespace DemoEngine {
 
@@ -40,6 +42,9 @@ namespace DemoEngine {
             virtual ~IRenderable() {};
             virtual void Render( unique_ptr<CRenderer>& r )=0;
             virtual void RenderDebug( unique_ptr<CRenderer>& r )=0;
+            // Screen area drawn by Render, CScene skips objects outside the screen. Returns false
+            // when not known (always drawn), an empty rect when nothing would be drawn.
+            virtual bool GetRenderBounds( SDL_Rect& rect ) { DISCARD_UNUNSED_PARAMETER( rect ); return false; }
         protected:
         private:
     };
@@ -25,6 +25,7 @@
 
 #include "Image.hpp"
 #include "UniqueID.hpp"
+#include "AlphaBlitter.hpp"
 
 #include <iostream>
 
@@ -39,6 +40,10 @@ namespace DemoEngine {
             m_pSurface = unique_ptr<CSurface>(new CSurface);
         }
         m_pSurface->SetSurfacePointer( pSurface );
+        m_pAtlasPage.reset();
+        m_pSpans.reset();
+        m_bPremultiplied = false;
+        m_nFormatGeneration = 0;
         /*
         if ( m_pSurface )
             SetBlittedArea( 0,0, m_pSurface->w, m_pSurface->h);
@@ -127,6 +132,110 @@ namespace DemoEngine {
         }
         SDL_SetAlpha(pSurface, 0, 0);
         m_pSurface->SetSurfacePointer( pSurface );
+        m_pAtlasPage.reset();
+        m_pSpans.reset();
+        m_bPremultiplied = false;
+        m_nFormatGeneration = 0;
+        // Convert right away if the video mode is already set
+        if ( CSingleton<CDisplayFormat>::Instance()->GetGeneration() != 0 )
+            ConvertToDisplayFormat();
+    }
+
+    /** \brief Converts the surface to the format of the screen so blits don't need to convert pixels
+     *
+     * Surfaces with per-pixel alpha are converted with SDL_DisplayFormatAlpha, others with
+     * SDL_DisplayFormat (which keeps the colorkey). The alpha flags of the original surface are kept.
+     * If SDL fails to convert the surface the original one is kept and used as is.
+     * An image in a sprite atlas gets its own surface again when converted.
+     * Per-pixel alpha images get their spans built from the converted surface.
+     *
+     * \return bool - true if the surface was converted.
+     *
+     */
+    bool CImage::ConvertToDisplayFormat()
+    {
+        auto& displayFormat = CSingleton<CDisplayFormat>::Instance();
+        SDL_Surface* pSurface = ( m_pSurface ? m_pSurface->GetSurfacePointer() : nullptr );
+        if ( pSurface == nullptr || SDL_GetVideoSurface() == NULL ) return false;
+
+        // Don't try again until the mode changes, even if this fails
+        m_nFormatGeneration = displayFormat->GetGeneration();
+
+        Uint32 nStart = SDL_GetTicks();
+        SDL_Surface* pConverted = nullptr;
+        CDisplayFormat::CONVERSION type;
+        if ( pSurface->format->Amask != 0 ) {
+            pConverted = SDL_DisplayFormatAlpha( pSurface );
+            type = CDisplayFormat::ALPHA;
+        } else {
+            pConverted = SDL_DisplayFormat( pSurface );
+            type = ( pSurface->flags & SDL_SRCCOLORKEY ) ? CDisplayFormat::COLORKEY : CDisplayFormat::OPAQUE;
+        }
+        displayFormat->Record( type, pConverted != nullptr, SDL_GetTicks() - nStart );
+        if ( pConverted == nullptr ) return false;
+
+        SDL_SetAlpha( pConverted, pSurface->flags & SDL_SRCALPHA, pSurface->format->alpha );
+        m_pSurface->SetSurfacePointer( pConverted );
+        m_pAtlasPage.reset();
+        m_pSpans.reset();
+        m_bPremultiplied = false;
+        if ( pConverted->format->Amask != 0 ) BuildSpans();
+        return true;
+    }
+
+    /** \brief Moves the image into a sprite atlas page
+     *
+     * The pixels must already be copied to the page. The renderer then blits the image
+     * from the shared page with the atlas rect as the source area, the spans are rebased
+     * onto that rect. The own surface of the image is freed, GetSurface returns a view of
+     * the rect in the page for the size and pixel access.
+     *
+     * \param pPage const shared_ptr<CSurface>& - Atlas page, kept alive by the image.
+     * \param rect const SDL_Rect& - Area of the image in the page.
+     * \return void
+     *
+     */
+    void CImage::SetAtlasPage( const shared_ptr<CSurface>& pPage, const SDL_Rect& rect )
+    {
+        m_pAtlasPage = pPage;
+        m_AtlasRect = rect;
+
+        SDL_Surface* pSurface = GetSurface();
+        SDL_Surface* pPageSurface = pPage->GetSurfacePointer();
+        const SDL_PixelFormat* format = pPageSurface->format;
+        Uint8* pPixels = (Uint8*)pPageSurface->pixels + rect.y * pPageSurface->pitch + rect.x * format->BytesPerPixel;
+        SDL_Surface* pView = SDL_CreateRGBSurfaceFrom( pPixels, rect.w, rect.h, format->BitsPerPixel, pPageSurface->pitch,
+                                                       format->Rmask, format->Gmask, format->Bmask, format->Amask );
+        if ( pView != NULL ) {
+            SDL_SetAlpha( pView, pSurface->flags & SDL_SRCALPHA, pSurface->format->alpha );
+            m_pSurface->SetSurfacePointer( pView );
+        }
+        if ( m_pSpans ) m_pSpans->Rebase( pPageSurface, rect.x, rect.y );
+    }
+
+    /** \brief Encodes the surface into run-length spans for CAlphaBlitter
+     *
+     * Only done when spans are enabled and the surface format is supported (32-bit with
+     * per-pixel alpha or colorkey), otherwise the image has no spans. The spans keep their own
+     * copy of the pixels and are rebased when the image is moved into a sprite atlas.
+     *
+     * \return void
+     *
+     */
+    void CImage::BuildSpans()
+    {
+        SDL_Surface* pSurface = ( m_pSurface ? m_pSurface->GetSurfacePointer() : nullptr );
+        if ( pSurface == nullptr || !CSingleton<CAlphaBlitter>::Instance()->IsSpans() ) {
+            m_pSpans.reset();
+            return;
+        }
+        if ( !m_pSpans ) m_pSpans = unique_ptr<CSpanSprite>( new CSpanSprite );
+        if ( !m_pSpans->Build( pSurface ) ) m_pSpans.reset();
+    }
+
+    SDL_Surface* CImage::GetAtlasPage() const
+    {
+        return ( m_pAtlasPage ? m_pAtlasPage->GetSurfacePointer() : nullptr );
     }
 
     /*
@@ -27,16 +27,20 @@
 #define IMAGE_HPP
 
 #include <stdexcept>
+#include <memory>
 #include <SDL.h>
 #include <SDL_image.h>
 #include <SDL_rotozoom.h>
 #include "Singleton.hpp"
 #include "Surface.hpp"
 #include "ResourceFactory.hpp"
+#include "DisplayFormat.hpp"
+#include "SpanSprite.hpp"
 
 namespace DemoEngine {
 
     using std::runtime_error;
+    using std::shared_ptr;
 
     class CImage
     {
@@ -47,6 +51,26 @@ namespace DemoEngine {
             virtual void Load( const char *szFileName ) throw( runtime_error );
             void SetSurface( SDL_Surface *pSurface );
             SDL_Surface* GetSurface() const;
+            virtual bool ConvertToDisplayFormat();
+            // Converts the surface again if the video mode has changed since the last conversion
+            inline void PrepareForDisplay() {
+                if ( m_nFormatGeneration != CSingleton<CDisplayFormat>::Instance()->GetGeneration() )
+                    ConvertToDisplayFormat();
+            }
+            // Sprite atlas (see CSpriteAtlas), the image is then drawn from its rect in the atlas page
+            void SetAtlasPage( const shared_ptr<CSurface>& pPage, const SDL_Rect& rect );
+            inline bool IsInAtlas() const { return ( m_pAtlasPage != nullptr ); }
+            SDL_Surface* GetAtlasPage() const;
+            inline const SDL_Rect& GetAtlasRect() const { return m_AtlasRect; }
+            // Stable id of the pixel storage (the atlas page when in an atlas), used to batch draws
+            inline unsigned int GetSurfaceID() const {
+                return ( m_pAtlasPage ? m_pAtlasPage->GetID() : ( m_pSurface ? m_pSurface->GetID() : 0 ) );
+            }
+            // Run-length spans of the converted surface (nullptr if not built), see CSpanSprite
+            void BuildSpans();
+            inline const CSpanSprite* GetSpans() const { return m_pSpans.get(); }
+            // The surface has premultiplied alpha and can only be drawn by CAlphaBlitter (see CImageAlpha)
+            inline bool IsPremultiplied() const { return m_bPremultiplied; }
             /*
             void SetBlittedArea( int x, int y, int width, int height );
             void SetBlittedArea( const SDL_Rect & rect );
@@ -60,6 +84,11 @@ namespace DemoEngine {
 
         protected:
             unique_ptr<CSurface> m_pSurface = nullptr;
+            Uint32 m_nFormatGeneration = 0;
+            shared_ptr<CSurface> m_pAtlasPage = nullptr;
+            SDL_Rect m_AtlasRect = { 0, 0, 0, 0 };
+            unique_ptr<CSpanSprite> m_pSpans = nullptr;
+            bool m_bPremultiplied = false;
 
         private:
             int m_iWidth = 0;
@@ -44,4 +44,43 @@ namespace DemoEngine {
         return ( m_cAlpha != 255 );
     }
 
+    void CImageAlpha::SetTint( Uint8 r, Uint8 g, Uint8 b ) {
+        m_Tint.r = r;
+        m_Tint.g = g;
+        m_Tint.b = b;
+    }
+
+    /** \brief Gets the tint in the channel order of the surface
+     *
+     * \return Uint32 - CAlphaBlitter::kNoTint if the surface is not 32-bit.
+     *
+     */
+    Uint32 CImageAlpha::GetTint() const {
+        SDL_Surface* pSurface = GetSurface();
+        if ( pSurface == nullptr || pSurface->format->BytesPerPixel != 4 ) return ( CAlphaBlitter::kNoTint );
+        const SDL_PixelFormat* format = pSurface->format;
+        return ( ( (Uint32)m_Tint.r << format->Rshift ) | ( (Uint32)m_Tint.g << format->Gshift ) | ( (Uint32)m_Tint.b << format->Bshift ) );
+    }
+
+    /** \brief Converts the surface to the screen format and premultiplies its alpha
+     *
+     * Only done when CAlphaBlitter can draw the converted surface to the screen, as SDL
+     * can't blend premultiplied pixels. The spans are built again from the premultiplied pixels.
+     *
+     * \return bool - true if the surface was converted.
+     *
+     */
+    bool CImageAlpha::ConvertToDisplayFormat() {
+        if ( !CImage::ConvertToDisplayFormat() ) return false;
+        auto& blitter = CSingleton<CAlphaBlitter>::Instance();
+        SDL_Surface* pSurface = GetSurface();
+        if ( m_bPremultiply && blitter->IsPremultiplied() &&
+             blitter->GetMode( pSurface, SDL_GetVideoSurface(), true ) == CAlphaBlitter::MODE_PREMULTIPLIED ) {
+            CAlphaBlitter::Premultiply( pSurface );
+            m_bPremultiplied = true;
+            BuildSpans();
+        }
+        return true;
+    }
+
 }
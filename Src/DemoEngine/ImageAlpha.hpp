@@ -29,6 +29,7 @@
 #include "Singleton.hpp"
 #include "ResourceFactory.hpp"
 #include "Image.hpp"
+#include "AlphaBlitter.hpp"
 
 namespace DemoEngine {
 
@@ -40,9 +41,17 @@ namespace DemoEngine {
             void SetAlpha( Uint8 alpha );
             bool bIsTransparent() const;
             Uint8 GetAlpha() const;
+            // Multiplies the colors, only drawn for premultiplied images
+            void SetTint( Uint8 r, Uint8 g, Uint8 b );
+            Uint32 GetTint() const;
+            // Premultiply the alpha when converted (if CAlphaBlitter::IsPremultiplied), set before loading
+            inline void SetPremultiply( bool bPremultiply ) { m_bPremultiply = bPremultiply; }
+            bool ConvertToDisplayFormat() override;
         protected:
         private:
             Uint8 m_cAlpha = 254;
+            SDL_Color m_Tint = { 255, 255, 255, 0 };
+            bool m_bPremultiply = true;
     };
 
     typedef CSingleton<CResourceFactory<int, CImageAlpha>> ImageAlphaFactory;
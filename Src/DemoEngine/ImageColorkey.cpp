@@ -42,6 +42,24 @@ namespace DemoEngine {
     {
         m_iColorKey = color;
         SDL_SetColorKey( GetSurface(), SDL_SRCCOLORKEY, m_iColorKey );
+        // Spans depend on the colorkey, build them once the surface is in the display format
+        if ( m_nFormatGeneration != 0 ) BuildSpans();
+    }
+
+    /** \brief Converts the surface to the screen format and maps the colorkey to the new format
+     *
+     * \return bool - true if the surface was converted.
+     *
+     */
+    bool CImageColorkey::ConvertToDisplayFormat()
+    {
+        SDL_Surface* pSurface = ( m_pSurface ? m_pSurface->GetSurfacePointer() : nullptr );
+        if ( pSurface == nullptr ) return false;
+        Uint8 r, g, b;
+        SDL_GetRGB( m_iColorKey, pSurface->format, &r, &g, &b );
+        if ( !CImage::ConvertToDisplayFormat() ) return false;
+        SetColorKeyRGB( r, g, b );
+        return true;
     }
 
     Uint32 CImageColorkey::GetColorkey() const
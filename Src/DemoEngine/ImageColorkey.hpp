@@ -40,6 +40,7 @@ namespace DemoEngine {
             void SetColorKey( Uint32 color );
             void SetColorKeyRGB( Uint8 r, Uint8 g, Uint8 b );
             Uint32 GetColorkey() const;
+            bool ConvertToDisplayFormat() override;
         protected:
         private:
             Uint32 m_iColorKey = 0;
@@ -0,0 +1,129 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include "ImageDiff.hpp"
+
+namespace DemoEngine {
+
+    /** \brief Compares two surfaces, the results are stored for the getters
+     *
+     * \param pActual SDL_Surface*
+     * \param pExpected SDL_Surface*
+     * \return bool - true if the surfaces match within the tolerances
+     *
+     * \throw runtime_error if the sizes differ or the surfaces can't be converted
+     *
+     */
+    bool CImageDiff::Compare( SDL_Surface* pActual, SDL_Surface* pExpected ) throw(runtime_error)
+    {
+        m_bMatch = false;
+        m_nPixels = m_nDiffering = 0;
+        m_cMaxDelta = 0;
+        m_fMeanError = 0.0f;
+
+        if ( pActual->w != pExpected->w || pActual->h != pExpected->h )
+            throw runtime_error( "CImageDiff::Compare -> Image sizes differ" );
+
+        SDL_Surface* pA = ToRGB( pActual );
+        SDL_Surface* pB = nullptr;
+        try {
+            pB = ToRGB( pExpected );
+        }
+        catch ( ... ) {
+            SDL_FreeSurface( pA );
+            throw;
+        }
+
+        Uint64 nError = 0;
+        for ( int y = 0; y < pA->h; ++y ) {
+            const Uint8* a = (const Uint8*)pA->pixels + y * pA->pitch;
+            const Uint8* b = (const Uint8*)pB->pixels + y * pB->pitch;
+            for ( int x = 0; x < pA->w; ++x, a += 3, b += 3 ) {
+                Uint8 cDelta = 0;
+                for ( int c = 0; c < 3; ++c ) {
+                    Uint8 d = ( a[c] > b[c] ? a[c] - b[c] : b[c] - a[c] );
+                    nError += d;
+                    if ( d > cDelta ) cDelta = d;
+                }
+                if ( cDelta > m_cTolerance ) ++m_nDiffering;
+                if ( cDelta > m_cMaxDelta ) m_cMaxDelta = cDelta;
+            }
+        }
+
+        m_nPixels = pA->w * pA->h;
+        if ( m_nPixels > 0 )
+            m_fMeanError = nError / ( 3.0f * m_nPixels );
+        m_bMatch = ( m_nDiffering <= m_fMaxDifferingRatio * m_nPixels );
+
+        SDL_FreeSurface( pA );
+        SDL_FreeSurface( pB );
+        return ( m_bMatch );
+    }
+
+    /** \brief Compares a surface against an image file
+     *
+     * \param pActual SDL_Surface*
+     * \param sFileName const string&
+     * \return bool - true if the surfaces match within the tolerances
+     *
+     * \throw runtime_error if the file can't be loaded or the sizes differ
+     *
+     */
+    bool CImageDiff::Compare( SDL_Surface* pActual, const string& sFileName ) throw(runtime_error)
+    {
+        SDL_Surface* pExpected = IMG_Load( sFileName.c_str() );
+        if ( !pExpected )
+            throw runtime_error( "CImageDiff::Compare -> Can't load " + sFileName + ": " + string( IMG_GetError() ) );
+        try {
+            Compare( pActual, pExpected );
+        }
+        catch ( ... ) {
+            SDL_FreeSurface( pExpected );
+            throw;
+        }
+        SDL_FreeSurface( pExpected );
+        return ( m_bMatch );
+    }
+
+    /** \brief Makes a 24-bit RGB software copy of the surface (alpha and colorkey are not applied)
+     *
+     * \param pSurface SDL_Surface*
+     * \return SDL_Surface* - owned by the caller
+     *
+     */
+    SDL_Surface* CImageDiff::ToRGB( SDL_Surface* pSurface ) const throw(runtime_error)
+    {
+        // Channel order doesn't matter as both images are converted the same way
+        SDL_Surface* pFormat = SDL_CreateRGBSurface( SDL_SWSURFACE, 1, 1, 24, 0xff0000, 0x00ff00, 0x0000ff, 0 );
+        if ( !pFormat )
+            throw runtime_error( "CImageDiff::ToRGB -> " + string( SDL_GetError() ) );
+        SDL_Surface* pConverted = SDL_ConvertSurface( pSurface, pFormat->format, SDL_SWSURFACE );
+        SDL_FreeSurface( pFormat );
+        if ( !pConverted )
+            throw runtime_error( "CImageDiff::ToRGB -> " + string( SDL_GetError() ) );
+        return ( pConverted );
+    }
+
+}
@@ -0,0 +1,80 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef IMAGEDIFF_HPP
+#define IMAGEDIFF_HPP
+
+#include <string>
+#include <stdexcept>
+#include <SDL.h>
+#include <SDL_image.h>
+
+namespace DemoEngine {
+
+    using std::string;
+    using std::runtime_error;
+
+    /// Pixel-by-pixel comparison of two surfaces (e.g. a rendered frame against a golden image).
+    /// Both surfaces are converted to 24-bit RGB before comparing so the formats don't need to match,
+    /// alpha is ignored. A pixel differs when any of its channels differs more than the tolerance and
+    /// the images match when the share of differing pixels is at most the allowed ratio.
+    class CImageDiff
+    {
+        public:
+            CImageDiff() {};
+            virtual ~CImageDiff() {};
+
+            inline void SetTolerance( Uint8 cTolerance ) { m_cTolerance = cTolerance; }
+            inline Uint8 GetTolerance() const { return m_cTolerance; }
+            inline void SetMaxDifferingRatio( float fRatio ) { m_fMaxDifferingRatio = fRatio; }
+            inline float GetMaxDifferingRatio() const { return m_fMaxDifferingRatio; }
+
+            bool Compare( SDL_Surface* pActual, SDL_Surface* pExpected ) throw(runtime_error);
+            bool Compare( SDL_Surface* pActual, const string& sFileName ) throw(runtime_error);
+
+            // Results of the last comparison
+            inline bool IsMatch() const { return m_bMatch; }
+            inline Uint32 GetPixels() const { return m_nPixels; }
+            inline Uint32 GetDifferingPixels() const { return m_nDiffering; }
+            inline Uint8 GetMaxDelta() const { return m_cMaxDelta; }
+            inline float GetMeanError() const { return m_fMeanError; }
+
+        protected:
+        private:
+            SDL_Surface* ToRGB( SDL_Surface* pSurface ) const throw(runtime_error);
+
+            Uint8 m_cTolerance = 0;
+            float m_fMaxDifferingRatio = 0.0f;
+
+            bool m_bMatch = false;
+            Uint32 m_nPixels = 0;
+            Uint32 m_nDiffering = 0;
+            Uint8 m_cMaxDelta = 0;
+            float m_fMeanError = 0.0f;     // Mean absolute difference per channel (0..255)
+    };
+
+}
+
+#endif // IMAGEDIFF_HPP
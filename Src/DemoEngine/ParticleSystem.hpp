@@ -102,7 +102,7 @@ namespace DemoEngine {
 
         public:
 
-            CParticleSystem() : m_lstParticles(), m_lstDeadParticles(), m_lstTrailParticles(), m_lstDeadTrailParticles(), m_ListGuardMutex()
+            CParticleSystem() : m_lstParticles(), m_lstDeadParticles(), m_lstTrailParticles(), m_lstDeadTrailParticles(), m_Batch(), m_ListGuardMutex()
             {
                 m_UID = CSingleton<CUniqueID>::Instance()->getID();
             }
@@ -384,154 +384,61 @@ namespace DemoEngine {
 
             virtual void Render( unique_ptr<CRenderer>& renderer ) override
             {
-                auto screen = renderer->GetScreen();
+                int iLayer = renderer->GetLayer();
+                renderer->SetLayer( LAYER_EFFECTS );
+
+                // Primitive particles are collected into one batch (drawn when the render queue is flushed)
+                m_Batch.Clear();
 
                 for( auto& p : m_lstTrailParticles )
                 {
                     if ( p->m_Color.unused > 0 )
-                    {
-                        float s = p->m_fSize;
-                        int x = p->m_vPos[0];
-                        int y = p->m_vPos[1];
-
-                        if ( m_nSpriteID != -1 ) {
-                            auto& sprite = ImageAlphaFactory::Instance()->Get( m_nSpriteID );
-                            renderer->Render( sprite, x, y );
-                        }
-                        else
-                        {
-                            int x1 = x-s/2;
-                            int y1 = y-s/2;
-                            int x2 = x+s/2;
-                            int y2 = y+s/2;
-                            switch ( m_nTrailPrimitiveType ) {
-                            default:
-                            case 0: // pixel
-                                pixelRGBA( screen,
-                                static_cast<int>(x),
-                                static_cast<int>(y),
-                                static_cast<int>(p->m_Color.r),
-                                static_cast<int>(p->m_Color.g),
-                                static_cast<int>(p->m_Color.b),
-                                static_cast<int>(p->m_Color.unused) );
-                                break;
-                            case 1: // line
-                                lineRGBA( screen,
-                                    static_cast<int>(x),
-                                    static_cast<int>(y),
-                                    static_cast<int>(p->m_vPosLast[0]),
-                                    static_cast<int>(p->m_vPosLast[1]),
-                                    static_cast<int>(p->m_Color.r),
-                                    static_cast<int>(p->m_Color.g),
-                                    static_cast<int>(p->m_Color.b),
-                                    static_cast<int>(p->m_Color.unused) );
-                                break;
-                            case 2: // box
-                                boxRGBA( screen,
-                                    static_cast<int>(x1),
-                                    static_cast<int>(y1),
-                                    static_cast<int>(x2),
-                                    static_cast<int>(y2),
-                                    static_cast<int>(p->m_Color.r),
-                                    static_cast<int>(p->m_Color.g),
-                                    static_cast<int>(p->m_Color.b),
-                                    static_cast<int>(p->m_Color.unused) );
-                                break;
-                            case 3: // star
-                                hlineRGBA( screen,
-                                    static_cast<int>(x1),
-                                    static_cast<int>(x2),
-                                    static_cast<int>(y),
-                                    static_cast<int>(p->m_Color.r),
-                                    static_cast<int>(p->m_Color.g),
-                                    static_cast<int>(p->m_Color.b),
-                                    static_cast<int>(p->m_Color.unused) );
-                                vlineRGBA( screen,
-                                    static_cast<int>(x),
-                                    static_cast<int>(y1),
-                                    static_cast<int>(y2),
-                                    static_cast<int>(p->m_Color.r),
-                                    static_cast<int>(p->m_Color.g),
-                                    static_cast<int>(p->m_Color.b),
-                                    static_cast<int>(p->m_Color.unused) );
-                                break;
-                            }
-                        }
-                    }
+                        RenderParticle( renderer, p, m_nTrailPrimitiveType );
                 }
 
                 for( auto& p : m_lstParticles )
                 {
                     if ( p->m_Color.unused > 0 )
-                    {
-                        float s = p->m_fSize;
-                        int x = p->m_vPos[0];
-                        int y = p->m_vPos[1];
-                        int x1 = x-s/2;
-                        int y1 = y-s/2;
-                        int x2 = x+s/2;
-                        int y2 = y+s/2;
-
-                        if ( m_nSpriteID != -1 ) {
-                            auto& sprite = ImageAlphaFactory::Instance()->Get( m_nSpriteID );
-                            renderer->Render( sprite, x, y );
-                        }
-                        else
-                        {
-                            switch ( m_nPrimitiveType ) {
-                            default:
-                            case 0: // pixel
-                                pixelRGBA( screen,
-                                static_cast<int>(x),
-                                static_cast<int>(y),
-                                static_cast<int>(p->m_Color.r),
-                                static_cast<int>(p->m_Color.g),
-                                static_cast<int>(p->m_Color.b),
-                                static_cast<int>(p->m_Color.unused) );
-                                break;
-                            case 1: // line
-                                lineRGBA( screen,
-                                    static_cast<int>(x),
-                                    static_cast<int>(y),
-                                    static_cast<int>(p->m_vPosLast[0]),
-                                    static_cast<int>(p->m_vPosLast[1]),
-                                    static_cast<int>(p->m_Color.r),
-                                    static_cast<int>(p->m_Color.g),
-                                    static_cast<int>(p->m_Color.b),
-                                    static_cast<int>(p->m_Color.unused) );
-                                break;
-                            case 2: // box
-                                boxRGBA( screen,
-                                    static_cast<int>(x1),
-                                    static_cast<int>(y1),
-                                    static_cast<int>(x2),
-                                    static_cast<int>(y2),
-                                    static_cast<int>(p->m_Color.r),
-                                    static_cast<int>(p->m_Color.g),
-                                    static_cast<int>(p->m_Color.b),
-                                    static_cast<int>(p->m_Color.unused) );
-                                break;
-                            case 3: // star
-                                hlineRGBA( screen,
-                                    static_cast<int>(x1),
-                                    static_cast<int>(x2),
-                                    static_cast<int>(y),
-                                    static_cast<int>(p->m_Color.r),
-                                    static_cast<int>(p->m_Color.g),
-                                    static_cast<int>(p->m_Color.b),
-                                    static_cast<int>(p->m_Color.unused) );
-                                vlineRGBA( screen,
-                                    static_cast<int>(x),
-                                    static_cast<int>(y1),
-                                    static_cast<int>(y2),
-                                    static_cast<int>(p->m_Color.r),
-                                    static_cast<int>(p->m_Color.g),
-                                    static_cast<int>(p->m_Color.b),
-                                    static_cast<int>(p->m_Color.unused) );
-                                break;
-                            }
-                        }
-                    }
+                        RenderParticle( renderer, p, m_nPrimitiveType );
+                }
+
+                renderer->RenderBatch( m_Batch );
+                renderer->SetLayer( iLayer );
+            }
+
+            void RenderParticle( unique_ptr<CRenderer>& renderer, shared_ptr<CParticle>& p, int nPrimitiveType )
+            {
+                float s = p->m_fSize;
+                int x = p->m_vPos[0];
+                int y = p->m_vPos[1];
+
+                if ( m_nSpriteID != -1 ) {
+                    auto& sprite = ImageAlphaFactory::Instance()->Get( m_nSpriteID );
+                    renderer->Render( sprite, x, y );
+                    return;
+                }
+
+                int x1 = x-s/2;
+                int y1 = y-s/2;
+                int x2 = x+s/2;
+                int y2 = y+s/2;
+                switch ( nPrimitiveType ) {
+                default:
+                case 0: // pixel
+                    m_Batch.AddPoint( x, y, p->m_Color );
+                    break;
+                case 1: // line
+                    m_Batch.AddLine( x, y,
+                        static_cast<int>(p->m_vPosLast[0]),
+                        static_cast<int>(p->m_vPosLast[1]), p->m_Color );
+                    break;
+                case 2: // box
+                    m_Batch.AddRect( x1, y1, x2, y2, p->m_Color );
+                    break;
+                case 3: // star
+                    m_Batch.AddLine( x1, y, x2, y, p->m_Color );
+                    m_Batch.AddLine( x, y1, x, y2, p->m_Color );
+                    break;
                 }
             }
 
@@ -707,6 +614,7 @@ namespace DemoEngine {
             List_t  m_lstTrailParticles;
             List_t  m_lstDeadTrailParticles;
             int     m_nTrailPrimitiveType = 0;       // 0=pixel, 1=line, 2=rectangle (supports size over time)
+            CPrimitiveBatch m_Batch;
         private:
             unsigned int m_UID = 0;
             bool bInitialized = false;
@@ -0,0 +1,280 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include <cstdlib>
+#include <SDL_gfxPrimitives.h>
+#include "PrimitiveBatch.hpp"
+
+namespace DemoEngine {
+
+    namespace {
+
+        /** \brief x / 255 rounded, for x up to 255 * 255
+         */
+        inline Uint32 Divide255( Uint32 x )
+        {
+            x += 128;
+            return ( ( x + ( x >> 8 ) ) >> 8 );
+        }
+
+        /// Color of a primitive mapped to the surface format once
+        typedef struct {
+            Uint32 nColor;          // RGBA the paint was made from
+            Uint32 nPixel;
+            Uint32 nAlpha;
+            Uint32 nInverse;        // 255 - alpha
+            Uint32 nKeep;           // Destination bits outside the color channels
+            Uint32 masks[3];
+            Uint8 shifts[3];
+            Uint32 channels[3];     // Color channels multiplied by the alpha
+        } Paint_t;
+
+        void SetPaint( Paint_t& paint, const SDL_PixelFormat* format, Uint32 nColor )
+        {
+            paint.nColor = nColor;
+            paint.nAlpha = nColor & 0xff;
+            paint.nInverse = 255 - paint.nAlpha;
+            paint.nPixel = SDL_MapRGB( format, nColor >> 24, ( nColor >> 16 ) & 0xff, ( nColor >> 8 ) & 0xff );
+            paint.masks[0] = format->Rmask;
+            paint.masks[1] = format->Gmask;
+            paint.masks[2] = format->Bmask;
+            paint.shifts[0] = format->Rshift;
+            paint.shifts[1] = format->Gshift;
+            paint.shifts[2] = format->Bshift;
+            paint.nKeep = ~( format->Rmask | format->Gmask | format->Bmask );
+            for ( int c = 0; c < 3; ++c )
+                paint.channels[c] = ( ( paint.nPixel & paint.masks[c] ) >> paint.shifts[c] ) * paint.nAlpha;
+        }
+
+        template<typename T>
+        inline void Plot( T* p, const Paint_t& paint )
+        {
+            if ( paint.nAlpha == 255 ) {
+                *p = (T)paint.nPixel;
+                return;
+            }
+            Uint32 d = *p;
+            Uint32 out = d & paint.nKeep;
+            for ( int c = 0; c < 3; ++c )
+                out |= Divide255( ( ( d & paint.masks[c] ) >> paint.shifts[c] ) * paint.nInverse + paint.channels[c] ) << paint.shifts[c];
+            *p = (T)out;
+        }
+
+        template<typename T>
+        inline void Span( T* p, int n, const Paint_t& paint )
+        {
+            if ( paint.nAlpha == 255 ) {
+                std::fill( p, p + n, (T)paint.nPixel );
+                return;
+            }
+            for ( int i = 0; i < n; ++i )
+                Plot( p + i, paint );
+        }
+
+        /// Clip rectangle of the surface with inclusive corners
+        typedef struct {
+            int x0;
+            int y0;
+            int x1;
+            int y1;
+        } Clip_t;
+
+        template<typename T>
+        inline T* Row( SDL_Surface* pSurface, int y )
+        {
+            return (T*)( (Uint8*)pSurface->pixels + y * pSurface->pitch );
+        }
+
+        template<typename T>
+        void HLine( SDL_Surface* pSurface, const Clip_t& clip, int x0, int x1, int y, const Paint_t& paint )
+        {
+            if ( y < clip.y0 || y > clip.y1 ) return;
+            if ( x0 < clip.x0 ) x0 = clip.x0;
+            if ( x1 > clip.x1 ) x1 = clip.x1;
+            if ( x0 > x1 ) return;
+            Span( Row<T>( pSurface, y ) + x0, x1 - x0 + 1, paint );
+        }
+
+        template<typename T>
+        void VLine( SDL_Surface* pSurface, const Clip_t& clip, int x, int y0, int y1, const Paint_t& paint )
+        {
+            if ( x < clip.x0 || x > clip.x1 ) return;
+            if ( y0 < clip.y0 ) y0 = clip.y0;
+            if ( y1 > clip.y1 ) y1 = clip.y1;
+            for ( int y = y0; y <= y1; ++y )
+                Plot( Row<T>( pSurface, y ) + x, paint );
+        }
+
+        // Bresenham, the per pixel clip test is skipped when the whole line is inside
+        template<typename T>
+        void Line( SDL_Surface* pSurface, const Clip_t& clip, int x0, int y0, int x1, int y1, const Paint_t& paint )
+        {
+            if ( y0 == y1 ) {
+                HLine<T>( pSurface, clip, std::min( x0, x1 ), std::max( x0, x1 ), y0, paint );
+                return;
+            }
+            if ( x0 == x1 ) {
+                VLine<T>( pSurface, clip, x0, std::min( y0, y1 ), std::max( y0, y1 ), paint );
+                return;
+            }
+            if ( std::max( x0, x1 ) < clip.x0 || std::min( x0, x1 ) > clip.x1 ||
+                 std::max( y0, y1 ) < clip.y0 || std::min( y0, y1 ) > clip.y1 ) return;
+            bool bInside = ( std::min( x0, x1 ) >= clip.x0 && std::max( x0, x1 ) <= clip.x1 &&
+                             std::min( y0, y1 ) >= clip.y0 && std::max( y0, y1 ) <= clip.y1 );
+            int dx = std::abs( x1 - x0 ), sx = ( x0 < x1 ? 1 : -1 );
+            int dy = -std::abs( y1 - y0 ), sy = ( y0 < y1 ? 1 : -1 );
+            int err = dx + dy;
+            for ( ;; ) {
+                if ( bInside || ( x0 >= clip.x0 && x0 <= clip.x1 && y0 >= clip.y0 && y0 <= clip.y1 ) )
+                    Plot( Row<T>( pSurface, y0 ) + x0, paint );
+                if ( x0 == x1 && y0 == y1 ) break;
+                int e2 = 2 * err;
+                if ( e2 >= dy ) { err += dy; x0 += sx; }
+                if ( e2 <= dx ) { err += dx; y0 += sy; }
+            }
+        }
+
+    }
+
+    void CPrimitiveBatch::AddPoints( const Point_t* pPoints, size_t nCount )
+    {
+        for ( size_t i = 0; i < nCount; ++i )
+            Add( POINT, pPoints[i].x, pPoints[i].y, pPoints[i].x, pPoints[i].y, pPoints[i].nColor );
+    }
+
+    void CPrimitiveBatch::AddLines( const Line_t* pLines, size_t nCount )
+    {
+        for ( size_t i = 0; i < nCount; ++i )
+            Add( LINE, pLines[i].x1, pLines[i].y1, pLines[i].x2, pLines[i].y2, pLines[i].nColor );
+    }
+
+    void CPrimitiveBatch::AddRects( const Line_t* pRects, size_t nCount, bool bFilled )
+    {
+        for ( size_t i = 0; i < nCount; ++i )
+            Add( bFilled ? BOX : RECTANGLE, pRects[i].x1, pRects[i].y1, pRects[i].x2, pRects[i].y2, pRects[i].nColor );
+    }
+
+    /** \brief Draws the batch
+     *
+     * The surface must be locked by the caller if needed. The alpha of the color is the opacity
+     * like with SDL_gfx, but the blend is rounded to nearest (Divide255), so a channel can
+     * differ by one from what SDL_gfx draws.
+     *
+     * \param pSurface SDL_Surface*
+     * \return void
+     *
+     */
+    void CPrimitiveBatch::Draw( SDL_Surface* pSurface ) const
+    {
+        if ( IsEmpty() ) return;
+        switch ( pSurface->format->palette == nullptr ? pSurface->format->BytesPerPixel : 1 ) {
+            case 2:
+                DrawPixels<Uint16>( pSurface );
+                break;
+            case 4:
+                DrawPixels<Uint32>( pSurface );
+                break;
+            default:
+                DrawGfx( pSurface );
+                break;
+        }
+    }
+
+    template<typename T>
+    void CPrimitiveBatch::DrawPixels( SDL_Surface* pSurface ) const
+    {
+        const SDL_Rect& rect = pSurface->clip_rect;
+        const Clip_t clip = { rect.x, rect.y, rect.x + rect.w - 1, rect.y + rect.h - 1 };
+        if ( clip.x0 > clip.x1 || clip.y0 > clip.y1 ) return;
+        if ( m_iMaxX < clip.x0 || m_iMinX > clip.x1 || m_iMaxY < clip.y0 || m_iMinY > clip.y1 ) return;
+
+        Paint_t paint;
+        SetPaint( paint, pSurface->format, 0 );
+
+        for ( auto& prim : m_vPrimitives ) {
+            if ( ( prim.nColor & 0xff ) == 0 ) continue;
+            int x0 = std::min( prim.x1, prim.x2 ), x1 = std::max( prim.x1, prim.x2 );
+            int y0 = std::min( prim.y1, prim.y2 ), y1 = std::max( prim.y1, prim.y2 );
+            switch ( prim.iType ) {
+                case POINT:
+                    if ( prim.x1 < clip.x0 || prim.x1 > clip.x1 || prim.y1 < clip.y0 || prim.y1 > clip.y1 ) continue;
+                    if ( prim.nColor != paint.nColor ) SetPaint( paint, pSurface->format, prim.nColor );
+                    Plot( Row<T>( pSurface, prim.y1 ) + prim.x1, paint );
+                    break;
+                case LINE:
+                    if ( prim.nColor != paint.nColor ) SetPaint( paint, pSurface->format, prim.nColor );
+                    Line<T>( pSurface, clip, prim.x1, prim.y1, prim.x2, prim.y2, paint );
+                    break;
+                case BOX:
+                    x0 = std::max( x0, clip.x0 );
+                    x1 = std::min( x1, clip.x1 );
+                    y0 = std::max( y0, clip.y0 );
+                    y1 = std::min( y1, clip.y1 );
+                    if ( x0 > x1 || y0 > y1 ) continue;
+                    if ( prim.nColor != paint.nColor ) SetPaint( paint, pSurface->format, prim.nColor );
+                    for ( int y = y0; y <= y1; ++y )
+                        Span( Row<T>( pSurface, y ) + x0, x1 - x0 + 1, paint );
+                    break;
+                case RECTANGLE:
+                    if ( prim.nColor != paint.nColor ) SetPaint( paint, pSurface->format, prim.nColor );
+                    HLine<T>( pSurface, clip, x0, x1, y0, paint );
+                    if ( y1 != y0 ) HLine<T>( pSurface, clip, x0, x1, y1, paint );
+                    if ( y1 - y0 > 1 ) {
+                        VLine<T>( pSurface, clip, x0, y0 + 1, y1 - 1, paint );
+                        if ( x1 != x0 ) VLine<T>( pSurface, clip, x1, y0 + 1, y1 - 1, paint );
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    /** \brief Draws the batch with SDL_gfx (palettized and 24-bit surfaces)
+     */
+    void CPrimitiveBatch::DrawGfx( SDL_Surface* pSurface ) const
+    {
+        for ( auto& prim : m_vPrimitives ) {
+            Uint8 r = prim.nColor >> 24, g = ( prim.nColor >> 16 ) & 0xff, b = ( prim.nColor >> 8 ) & 0xff, a = prim.nColor & 0xff;
+            switch ( prim.iType ) {
+                case POINT:
+                    pixelRGBA( pSurface, prim.x1, prim.y1, r, g, b, a );
+                    break;
+                case LINE:
+                    lineRGBA( pSurface, prim.x1, prim.y1, prim.x2, prim.y2, r, g, b, a );
+                    break;
+                case BOX:
+                    boxRGBA( pSurface, prim.x1, prim.y1, prim.x2, prim.y2, r, g, b, a );
+                    break;
+                case RECTANGLE:
+                    rectangleRGBA( pSurface, prim.x1, prim.y1, prim.x2, prim.y2, r, g, b, a );
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+}
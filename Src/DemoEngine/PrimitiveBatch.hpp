@@ -0,0 +1,139 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef PRIMITIVEBATCH_HPP
+#define PRIMITIVEBATCH_HPP
+
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+
+namespace DemoEngine {
+
+    using std::vector;
+
+    /// Points, lines and rectangles collected into arrays and drawn with a single lock of the
+    /// screen (see CRenderer::RenderBatch). Each primitive is clipped against the clip rectangle
+    /// once and 16-bit and 32-bit screens are filled in tight loops, other depths use SDL_gfx.
+    /// Primitives are drawn in the order they were added, so overlapping translucent ones
+    /// blend like they do without the batch.
+    class CPrimitiveBatch
+    {
+        public:
+            // Colors are RGBA packed like the render queue primitives (r << 24 | g << 16 | b << 8 | a)
+            typedef struct {
+                Sint16 x;
+                Sint16 y;
+                Uint32 nColor;
+            } Point_t;
+
+            typedef struct {
+                Sint16 x1;
+                Sint16 y1;
+                Sint16 x2;
+                Sint16 y2;
+                Uint32 nColor;
+            } Line_t;
+
+            typedef enum {
+                POINT = 0,
+                LINE,
+                BOX,                // Filled rectangle
+                RECTANGLE           // Outlined rectangle
+            } PRIMITIVE;
+
+            CPrimitiveBatch() : m_vPrimitives() {};
+            ~CPrimitiveBatch() {};
+
+            static inline Uint32 Pack( const SDL_Color& c ) {
+                return ( ( (Uint32)c.r << 24 ) | ( (Uint32)c.g << 16 ) | ( (Uint32)c.b << 8 ) | c.unused );
+            }
+
+            inline void AddPoint( int x, int y, const SDL_Color& c ) {
+                Add( POINT, x, y, x, y, Pack( c ) );
+            }
+            inline void AddLine( int x1, int y1, int x2, int y2, const SDL_Color& c ) {
+                Add( LINE, x1, y1, x2, y2, Pack( c ) );
+            }
+            // Corners are inclusive like with boxRGBA and rectangleRGBA
+            inline void AddRect( int x1, int y1, int x2, int y2, const SDL_Color& c, bool bFilled = true ) {
+                Add( bFilled ? BOX : RECTANGLE, x1, y1, x2, y2, Pack( c ) );
+            }
+
+            void AddPoints( const Point_t* pPoints, size_t nCount );
+            void AddLines( const Line_t* pLines, size_t nCount );
+            void AddRects( const Line_t* pRects, size_t nCount, bool bFilled = true );
+
+            void Draw( SDL_Surface* pSurface ) const;
+
+            inline bool IsEmpty() const { return m_vPrimitives.empty(); }
+            inline size_t Count() const { return m_vPrimitives.size(); }
+            inline void Clear() {
+                m_vPrimitives.clear();
+                m_iMinX = m_iMinY = 0x7fff;
+                m_iMaxX = m_iMaxY = -0x8000;
+            }
+
+            // Area covered by everything in the batch (inclusive)
+            inline int GetMinX() const { return m_iMinX; }
+            inline int GetMinY() const { return m_iMinY; }
+            inline int GetMaxX() const { return m_iMaxX; }
+            inline int GetMaxY() const { return m_iMaxY; }
+
+        protected:
+        private:
+            typedef struct {
+                Sint16 x1;          // A point only uses x1 and y1
+                Sint16 y1;
+                Sint16 x2;
+                Sint16 y2;
+                Uint32 nColor;
+                Uint32 iType;       // PRIMITIVE
+            } Primitive_t;
+
+            inline void Add( Uint32 iType, int x1, int y1, int x2, int y2, Uint32 nColor ) {
+                m_vPrimitives.push_back( { (Sint16)x1, (Sint16)y1, (Sint16)x2, (Sint16)y2, nColor, iType } );
+                Grow( x1, y1, x2, y2 );
+            }
+            inline void Grow( int x1, int y1, int x2, int y2 ) {
+                m_iMinX = std::min( m_iMinX, std::min( x1, x2 ) );
+                m_iMinY = std::min( m_iMinY, std::min( y1, y2 ) );
+                m_iMaxX = std::max( m_iMaxX, std::max( x1, x2 ) );
+                m_iMaxY = std::max( m_iMaxY, std::max( y1, y2 ) );
+            }
+
+            void DrawGfx( SDL_Surface* pSurface ) const;
+            template<typename T> void DrawPixels( SDL_Surface* pSurface ) const;
+
+            vector<Primitive_t> m_vPrimitives;     // In the order they were added
+            int m_iMinX = 0x7fff;
+            int m_iMinY = 0x7fff;
+            int m_iMaxX = -0x8000;
+            int m_iMaxY = -0x8000;
+    };
+
+}
+
+#endif // PRIMITIVEBATCH_HPP
@@ -53,6 +53,10 @@ namespace DemoEngine {
                     delete m_pGenerator;
                 m_pGenerator = nullptr;
             }
+            // Restarts the sequence from a seed, e.g. for repeatable headless runs
+            inline void Seed( unsigned int seed ) {
+                m_pGenerator->seed( seed );
+            }
             inline unsigned int nextNumber() {
                 static Distribution dist(0,RAND_MAX);
                 return dist(*m_pGenerator);
@@ -0,0 +1,131 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef RENDERQUEUE_HPP
+#define RENDERQUEUE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <SDL.h>
+
+namespace DemoEngine {
+
+    using std::vector;
+
+    class CSpanSprite;
+    class CPrimitiveBatch;
+
+    /// Draw layers, lower layers are drawn first when the queue is flushed
+    typedef enum {
+
+        LAYER_BACKGROUND = 0,
+        LAYER_SHADOWS,
+        LAYER_SPRITES,
+        LAYER_EFFECTS,
+        LAYER_OVERLAY
+
+    } RENDERLAYER;
+
+    /// Collects image draw commands and sorts them so that commands with the same
+    /// blend state and source surface end up next to each other.
+    /// The order is fully defined by the command data (and the order of submission for
+    /// identical commands), so the same frame always draws the same way.
+    class CRenderQueue
+    {
+        public:
+            typedef enum {
+                BLEND_NONE = 0,         // CImage, surface flags are used as they are
+                BLEND_COLORKEY,         // CImageColorkey, nState is the colorkey
+                BLEND_ALPHA,            // CImageAlpha, nState is the alpha
+                BLEND_PREMULTIPLIED,    // CImageAlpha with premultiplied alpha, nState is the alpha (top byte) and the tint
+                BLEND_PRIMITIVE         // SDL_gfx primitive, nSurfaceID is the PRIMITIVE and nState the RGBA color
+            } BLENDMODE;
+
+            typedef enum {
+                PRIMITIVE_PIXEL = 0,
+                PRIMITIVE_LINE,
+                PRIMITIVE_BOX,
+                PRIMITIVE_HLINE,
+                PRIMITIVE_VLINE,
+                PRIMITIVE_BATCH         // CPrimitiveBatch in pBatch, x/y and x2/y2 are its bounds
+            } PRIMITIVE;
+
+            typedef struct {
+                int iLayer;
+                int iBlend;
+                unsigned int nSurfaceID;    // Stable id of the source (or the atlas page), not the pointer
+                Uint32 nState;
+                Sint16 x;
+                Sint16 y;
+                Sint16 x2;                  // End point for primitives
+                Sint16 y2;
+                unsigned int nSequence;     // Order of submission
+                SDL_Surface* pSurface;
+                const CSpanSprite* pSpans;  // Run-length spans of the image or nullptr
+                const CPrimitiveBatch* pBatch;
+                SDL_Rect source;
+                bool bHasSource;
+                bool bWrap;                 // RenderTiled, source.x/y is the scroll offset and source.w/h the filled size
+            } Command_t;
+
+            CRenderQueue() : m_vCommands() {};
+            ~CRenderQueue() {};
+
+            inline void Push( Command_t& cmd )
+            {
+                cmd.nSequence = (unsigned int)m_vCommands.size();
+                m_vCommands.push_back( cmd );
+            }
+
+            /** \brief Sorts by layer, blend mode, source surface and blend state, ties keep the submission order
+             *
+             * \return void
+             *
+             */
+            void Sort()
+            {
+                std::sort( m_vCommands.begin(), m_vCommands.end(), []( const Command_t& a, const Command_t& b ) {
+                    if ( a.iLayer != b.iLayer ) return a.iLayer < b.iLayer;
+                    if ( a.iBlend != b.iBlend ) return a.iBlend < b.iBlend;
+                    if ( a.nSurfaceID != b.nSurfaceID ) return a.nSurfaceID < b.nSurfaceID;
+                    if ( a.nState != b.nState ) return a.nState < b.nState;
+                    return a.nSequence < b.nSequence;
+                });
+            }
+
+            inline vector<Command_t>& Get() { return m_vCommands; }
+            inline bool IsEmpty() const { return m_vCommands.empty(); }
+            inline size_t Count() const { return m_vCommands.size(); }
+            inline void Reserve( size_t n ) { m_vCommands.reserve( n ); }
+            inline void Clear() { m_vCommands.clear(); }
+
+        protected:
+        private:
+            vector<Command_t> m_vCommands;
+    };
+
+}
+
+#endif // RENDERQUEUE_HPP
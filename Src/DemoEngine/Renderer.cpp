@@ -27,7 +27,7 @@
 
 namespace DemoEngine {
 
-    CRenderer::CRenderer() {
+    CRenderer::CRenderer() : m_Upscaler(), m_vScaledRects(), m_Transition(), m_Recorder(), m_DirtyDrawn(), m_DirtyRestored(), m_DirtyPresent(), m_Queue(), m_DebugBatch(), m_Compositor() {
         #ifdef DEBUGCTORS
         cout << "CRenderer ctor called." << endl;
         #endif
@@ -49,6 +49,11 @@ namespace DemoEngine {
     }
 
     /** \brief Open window using SDL
+     *
+     * In headless mode the flags are replaced with SDL_SWSURFACE so the screen is a plain
+     * in-memory surface and presenting it does nothing. With a scale above one the window is
+     * width*scale x height*scale and the screen is a software surface of width x height
+     * in the same pixel format that is upscaled into the window by End.
      *
      * \return void
      *
@@ -59,10 +64,30 @@ namespace DemoEngine {
         if ( !IsInitialized() ) {
             throw runtime_error( "You need to initialize SDL first" );
         }
-        m_pScreen = SDL_SetVideoMode( width, height, bpp, flags );
-        if ( !m_pScreen ) {
+        FreeScreen();
+        m_pDisplay = SDL_SetVideoMode( width * m_iScale, height * m_iScale, bpp, m_bHeadless ? SDL_SWSURFACE : flags );
+        if ( !m_pDisplay ) {
             throw std::runtime_error( std::string( SDL_GetError() ) );
         }
+        m_pScreen = m_pDisplay;
+        if ( m_iScale > 1 ) {
+            const SDL_PixelFormat* format = m_pDisplay->format;
+            m_pScreen = SDL_CreateRGBSurface( SDL_SWSURFACE, width, height, format->BitsPerPixel,
+                                              format->Rmask, format->Gmask, format->Bmask, format->Amask );
+            if ( !m_pScreen ) {
+                m_pDisplay = nullptr;
+                throw std::runtime_error( std::string( SDL_GetError() ) );
+            }
+            if ( format->palette )
+                SDL_SetColors( m_pScreen, format->palette->colors, 0, format->palette->ncolors );
+        }
+        m_DirtyDrawn.SetBounds( m_pScreen->w, m_pScreen->h );
+        m_DirtyRestored.SetBounds( m_pScreen->w, m_pScreen->h );
+        m_DirtyPresent.SetBounds( m_pScreen->w, m_pScreen->h );
+        Invalidate();
+        m_Queue.Reserve( kRenderQueueReserve );
+        // Loaded images convert themselves to the new screen format on their next blit
+        CSingleton<CDisplayFormat>::Instance()->ModeChanged();
     }
 
     /** \brief Initializes SDL
@@ -75,6 +100,11 @@ namespace DemoEngine {
     void CRenderer::Init() throw(runtime_error) {
         // Initialize SDL
         if ( IsInitialized() ) return;
+        if ( m_bHeadless ) {
+            // SDL keeps the pointer so the string must stay alive
+            static char szVideoDriver[] = "SDL_VIDEODRIVER=dummy";
+            SDL_putenv( szVideoDriver );
+        }
         if ( SDL_Init( SDL_INIT_VIDEO ) < 0 ) {
             throw runtime_error( std::string( SDL_GetError() ) );
         }
@@ -90,6 +120,50 @@ namespace DemoEngine {
         SetInitialized( true );
     }
 
+    /** \brief Saves the current screen contents as a BMP file
+     *
+     * \param sFileName const string&
+     * \return void
+     *
+     * \throw runtime_error with SDL error message if failed
+     *
+     */
+    void CRenderer::DumpFrame( const string& sFileName ) const throw(runtime_error) {
+        if ( !m_pScreen ) {
+            throw runtime_error( "DumpFrame -> No screen surface" );
+        }
+        if ( SDL_SaveBMP( m_pScreen, sFileName.c_str() ) < 0 ) {
+            throw runtime_error( string( SDL_GetError() ) );
+        }
+    }
+
+    /** \brief Starts recording the presented frames
+     *
+     * Frames are recorded at the internal resolution (before upscaling).
+     *
+     * \param sPath const string& - Directory for BMP sequences, file name for Y4M streams.
+     * \param iFormat int - CFrameRecorder::FORMAT_BMP or CFrameRecorder::FORMAT_Y4M
+     * \param nSlots size_t - Frames buffered for the writer thread.
+     * \param nFps Uint32 - Frame rate of the Y4M stream.
+     * \return void
+     *
+     * \throw runtime_error if the recording can't be started
+     *
+     */
+    void CRenderer::StartRecording( const string& sPath, int iFormat, size_t nSlots, Uint32 nFps ) throw(runtime_error) {
+        if ( m_pScreen == nullptr ) throw runtime_error( "StartRecording -> No screen surface" );
+        m_Recorder.Start( sPath, iFormat, m_pScreen, nSlots, nFps );
+    }
+
+    /** \brief Writes the buffered frames and stops recording
+     *
+     * \return void
+     *
+     */
+    void CRenderer::StopRecording() {
+        m_Recorder.Stop();
+    }
+
     /** \brief Cleans up the SDL (uninitializes SDL)
      *
      * \return void
@@ -99,11 +173,27 @@ namespace DemoEngine {
      */
     void CRenderer::CleanUp() throw(runtime_error) {
         if ( !IsInitialized() ) return;
+        m_Compositor.Stop();
+        m_Recorder.Stop();
+        m_Transition.Release();
+        FreeScreen();
         IMG_Quit();
         SDL_Quit();
         SetInitialized( false );
     }
 
+    /** \brief Frees the offscreen surface used with a scale above one
+     *
+     * \return void
+     *
+     */
+    void CRenderer::FreeScreen() {
+        if ( m_pScreen != nullptr && m_pScreen != m_pDisplay )
+            SDL_FreeSurface( m_pScreen );
+        m_pScreen = nullptr;
+        m_pDisplay = nullptr;
+    }
+
     /** \brief Render CText objects bitmap to screen
      *
      * \param pText CText*
@@ -113,10 +203,12 @@ namespace DemoEngine {
      *
      */
     void CRenderer::Render( unique_ptr<CText>& pText, const int x, const int y ) const {
+        Flush();
         Sint16 dst_x = (Sint16)x;
         Sint16 dst_y = (Sint16)y;
         SDL_Rect dst = { dst_x, dst_y, 0, 0 };
         SDL_BlitSurface( pText->GetSurface(), NULL, m_pScreen, &dst );
+        Track( dst );
     }
 
     /** \brief Render CImage objects bitmap to screen
@@ -128,16 +220,10 @@ namespace DemoEngine {
      *
      */
     void CRenderer::Render( CImage *pImage, const int x, const int y, SDL_Rect* rect ) const {
-        Sint16 dst_x = (Sint16)x;
-        Sint16 dst_y = (Sint16)y;
-        SDL_Rect dst = { dst_x, dst_y, 0, 0 };
-        SDL_BlitSurface( pImage->GetSurface(), rect, m_pScreen, &dst );
+        Blit( pImage, CRenderQueue::BLEND_NONE, 0, x, y, rect );
     }
     void CRenderer::Render( unique_ptr<CImage>& pImage, const int x, const int y, SDL_Rect* rect ) const {
-        Sint16 dst_x = (Sint16)x;
-        Sint16 dst_y = (Sint16)y;
-        SDL_Rect dst = { dst_x, dst_y, 0, 0 };
-        SDL_BlitSurface( pImage->GetSurface(), rect, m_pScreen, &dst );
+        Blit( pImage.get(), CRenderQueue::BLEND_NONE, 0, x, y, rect );
     }
 
     /** \brief Render CImageColorkey objects bitmap to screen
@@ -149,18 +235,10 @@ namespace DemoEngine {
      *
      */
     void CRenderer::Render( CImageColorkey *pImage, const int x, const int y, SDL_Rect* rect ) const {
-        Sint16 dst_x = (Sint16)x;
-        Sint16 dst_y = (Sint16)y;
-        SDL_Rect dst = { dst_x, dst_y, 0, 0 };
-        SDL_SetColorKey( pImage->GetSurface(), SDL_SRCCOLORKEY, pImage->GetColorkey() );
-        SDL_BlitSurface( pImage->GetSurface(), rect, m_pScreen, &dst );
+        Blit( pImage, CRenderQueue::BLEND_COLORKEY, pImage->GetColorkey(), x, y, rect );
     }
     void CRenderer::Render( unique_ptr<CImageColorkey>& pImage, const int x, const int y, SDL_Rect* rect ) const {
-        Sint16 dst_x = (Sint16)x;
-        Sint16 dst_y = (Sint16)y;
-        SDL_Rect dst = { dst_x, dst_y, 0, 0 };
-        SDL_SetColorKey( pImage->GetSurface(), SDL_SRCCOLORKEY, pImage->GetColorkey() );
-        SDL_BlitSurface( pImage->GetSurface(), rect, m_pScreen, &dst );
+        Blit( pImage.get(), CRenderQueue::BLEND_COLORKEY, pImage->GetColorkey(), x, y, rect );
     }
 
     /** \brief Render CImageAlpha objects bitmap to screen
@@ -172,20 +250,500 @@ namespace DemoEngine {
      *
      */
     void CRenderer::Render( CImageAlpha *pImage, const int x, const int y, SDL_Rect* rect ) const {
-        Sint16 dst_x = (Sint16)x;
-        Sint16 dst_y = (Sint16)y;
-        SDL_Rect dst = { dst_x, dst_y, 0, 0 };
-        SDL_SetAlpha( pImage->GetSurface(), ( pImage->bIsTransparent() ? SDL_SRCALPHA : 0 ), pImage->GetAlpha() );
-        SDL_BlitSurface( pImage->GetSurface(), rect, m_pScreen, &dst );
+        int iBlend;
+        Uint32 nState;
+        GetBlend( pImage, iBlend, nState );
+        Blit( pImage, iBlend, nState, x, y, rect );
     }
     void CRenderer::Render( unique_ptr<CImageAlpha>& pImage, const int x, const int y, SDL_Rect* rect ) const {
-        Sint16 dst_x = (Sint16)x;
-        Sint16 dst_y = (Sint16)y;
-        SDL_Rect dst = { dst_x, dst_y, 0, 0 };
-        SDL_SetAlpha( pImage->GetSurface(), ( pImage->bIsTransparent() ? SDL_SRCALPHA : 0 ), pImage->GetAlpha() );
-        SDL_BlitSurface( pImage->GetSurface(), rect, m_pScreen, &dst );
+        Render( pImage.get(), x, y, rect );
+    }
+
+    /** \brief Render the variant of a sprite bank nearest to the angle and scale
+     *
+     * \param pBank unique_ptr<CSpriteBank>&
+     * \param x const int - Center of the sprite.
+     * \param y const int - Center of the sprite.
+     * \param fDegrees float
+     * \param fScale float
+     * \return void
+     *
+     */
+    void CRenderer::Render( unique_ptr<CSpriteBank>& pBank, const int x, const int y, float fDegrees, float fScale ) const {
+        size_t nIndex = pBank->GetIndex( fDegrees, fScale );
+        CImageAlpha* pImage = pBank->GetVariant( nIndex );
+        if ( pImage == nullptr ) return;
+        Render( pImage, x - pBank->GetCenterX( nIndex ), y - pBank->GetCenterY( nIndex ) );
+    }
+
+    /** \brief Render a frame of a sprite with its shadow baked in
+     *
+     * \param pSprite unique_ptr<CShadowedSprite>&
+     * \param nFrame size_t
+     * \param x const int - Top left corner of the sprite (not the shadow).
+     * \param y const int - Top left corner of the sprite (not the shadow).
+     * \return void
+     *
+     */
+    void CRenderer::Render( unique_ptr<CShadowedSprite>& pSprite, size_t nFrame, const int x, const int y ) const {
+        CImageAlpha* pImage = pSprite->Get( nFrame );
+        if ( pImage == nullptr ) return;
+        Render( pImage, x - pSprite->GetSpriteX(), y - pSprite->GetSpriteY() );
+    }
+
+    /** \brief Fills a rect with an image repeated in both directions (toroidal wrap)
+     *
+     * The whole rect is one command, drawn in one pass over its rows instead of a blit per tile.
+     *
+     * \param pImage CImageAlpha*
+     * \param rect const SDL_Rect& - Area of the screen to fill.
+     * \param iOffsetX int - Image pixel at the top left corner of the rect, wrapped into the image.
+     * \param iOffsetY int
+     * \return void
+     *
+     */
+    void CRenderer::RenderTiled( CImageAlpha *pImage, const SDL_Rect& rect, int iOffsetX, int iOffsetY ) const {
+        int iBlend;
+        Uint32 nState;
+        GetBlend( pImage, iBlend, nState );
+        SDL_Surface* pSurface = pImage->GetSurface();
+        if ( pSurface == nullptr || pSurface->w == 0 || pSurface->h == 0 || rect.w == 0 || rect.h == 0 ) return;
+        iOffsetX %= pSurface->w;
+        iOffsetY %= pSurface->h;
+        if ( iOffsetX < 0 ) iOffsetX += pSurface->w;
+        if ( iOffsetY < 0 ) iOffsetY += pSurface->h;
+
+        CRenderQueue::Command_t cmd;
+        cmd.iLayer = m_iLayer;
+        cmd.iBlend = iBlend;
+        cmd.nSurfaceID = pImage->GetSurfaceID();
+        cmd.nState = nState;
+        cmd.x = rect.x;
+        cmd.y = rect.y;
+        cmd.x2 = 0;
+        cmd.y2 = 0;
+        cmd.nSequence = 0;
+        cmd.pSurface = pSurface;
+        cmd.pSpans = pImage->GetSpans();
+        cmd.pBatch = nullptr;
+        cmd.source = { (Sint16)iOffsetX, (Sint16)iOffsetY, rect.w, rect.h };
+        cmd.bHasSource = true;
+        cmd.bWrap = true;
+
+        if ( m_bQueueing ) {
+            m_Queue.Push( cmd );
+            return;
+        }
+        ApplyState( cmd );
+        Execute( cmd );
+    }
+    void CRenderer::RenderTiled( unique_ptr<CImageAlpha>& pImage, const SDL_Rect& rect, int iOffsetX, int iOffsetY ) const {
+        RenderTiled( pImage.get(), rect, iOffsetX, iOffsetY );
+    }
+
+    /** \brief Gets the blend mode and state of an alpha image
+     *
+     * Converts the image first if needed, as that decides whether it is premultiplied.
+     *
+     * \param pImage CImageAlpha*
+     * \param iBlend int& - BLEND_PREMULTIPLIED or BLEND_ALPHA
+     * \param nState Uint32& - Alpha, with the tint below it for premultiplied images.
+     * \return void
+     *
+     */
+    void CRenderer::GetBlend( CImageAlpha* pImage, int& iBlend, Uint32& nState ) const {
+        pImage->PrepareForDisplay();
+        if ( pImage->IsPremultiplied() ) {
+            iBlend = CRenderQueue::BLEND_PREMULTIPLIED;
+            nState = ( (Uint32)pImage->GetAlpha() << 24 ) | ( pImage->GetTint() & 0xffffff );
+        } else {
+            iBlend = CRenderQueue::BLEND_ALPHA;
+            nState = pImage->GetAlpha();
+        }
+    }
+
+    /** \brief Blits an image or adds it to the render queue when queueing
+     *
+     * The blend state is captured here, so the image can be changed (e.g. SetAlpha)
+     * right after the call even if the blit itself happens later.
+     * Images in a sprite atlas are blitted from the atlas page, the source area is moved
+     * into the atlas rect (and clipped to it). The page rows are blended without spans.
+     *
+     * \param pImage CImage*
+     * \param iBlend int - CRenderQueue::BLENDMODE
+     * \param nState Uint32 - Alpha or colorkey, depending on the blend mode.
+     * \param x const int
+     * \param y const int
+     * \param rect SDL_Rect* - Source area or nullptr for the whole image.
+     * \return void
+     *
+     */
+    void CRenderer::Blit( CImage* pImage, int iBlend, Uint32 nState, const int x, const int y, SDL_Rect* rect ) const {
+        pImage->PrepareForDisplay();
+        CRenderQueue::Command_t cmd;
+        cmd.iLayer = m_iLayer;
+        cmd.iBlend = iBlend;
+        cmd.nSurfaceID = pImage->GetSurfaceID();
+        cmd.nState = nState;
+        cmd.x = (Sint16)x;
+        cmd.y = (Sint16)y;
+        cmd.x2 = 0;
+        cmd.y2 = 0;
+        cmd.nSequence = 0;
+        cmd.pSurface = pImage->GetSurface();
+        cmd.pSpans = pImage->GetSpans();
+        cmd.pBatch = nullptr;
+        cmd.bHasSource = ( rect != nullptr );
+        if ( rect != nullptr ) cmd.source = *rect;
+        else cmd.source = { 0, 0, 0, 0 };
+        cmd.bWrap = false;
+
+        if ( pImage->IsInAtlas() ) {
+            const SDL_Rect& atlasRect = pImage->GetAtlasRect();
+            int sx = 0, sy = 0, sw = atlasRect.w, sh = atlasRect.h;
+            if ( rect != nullptr ) {
+                // Clip like SDL_BlitSurface does against the image surface
+                sx = rect->x;
+                sy = rect->y;
+                sw = rect->w;
+                sh = rect->h;
+                if ( sx < 0 ) { cmd.x -= sx; sw += sx; sx = 0; }
+                if ( sy < 0 ) { cmd.y -= sy; sh += sy; sy = 0; }
+                if ( sx + sw > atlasRect.w ) sw = atlasRect.w - sx;
+                if ( sy + sh > atlasRect.h ) sh = atlasRect.h - sy;
+                if ( sw <= 0 || sh <= 0 ) return;
+            }
+            cmd.pSurface = pImage->GetAtlasPage();
+            cmd.source = { (Sint16)( atlasRect.x + sx ), (Sint16)( atlasRect.y + sy ), (Uint16)sw, (Uint16)sh };
+            cmd.bHasSource = true;
+        }
+
+        if ( m_bQueueing ) {
+            m_Queue.Push( cmd );
+            return;
+        }
+        ApplyState( cmd );
+        Execute( cmd );
+    }
+
+    void CRenderer::ApplyState( const CRenderQueue::Command_t& cmd ) const {
+        SetBlendState( cmd.pSurface, cmd.iBlend, cmd.nState );
+    }
+
+    /** \brief Sets the blend state of a surface if it differs from what the surface already has
+     *
+     * SDL_SetAlpha and SDL_SetColorKey invalidate the blit mapping of the surface, which
+     * is then rebuilt on the next blit. The state stored in the surface itself is the cache,
+     * so it is never out of date even if the surface is changed elsewhere.
+     * Per-pixel alpha surfaces only need the SDL_SRCALPHA flag, the image alpha is passed
+     * to CAlphaBlitter with each blit (SDL ignores it for them).
+     *
+     * \param pSurface SDL_Surface*
+     * \param iBlend int - CRenderQueue::BLENDMODE
+     * \param nState Uint32 - Alpha or colorkey, depending on the blend mode.
+     * \return void
+     *
+     */
+    void CRenderer::SetBlendState( SDL_Surface* pSurface, int iBlend, Uint32 nState ) const {
+        switch ( iBlend ) {
+            case CRenderQueue::BLEND_COLORKEY:
+                if ( ( pSurface->flags & SDL_SRCCOLORKEY ) && pSurface->format->colorkey == nState ) {
+                    ++m_nStateSkips;
+                    return;
+                }
+                SDL_SetColorKey( pSurface, SDL_SRCCOLORKEY, nState );
+                break;
+            case CRenderQueue::BLEND_ALPHA:
+            {
+                Uint32 nFlag = ( nState != 255 ? SDL_SRCALPHA : 0 );
+                if ( ( pSurface->flags & SDL_SRCALPHA ) == nFlag &&
+                     ( nFlag == 0 || pSurface->format->Amask != 0 || pSurface->format->alpha == (Uint8)nState ) ) {
+                    ++m_nStateSkips;
+                    return;
+                }
+                SDL_SetAlpha( pSurface, nFlag, (Uint8)nState );
+                break;
+            }
+            default:
+                return;
+        }
+        ++m_nStateChanges;
+    }
+
+    /** \brief Blits a surface with its current blend state, using CAlphaBlitter when it can
+     *
+     * Premultiplied surfaces are skipped if CAlphaBlitter can't draw them, SDL would draw them wrong.
+     *
+     * \param pSurface SDL_Surface*
+     * \param pSrc SDL_Rect* - Source area or nullptr for the whole surface.
+     * \param pDst SDL_Rect* - Position, on return the clipped area that was drawn.
+     * \param iBlend int - CRenderQueue::BLENDMODE
+     * \param nState Uint32 - Alpha or colorkey, depending on the blend mode.
+     * \param pSpans const CSpanSprite* - Spans of the image or nullptr.
+     * \return void
+     *
+     */
+    void CRenderer::BlitSurface( SDL_Surface* pSurface, SDL_Rect* pSrc, SDL_Rect* pDst, int iBlend, Uint32 nState, const CSpanSprite* pSpans ) const {
+        bool bPremultiplied = ( iBlend == CRenderQueue::BLEND_PREMULTIPLIED );
+        Uint8 cAlpha = 255;
+        if ( iBlend == CRenderQueue::BLEND_ALPHA ) cAlpha = (Uint8)nState;
+        else if ( bPremultiplied ) cAlpha = (Uint8)( nState >> 24 );
+        if ( !CSingleton<CAlphaBlitter>::Instance()->Blit( pSurface, pSrc, m_pScreen, pDst, cAlpha, pSpans, bPremultiplied, nState & 0xffffff ) && !bPremultiplied )
+            SDL_BlitSurface( pSurface, pSrc, m_pScreen, pDst );
+    }
+
+    /** \brief Draws a SDL_gfx primitive or adds it to the render queue when queueing
+     *
+     * \param iPrimitive int - CRenderQueue::PRIMITIVE
+     * \param x1 int
+     * \param y1 int
+     * \param x2 int - End point (not used for pixels, x2 is the end for hlines, y2 for vlines).
+     * \param y2 int
+     * \param c const SDL_Color& - Color, unused is the alpha.
+     * \return void
+     *
+     */
+    void CRenderer::RenderPrimitive( int iPrimitive, int x1, int y1, int x2, int y2, const SDL_Color& c ) const {
+        CRenderQueue::Command_t cmd;
+        cmd.iLayer = m_iLayer;
+        cmd.iBlend = CRenderQueue::BLEND_PRIMITIVE;
+        cmd.nSurfaceID = iPrimitive;
+        cmd.nState = ( (Uint32)c.r << 24 ) | ( (Uint32)c.g << 16 ) | ( (Uint32)c.b << 8 ) | c.unused;
+        cmd.x = (Sint16)x1;
+        cmd.y = (Sint16)y1;
+        cmd.x2 = (Sint16)x2;
+        cmd.y2 = (Sint16)y2;
+        cmd.nSequence = 0;
+        cmd.pSurface = nullptr;
+        cmd.pSpans = nullptr;
+        cmd.pBatch = nullptr;
+        cmd.source = { 0, 0, 0, 0 };
+        cmd.bHasSource = false;
+        cmd.bWrap = false;
+
+        if ( m_bQueueing ) {
+            m_Queue.Push( cmd );
+            return;
+        }
+        Execute( cmd );
+    }
+
+    /** \brief Draws a batch of primitives with one lock of the screen
+     *
+     * When queueing the batch is drawn in the order of its layer, so it must stay alive
+     * and unchanged until the queue is flushed. The bounds of the whole batch are marked dirty.
+     *
+     * \param batch const CPrimitiveBatch&
+     * \return void
+     *
+     */
+    void CRenderer::RenderBatch( const CPrimitiveBatch& batch ) const {
+        if ( batch.IsEmpty() ) return;
+        CRenderQueue::Command_t cmd;
+        cmd.iLayer = m_iLayer;
+        cmd.iBlend = CRenderQueue::BLEND_PRIMITIVE;
+        cmd.nSurfaceID = CRenderQueue::PRIMITIVE_BATCH;
+        cmd.nState = 0;
+        cmd.x = (Sint16)batch.GetMinX();
+        cmd.y = (Sint16)batch.GetMinY();
+        cmd.x2 = (Sint16)batch.GetMaxX();
+        cmd.y2 = (Sint16)batch.GetMaxY();
+        cmd.nSequence = 0;
+        cmd.pSurface = nullptr;
+        cmd.pSpans = nullptr;
+        cmd.pBatch = &batch;
+        cmd.source = { 0, 0, 0, 0 };
+        cmd.bHasSource = false;
+        cmd.bWrap = false;
+
+        if ( m_bQueueing ) {
+            m_Queue.Push( cmd );
+            return;
+        }
+        Execute( cmd );
     }
 
+    void CRenderer::Execute( const CRenderQueue::Command_t& cmd ) const {
+        if ( cmd.iBlend == CRenderQueue::BLEND_PRIMITIVE ) {
+            Uint8 r = cmd.nState >> 24;
+            Uint8 g = ( cmd.nState >> 16 ) & 0xff;
+            Uint8 b = ( cmd.nState >> 8 ) & 0xff;
+            Uint8 a = cmd.nState & 0xff;
+            switch ( cmd.nSurfaceID ) {
+                default:
+                case CRenderQueue::PRIMITIVE_PIXEL:
+                    pixelRGBA( m_pScreen, cmd.x, cmd.y, r, g, b, a );
+                    break;
+                case CRenderQueue::PRIMITIVE_LINE:
+                    lineRGBA( m_pScreen, cmd.x, cmd.y, cmd.x2, cmd.y2, r, g, b, a );
+                    break;
+                case CRenderQueue::PRIMITIVE_BOX:
+                    boxRGBA( m_pScreen, cmd.x, cmd.y, cmd.x2, cmd.y2, r, g, b, a );
+                    break;
+                case CRenderQueue::PRIMITIVE_HLINE:
+                    hlineRGBA( m_pScreen, cmd.x, cmd.x2, cmd.y, r, g, b, a );
+                    break;
+                case CRenderQueue::PRIMITIVE_VLINE:
+                    vlineRGBA( m_pScreen, cmd.x, cmd.y, cmd.y2, r, g, b, a );
+                    break;
+                case CRenderQueue::PRIMITIVE_BATCH:
+                    if ( LockScreen() ) {
+                        cmd.pBatch->Draw( m_pScreen );
+                        UnlockScreen();
+                    }
+                    break;
+            }
+            Track( cmd );
+            return;
+        }
+        if ( cmd.bWrap ) {
+            ExecuteWrapped( cmd );
+            return;
+        }
+        SDL_Rect dst = { cmd.x, cmd.y, 0, 0 };
+        SDL_Rect src = cmd.source;
+        BlitSurface( cmd.pSurface, ( cmd.bHasSource ? &src : NULL ), &dst, cmd.iBlend, cmd.nState, cmd.pSpans );
+        Track( dst );
+    }
+
+    /** \brief Draws a RenderTiled command with its current blend state
+     *
+     * Formats CAlphaBlitter can't wrap are drawn tile by tile (like Render per tile), clipped to the rect.
+     *
+     * \param cmd const CRenderQueue::Command_t&
+     * \return void
+     *
+     */
+    void CRenderer::ExecuteWrapped( const CRenderQueue::Command_t& cmd ) const {
+        bool bPremultiplied = ( cmd.iBlend == CRenderQueue::BLEND_PREMULTIPLIED );
+        Uint8 cAlpha = 255;
+        if ( cmd.iBlend == CRenderQueue::BLEND_ALPHA ) cAlpha = (Uint8)cmd.nState;
+        else if ( bPremultiplied ) cAlpha = (Uint8)( cmd.nState >> 24 );
+        SDL_Rect dst = { cmd.x, cmd.y, cmd.source.w, cmd.source.h };
+        if ( CSingleton<CAlphaBlitter>::Instance()->WrapBlit( cmd.pSurface, cmd.source.x, cmd.source.y, m_pScreen, &dst, cAlpha,
+                                                              cmd.pSpans, bPremultiplied, cmd.nState & 0xffffff ) ) {
+            Track( dst );
+            return;
+        }
+        SDL_Rect clip;
+        SDL_GetClipRect( m_pScreen, &clip );
+        SDL_SetClipRect( m_pScreen, &dst );
+        for ( int y = cmd.y - cmd.source.y; y < cmd.y + cmd.source.h; y += cmd.pSurface->h ) {
+            for ( int x = cmd.x - cmd.source.x; x < cmd.x + cmd.source.w; x += cmd.pSurface->w ) {
+                SDL_Rect tile = { (Sint16)x, (Sint16)y, 0, 0 };
+                BlitSurface( cmd.pSurface, NULL, &tile, cmd.iBlend, cmd.nState, cmd.pSpans );
+            }
+        }
+        SDL_SetClipRect( m_pScreen, &clip );
+        Track( cmd );
+    }
+
+    /** \brief Starts or stops collecting image draws into the render queue
+     *
+     * Stopping flushes the queue.
+     *
+     * \param bQueueing bool
+     * \return void
+     *
+     */
+    void CRenderer::SetQueueing( bool bQueueing ) {
+        if ( !bQueueing ) Flush();
+        m_bQueueing = bQueueing && m_bQueueEnabled;
+    }
+
+    /** \brief Sorts and draws the queued commands
+     *
+     * Blend state is set only when the surface does not have it already (see SetBlendState).
+     * Text and primitive drawing flush the queue first, so they stay on top of what was
+     * submitted before them.
+     *
+     * \return void
+     *
+     */
+    void CRenderer::Flush() const {
+        if ( m_Queue.IsEmpty() ) return;
+        m_Queue.Sort();
+        if ( m_Compositor.IsRunning() && !SDL_MUSTLOCK( m_pScreen ) ) {
+            FlushTiled();
+            m_Queue.Clear();
+            return;
+        }
+        for ( auto& cmd : m_Queue.Get() ) {
+            ApplyState( cmd );
+            Execute( cmd );
+        }
+        m_Queue.Clear();
+    }
+
+    /** \brief Draws the sorted queue with the tile compositor
+     *
+     * The queue is walked in runs of commands sharing one blend state (or runs of primitives).
+     * The state is set and the blit mapping is built on this thread, then the bands of the run
+     * are drawn in parallel. Runs smaller than kMinTiledArea, lines, primitive batches, RenderTiled
+     * fills and surfaces that need locking (RLE, hardware) are drawn here the same way Flush does it.
+     *
+     * \return void
+     *
+     */
+    void CRenderer::FlushTiled() const {
+        const auto& commands = m_Queue.Get();
+        size_t i = 0;
+        while ( i < commands.size() ) {
+            const CRenderQueue::Command_t& first = commands[i];
+            bool bPrimitive = ( first.iBlend == CRenderQueue::BLEND_PRIMITIVE );
+            bool bTiled = bPrimitive ? !IsWholePrimitive( first ) : ( !SDL_MUSTLOCK( first.pSurface ) && !first.bWrap );
+            size_t n = 0;
+            Uint32 nArea = 0;
+            while ( i + n < commands.size() ) {
+                const CRenderQueue::Command_t& cmd = commands[i + n];
+                if ( n > 0 ) {
+                    if ( !bTiled ) break;
+                    if ( bPrimitive ) {
+                        if ( cmd.iBlend != CRenderQueue::BLEND_PRIMITIVE || IsWholePrimitive( cmd ) ) break;
+                    } else if ( cmd.pSurface != first.pSurface || cmd.iBlend != first.iBlend || cmd.nState != first.nState || cmd.bWrap ) {
+                        break;
+                    }
+                }
+                if ( bPrimitive )
+                    nArea += ( std::abs( cmd.x2 - cmd.x ) + 1 ) * ( std::abs( cmd.y2 - cmd.y ) + 1 );
+                else
+                    nArea += ( cmd.bHasSource ? cmd.source.w * cmd.source.h : cmd.pSurface->w * cmd.pSurface->h );
+                ++n;
+            }
+
+            if ( !bPrimitive ) ApplyState( first );
+
+            if ( bTiled && nArea >= kMinTiledArea ) {
+                if ( !bPrimitive ) {
+                    // Builds the blit mapping here, the workers only read it
+                    SDL_Rect empty = { 0, 0, 0, 0 };
+                    SDL_Rect dst = { 0, 0, 0, 0 };
+                    SDL_LowerBlit( first.pSurface, &empty, m_pScreen, &dst );
+                }
+                m_Compositor.Execute( m_pScreen, &first, n );
+                for ( size_t j = 0; j < n; ++j )
+                    Track( commands[i + j] );
+            } else {
+                for ( size_t j = 0; j < n; ++j )
+                    Execute( commands[i + j] );
+            }
+            i += n;
+        }
+    }
+
+    /** \brief Sets the number of tile compositor worker threads
+     *
+     * \param nThreads int - Zero draws the render queue on the main thread only.
+     * \return void
+     *
+     */
+    void CRenderer::SetCompositorThreads( int nThreads ) {
+        Flush();
+        if ( nThreads > 0 )
+            m_Compositor.Start( nThreads );
+        else
+            m_Compositor.Stop();
+    }
 
     /** \brief Begin is called before starting to draw to screen
      *
@@ -201,26 +759,377 @@ namespace DemoEngine {
     }
 
     /** \brief End is called when drawing has been ended and will display the buffer to screen
+     *
+     * With dirty rectangles enabled only the regions restored and drawn during this frame
+     * are presented, unless they cover too much of the screen.
      *
      * \return void
      *
      */
-    void CRenderer::End() const {
-        if ( m_pScreen != nullptr ) {
-            SDL_Flip( m_pScreen );
+    void CRenderer::End() {
+        if ( m_pScreen == nullptr ) return;
+        Flush();
+        if ( !m_DebugBatch.IsEmpty() ) {
+            RenderBatch( m_DebugBatch );
+            Flush();
+            m_DebugBatch.Clear();
+        }
+        if ( m_Recorder.IsRecording() && LockScreen() ) {
+            m_Recorder.Capture( m_pScreen );
+            UnlockScreen();
+        }
+        if ( !IsDirtyRectangles() ) {
+            Present( nullptr );
+            m_fDirtyCoverage = 1.0f;
+            ++m_nFullPresents;
+            return;
+        }
+        // Background was not rendered this frame, the restored regions are no longer valid
+        if ( m_pBackground != nullptr && !m_bBackgroundUsed ) {
+            m_pBackground = nullptr;
+            m_pBackgroundSpans = nullptr;
+            m_bInvalidated = true;
+        }
+        m_bBackgroundUsed = false;
+
+        m_DirtyPresent.Add( m_DirtyDrawn );
+        m_DirtyPresent.Merge();
+        m_fDirtyCoverage = m_DirtyPresent.Coverage();
+        if ( m_fDirtyCoverage > m_fDirtyThreshold || m_DirtyPresent.Count() > kMaxDirtyRectangles ) {
+            Present( nullptr );
+            ++m_nFullPresents;
+        } else if ( !m_DirtyPresent.IsEmpty() ) {
+            Present( &m_DirtyPresent.Get() );
+            ++m_nPartialPresents;
+        }
+        m_DirtyPresent.Clear();
+
+        // Everything drawn now has to be restored at the start of the next frame
+        m_DirtyRestored.Swap( m_DirtyDrawn );
+        m_DirtyDrawn.Clear();
+    }
+
+    /** \brief Shows the screen in the window, upscaling it first when the scale is above one
+     *
+     * Double buffered windows are always upscaled and flipped whole because the rectangles
+     * of the other buffer would be stale.
+     *
+     * \param pRects vector<SDL_Rect>* - regions to update or nullptr for the whole screen
+     * \return void
+     *
+     */
+    void CRenderer::Present( vector<SDL_Rect>* pRects ) {
+        if ( m_pDisplay == m_pScreen ) {
+            if ( pRects )
+                SDL_UpdateRects( m_pScreen, (int)pRects->size(), &(*pRects)[0] );
+            else
+                SDL_Flip( m_pScreen );
+            return;
         }
+        if ( m_pDisplay->flags & SDL_DOUBLEBUF ) pRects = nullptr;
+        if ( SDL_MUSTLOCK( m_pDisplay ) && SDL_LockSurface( m_pDisplay ) < 0 ) return;
+        if ( pRects == nullptr ) {
+            m_Upscaler.Scale( m_pScreen, m_pDisplay, m_iScale );
+        } else {
+            m_vScaledRects.clear();
+            for ( auto& rect : *pRects ) {
+                m_Upscaler.Scale( m_pScreen, m_pDisplay, m_iScale, rect );
+                SDL_Rect scaled = { (Sint16)( rect.x * m_iScale ), (Sint16)( rect.y * m_iScale ),
+                                    (Uint16)( rect.w * m_iScale ), (Uint16)( rect.h * m_iScale ) };
+                m_vScaledRects.push_back( scaled );
+            }
+        }
+        if ( SDL_MUSTLOCK( m_pDisplay ) ) SDL_UnlockSurface( m_pDisplay );
+        if ( pRects )
+            SDL_UpdateRects( m_pDisplay, (int)m_vScaledRects.size(), &m_vScaledRects[0] );
+        else
+            SDL_Flip( m_pDisplay );
     }
 
     void CRenderer::SetClearColor(Uint8 r, Uint8 g, Uint8 b)
     {
         if ( m_pScreen != nullptr )
             m_ClearColor = SDL_MapRGB( m_pScreen->format, r, g, b );
+        Invalidate();
     }
 
-    void CRenderer::ClearScreen() const
+    /** \brief Clears the screen
+     *
+     * With dirty rectangles enabled only the regions drawn during the previous frame are
+     * cleared and the background (see RenderBackground) is restored into them.
+     *
+     * \return void
+     *
+     */
+    void CRenderer::ClearScreen()
     {
-        if ( m_pScreen != nullptr )
+        if ( m_pScreen == nullptr ) return;
+        if ( !IsDirtyRectangles() ) {
             SDL_FillRect( m_pScreen, NULL, m_ClearColor );
+            return;
+        }
+        if ( m_bInvalidated ) {
+            m_DirtyRestored.AddAll();
+            m_bInvalidated = false;
+        }
+        m_DirtyRestored.Merge();
+        if ( m_pBackground != nullptr )
+            SetBlendState( m_pBackground, m_iBackgroundBlend, m_nBackgroundState );
+        for ( auto& r : m_DirtyRestored.Get() ) {
+            // SDL clips the rectangles in place, so pass copies
+            SDL_Rect fill = r;
+            SDL_FillRect( m_pScreen, &fill, m_ClearColor );
+            if ( m_pBackground != nullptr ) {
+                SDL_Rect src = r;
+                SDL_Rect dst = r;
+                BlitSurface( m_pBackground, &src, &dst, m_iBackgroundBlend, m_nBackgroundState, m_pBackgroundSpans );
+            }
+        }
+        m_DirtyPresent.Add( m_DirtyRestored );
+        m_DirtyRestored.Clear();
+    }
+
+    /** \brief Renders a full screen background at 0,0
+     *
+     * With dirty rectangles enabled the background is only drawn when it (or its alpha)
+     * changes. Otherwise ClearScreen restores it into the regions that were drawn over.
+     * Call this before drawing anything else in the frame.
+     *
+     * \param pImage unique_ptr<CImageAlpha>&
+     * \return void
+     *
+     */
+    void CRenderer::RenderBackground( unique_ptr<CImageAlpha>& pImage )
+    {
+        if ( !IsDirtyRectangles() ) {
+            Render( pImage, 0, 0 );
+            return;
+        }
+        m_bBackgroundUsed = true;
+        int iBlend;
+        Uint32 nState;
+        GetBlend( pImage.get(), iBlend, nState );
+        if ( pImage->GetSurface() == m_pBackground && iBlend == m_iBackgroundBlend && nState == m_nBackgroundState )
+            return;
+        m_pBackground = pImage->GetSurface();
+        m_iBackgroundBlend = iBlend;
+        m_nBackgroundState = nState;
+        m_pBackgroundSpans = pImage->GetSpans();
+        SDL_FillRect( m_pScreen, NULL, m_ClearColor );
+        SetBlendState( m_pBackground, m_iBackgroundBlend, m_nBackgroundState );
+        SDL_Rect dst = { 0, 0, 0, 0 };
+        BlitSurface( m_pBackground, NULL, &dst, m_iBackgroundBlend, m_nBackgroundState, m_pBackgroundSpans );
+        m_DirtyPresent.AddAll();
+    }
+
+    /** \brief Blends the whole screen towards a color
+     *
+     * Used for fading in and out instead of drawing a translucent full screen box.
+     * Falls back to boxRGBA on palettized screens.
+     *
+     * \param r Uint8
+     * \param g Uint8
+     * \param b Uint8
+     * \param amount Uint8 - 0 keeps the screen, 255 fills it with the color
+     * \return void
+     *
+     */
+    void CRenderer::RenderFade( Uint8 r, Uint8 g, Uint8 b, Uint8 amount ) const
+    {
+        Flush();
+        if ( amount == 0 ) return;
+        Track( 0, 0, m_pScreen->w - 1, m_pScreen->h - 1 );
+        if ( !LockScreen() ) return;
+        bool bDone = m_Transition.Fade( m_pScreen, SDL_MapRGB( m_pScreen->format, r, g, b ), amount );
+        UnlockScreen();
+        if ( !bDone )
+            boxRGBA( m_pScreen, 0, 0, m_pScreen->w - 1, m_pScreen->h - 1, r, g, b, amount );
+    }
+
+    /** \brief Adds a color to the whole screen (saturating)
+     *
+     * \param r Uint8
+     * \param g Uint8
+     * \param b Uint8
+     * \param amount Uint8 - share of the color added
+     * \return void
+     *
+     */
+    void CRenderer::RenderFlash( Uint8 r, Uint8 g, Uint8 b, Uint8 amount ) const
+    {
+        Flush();
+        if ( amount == 0 ) return;
+        Track( 0, 0, m_pScreen->w - 1, m_pScreen->h - 1 );
+        if ( !LockScreen() ) return;
+        bool bDone = m_Transition.Flash( m_pScreen, SDL_MapRGB( m_pScreen->format, r, g, b ), amount );
+        UnlockScreen();
+        if ( !bDone )
+            boxRGBA( m_pScreen, 0, 0, m_pScreen->w - 1, m_pScreen->h - 1, r, g, b, amount );
+    }
+
+    /** \brief Blends the screen towards a frame cached with CaptureFrame
+     *
+     * \param iFrame int - CTransition::FRAME_FROM or CTransition::FRAME_TO
+     * \param amount Uint8 - 0 keeps the screen, 255 shows only the cached frame
+     * \return void
+     *
+     */
+    void CRenderer::RenderCrossfade( int iFrame, Uint8 amount ) const
+    {
+        Flush();
+        Track( 0, 0, m_pScreen->w - 1, m_pScreen->h - 1 );
+        if ( !LockScreen() ) return;
+        m_Transition.Crossfade( m_pScreen, iFrame, amount );
+        UnlockScreen();
+    }
+
+    /** \brief Fills the screen with a blend of two cached frames
+     *
+     * \param iFrom int
+     * \param iTo int
+     * \param amount Uint8 - 0 shows only iFrom, 255 only iTo
+     * \return void
+     *
+     */
+    void CRenderer::RenderCrossfade( int iFrom, int iTo, Uint8 amount ) const
+    {
+        Flush();
+        Track( 0, 0, m_pScreen->w - 1, m_pScreen->h - 1 );
+        if ( !LockScreen() ) return;
+        m_Transition.Crossfade( m_pScreen, iFrom, iTo, amount );
+        UnlockScreen();
+    }
+
+    /** \brief Covers part of the screen with a cached frame
+     *
+     * \param iFrame int
+     * \param iDirection int - CTransition::WIPE_LEFT, WIPE_RIGHT, WIPE_UP or WIPE_DOWN
+     * \param amount Uint8 - share of the screen covered
+     * \return void
+     *
+     */
+    void CRenderer::RenderWipe( int iFrame, int iDirection, Uint8 amount ) const
+    {
+        Flush();
+        if ( amount == 0 ) return;
+        Track( 0, 0, m_pScreen->w - 1, m_pScreen->h - 1 );
+        if ( !LockScreen() ) return;
+        m_Transition.Wipe( m_pScreen, iFrame, iDirection, amount );
+        UnlockScreen();
+    }
+
+    /** \brief Caches a frame for the transitions
+     *
+     * \param iFrame int - CTransition::FRAME_FROM or CTransition::FRAME_TO
+     * \param pSource SDL_Surface* - converted to the screen format, the screen itself if nullptr
+     * \return void
+     *
+     * \throw runtime_error with SDL error message if failed
+     *
+     */
+    void CRenderer::CaptureFrame( int iFrame, SDL_Surface* pSource ) throw(runtime_error)
+    {
+        Flush();
+        m_Transition.Capture( pSource != nullptr ? pSource : m_pScreen, iFrame, m_pScreen->format );
+    }
+
+    bool CRenderer::LockScreen() const
+    {
+        return ( !SDL_MUSTLOCK( m_pScreen ) || SDL_LockSurface( m_pScreen ) == 0 );
+    }
+
+    void CRenderer::UnlockScreen() const
+    {
+        if ( SDL_MUSTLOCK( m_pScreen ) ) SDL_UnlockSurface( m_pScreen );
+    }
+
+    /** \brief Enables or disables dirty rectangle tracking
+     *
+     * Has no effect on double buffered (hardware) screens, they are always flipped.
+     *
+     * \param bEnabled bool
+     * \return void
+     *
+     */
+    void CRenderer::SetDirtyRectangles( bool bEnabled )
+    {
+        if ( bEnabled == m_bDirtyRectangles ) return;
+        m_bDirtyRectangles = bEnabled;
+        m_pBackground = nullptr;
+        m_pBackgroundSpans = nullptr;
+        Invalidate();
+    }
+
+    bool CRenderer::IsDirtyRectangles() const
+    {
+        return ( m_bDirtyRectangles && m_pScreen != nullptr && !( m_pScreen->flags & SDL_DOUBLEBUF ) );
+    }
+
+    /** \brief Sets the screen coverage (0..1) after which the whole screen is flipped instead
+     *
+     * \param fCoverage float
+     * \return void
+     *
+     */
+    void CRenderer::SetDirtyRectangleThreshold( float fCoverage )
+    {
+        m_fDirtyThreshold = fCoverage;
+    }
+
+    /** \brief Forces the whole screen to be cleared and presented on the next frame
+     *
+     * \return void
+     *
+     */
+    void CRenderer::Invalidate()
+    {
+        m_bInvalidated = true;
+        m_DirtyDrawn.Clear();
+        m_DirtyRestored.Clear();
+        m_DirtyPresent.Clear();
+    }
+
+    void CRenderer::Track( const SDL_Rect& rect ) const
+    {
+        if ( m_bDirtyRectangles )
+            m_DirtyDrawn.Add( rect );
+    }
+
+    /** \brief Marks the area a queued command draws to as dirty
+     */
+    void CRenderer::Track( const CRenderQueue::Command_t& cmd ) const
+    {
+        if ( !m_bDirtyRectangles ) return;
+        if ( cmd.iBlend == CRenderQueue::BLEND_PRIMITIVE ) {
+            switch ( cmd.nSurfaceID ) {
+                default:
+                case CRenderQueue::PRIMITIVE_PIXEL:
+                    Track( cmd.x, cmd.y, cmd.x, cmd.y );
+                    break;
+                case CRenderQueue::PRIMITIVE_LINE:
+                case CRenderQueue::PRIMITIVE_BOX:
+                case CRenderQueue::PRIMITIVE_BATCH:
+                    Track( cmd.x, cmd.y, cmd.x2, cmd.y2 );
+                    break;
+                case CRenderQueue::PRIMITIVE_HLINE:
+                    Track( cmd.x, cmd.y, cmd.x2, cmd.y );
+                    break;
+                case CRenderQueue::PRIMITIVE_VLINE:
+                    Track( cmd.x, cmd.y, cmd.x, cmd.y2 );
+                    break;
+            }
+            return;
+        }
+        SDL_Rect dst = { cmd.x, cmd.y, (Uint16)( cmd.bHasSource ? cmd.source.w : cmd.pSurface->w ), (Uint16)( cmd.bHasSource ? cmd.source.h : cmd.pSurface->h ) };
+        Track( dst );
+    }
+
+    /** \brief Marks an area drawn (inclusive corner coordinates, in any order)
+     */
+    void CRenderer::Track( int x1, int y1, int x2, int y2 ) const
+    {
+        if ( m_bDirtyRectangles )
+            m_DirtyDrawn.Add( std::min( x1, x2 ), std::min( y1, y2 ), std::abs( x2 - x1 ) + 1, std::abs( y2 - y1 ) + 1 );
     }
 
     SDL_Surface* CRenderer::GetScreen() const
@@ -230,10 +1139,12 @@ namespace DemoEngine {
 
     void CRenderer::Render( CCircle *pCircle )
     {
+        Flush();
         int x = static_cast<int>( pCircle->GetX() );
         int y = static_cast<int>( pCircle->GetY() );
         int radius = static_cast<int>( pCircle->GetRadius() );
         SDL_Color & c = pCircle->GetColor();
+        Track( x - radius, y - radius, x + radius, y + radius );
         if ( pCircle->IsFilled() )
             filledCircleRGBA( GetScreen(), x, y, radius, c.r, c.g, c.b, c.unused );
         else
@@ -241,10 +1152,12 @@ namespace DemoEngine {
     }
     void CRenderer::Render( unique_ptr<CCircle>& pCircle )
     {
+        Flush();
         int x = static_cast<int>( pCircle->GetX() );
         int y = static_cast<int>( pCircle->GetY() );
         int radius = static_cast<int>( pCircle->GetRadius() );
         SDL_Color & c = pCircle->GetColor();
+        Track( x - radius, y - radius, x + radius, y + radius );
         if ( pCircle->IsFilled() )
             filledCircleRGBA( GetScreen(), x, y, radius, c.r, c.g, c.b, c.unused );
         else
@@ -253,11 +1166,13 @@ namespace DemoEngine {
 
     void CRenderer::Render( CEllipse *pEllipse)
     {
+        Flush();
         int x = static_cast<int>( pEllipse->GetX() );
         int y = static_cast<int>( pEllipse->GetY() );
         int w = static_cast<int>( pEllipse->GetWidth() );
         int h = static_cast<int>( pEllipse->GetHeight() );
         SDL_Color & c = pEllipse->GetColor();
+        Track( x - w, y - h, x + w, y + h );
         if ( pEllipse->IsFilled() )
             filledEllipseRGBA( GetScreen(), x, y, w , h, c.r, c.g, c.b, c.unused );
         else
@@ -265,11 +1180,13 @@ namespace DemoEngine {
     }
     void CRenderer::Render( unique_ptr<CEllipse>& pEllipse)
     {
+        Flush();
         int x = static_cast<int>( pEllipse->GetX() );
         int y = static_cast<int>( pEllipse->GetY() );
         int w = static_cast<int>( pEllipse->GetWidth() );
         int h = static_cast<int>( pEllipse->GetHeight() );
         SDL_Color & c = pEllipse->GetColor();
+        Track( x - w, y - h, x + w, y + h );
         if ( pEllipse->IsFilled() )
             filledEllipseRGBA( GetScreen(), x, y, w , h, c.r, c.g, c.b, c.unused );
         else
@@ -278,11 +1195,13 @@ namespace DemoEngine {
 
     void CRenderer::Render( CRectangle *pRect )
     {
+        Flush();
         int x = static_cast<int>( pRect->GetX() );
         int y = static_cast<int>( pRect->GetY() );
         int x2 = x + static_cast<int>( pRect->GetWidth() );
         int y2 = y + static_cast<int>( pRect->GetHeight() );
         SDL_Color & c = pRect->GetColor();
+        Track( x, y, x2, y2 );
         if ( pRect->IsFilled() )
             boxRGBA( GetScreen(), x, y, x2, y2, c.r, c.g, c.b, c.unused );
         else
@@ -290,11 +1209,13 @@ namespace DemoEngine {
     }
     void CRenderer::Render( unique_ptr<CRectangle>& pRect )
     {
+        Flush();
         int x = static_cast<int>( pRect->GetX() );
         int y = static_cast<int>( pRect->GetY() );
         int x2 = x + static_cast<int>( pRect->GetWidth() );
         int y2 = y + static_cast<int>( pRect->GetHeight() );
         SDL_Color & c = pRect->GetColor();
+        Track( x, y, x2, y2 );
         if ( pRect->IsFilled() )
             boxRGBA( GetScreen(), x, y, x2, y2, c.r, c.g, c.b, c.unused );
         else
@@ -303,20 +1224,24 @@ namespace DemoEngine {
 
     void CRenderer::Render( CLineSegment *pLine )
     {
+        Flush();
         int x  = static_cast<int>( pLine->GetStart()[0] );
         int y  = static_cast<int>( pLine->GetStart()[1] );
         int x2 = static_cast<int>( pLine->GetEnd()[0] );
         int y2 = static_cast<int>( pLine->GetEnd()[1] );
         SDL_Color & c = pLine->GetColor();
+        Track( x, y, x2, y2 );
         lineRGBA( GetScreen(), x, y, x2, y2, c.r, c.g, c.b, c.unused );
     }
     void CRenderer::Render( unique_ptr<CLineSegment>& pLine )
     {
+        Flush();
         int x  = static_cast<int>( pLine->GetStart()[0] );
         int y  = static_cast<int>( pLine->GetStart()[1] );
         int x2 = static_cast<int>( pLine->GetEnd()[0] );
         int y2 = static_cast<int>( pLine->GetEnd()[1] );
         SDL_Color & c = pLine->GetColor();
+        Track( x, y, x2, y2 );
         lineRGBA( GetScreen(), x, y, x2, y2, c.r, c.g, c.b, c.unused );
     }
 }
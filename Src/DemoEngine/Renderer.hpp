@@ -27,8 +27,10 @@
 #define RENDERER_HPP
 
 #include <memory>       // for unique_ptr
+#include <cstdlib>
 #include <stdexcept>
 #include <string>
+#include <vector>
 #include <SDL.h>
 #include <SDL_gfxPrimitives.h>
 #include <SDL_image.h>
@@ -42,6 +44,16 @@
 #include "Ellipse.hpp"
 #include "Rectangle.hpp"
 #include "LineSegment.hpp"
+#include "DirtyRectangles.hpp"
+#include "RenderQueue.hpp"
+#include "TileCompositor.hpp"
+#include "AlphaBlitter.hpp"
+#include "Upscaler.hpp"
+#include "Transition.hpp"
+#include "PrimitiveBatch.hpp"
+#include "FrameRecorder.hpp"
+#include "SpriteBank.hpp"
+#include "ShadowedSprite.hpp"
 
 // Its good idea to use own namespace
 namespace DemoEngine {
@@ -50,6 +62,7 @@ namespace DemoEngine {
     using std::unique_ptr;
     using std::runtime_error;
     using std::string;
+    using std::vector;
 
     class CRenderer : public CInitializable
     {
@@ -59,8 +72,24 @@ namespace DemoEngine {
             void CleanUp() throw(runtime_error);
             void OpenWindow( const int width, const int height, const int bpp, const Uint32 flags ) throw(runtime_error);
 
+            // Headless mode renders into an in-memory software surface with no display (set before Init)
+            inline void SetHeadless( bool bHeadless ) { m_bHeadless = bHeadless; }
+            inline bool IsHeadless() const { return m_bHeadless; }
+            void DumpFrame( const string& sFileName ) const throw(runtime_error);
+
+            // Recording, End copies every presented frame into a ring written out by a background thread
+            void StartRecording( const string& sPath, int iFormat, size_t nSlots = 8, Uint32 nFps = 60 ) throw(runtime_error);
+            void StopRecording();
+            inline const CFrameRecorder& GetRecorder() const { return m_Recorder; }
+
+            // Internal resolution, the screen is rendered at the window size divided by the scale
+            // and upscaled to the window when presented (set before OpenWindow)
+            inline void SetScale( int iScale ) { m_iScale = ( iScale > 1 ? iScale : 1 ); }
+            inline int GetScale() const { return m_iScale; }
+            inline SDL_Surface* GetDisplay() const { return m_pDisplay; }
+
             void Begin() const;
-            void End() const;
+            void End();
 
             // Render function (using CImage class)
             void Render( CImage *pImage, const int x, const int y, SDL_Rect* rect = nullptr ) const;
@@ -71,6 +100,32 @@ namespace DemoEngine {
             void Render( unique_ptr<CImage>& pImage, const int x, const int y, SDL_Rect* rect = nullptr ) const;
             void Render( unique_ptr<CImageColorkey>& pImage, const int x, const int y, SDL_Rect* rect = nullptr ) const;
             void Render( unique_ptr<CImageAlpha>& pImage, const int x, const int y, SDL_Rect* rect = nullptr ) const;
+            // Draws the variant of the bank nearest to the angle and scale, centered on x, y
+            void Render( unique_ptr<CSpriteBank>& pBank, const int x, const int y, float fDegrees, float fScale = 1.0f ) const;
+            // Draws a frame of a sprite with its shadow baked in, x, y is the top left corner of the sprite
+            void Render( unique_ptr<CShadowedSprite>& pSprite, size_t nFrame, const int x, const int y ) const;
+            // Fills a rect with the image repeated in both directions, iOffsetX, iOffsetY is the image pixel at its top left corner
+            void RenderTiled( CImageAlpha *pImage, const SDL_Rect& rect, int iOffsetX, int iOffsetY ) const;
+            void RenderTiled( unique_ptr<CImageAlpha>& pImage, const SDL_Rect& rect, int iOffsetX, int iOffsetY ) const;
+
+            // Render queue, image draws are collected and drawn sorted on Flush
+            void SetQueueing( bool bQueueing );
+            inline bool IsQueueing() const { return m_bQueueing; }
+            inline void SetQueueEnabled( bool bEnabled ) { m_bQueueEnabled = bEnabled; }
+            inline void SetLayer( int iLayer ) { m_iLayer = iLayer; }
+            inline int GetLayer() const { return m_iLayer; }
+            inline unsigned int GetStateChanges() const { return m_nStateChanges; }
+            inline unsigned int GetStateSkips() const { return m_nStateSkips; }
+            void Flush() const;
+            void RenderPrimitive( int iPrimitive, int x1, int y1, int x2, int y2, const SDL_Color& c ) const;
+            void RenderBatch( const CPrimitiveBatch& batch ) const;
+
+            // Debug overlay (hitboxes etc.), drawn on top of everything at the end of the frame
+            inline CPrimitiveBatch& GetDebugBatch() { return m_DebugBatch; }
+
+            // Tile compositor, draws the render queue in horizontal bands with worker threads (0 = off)
+            void SetCompositorThreads( int nThreads );
+            inline int GetCompositorThreads() const { return (int)m_Compositor.GetBandCount() - 1; }
 
             // Additional render functions
             void Render( CCircle *pCircle );
@@ -83,9 +138,34 @@ namespace DemoEngine {
             void Render( unique_ptr<CRectangle>& pRect );
             void Render( unique_ptr<CLineSegment>& pLine );
 
-            void ClearScreen() const;
+            // Full screen background, only redrawn when dirty rectangles are enabled and it changes
+            void RenderBackground( unique_ptr<CImageAlpha>& pImage );
+
+            // Full screen transitions, applied in place to everything drawn so far in the frame
+            void RenderFade( Uint8 r, Uint8 g, Uint8 b, Uint8 amount ) const;
+            void RenderFlash( Uint8 r, Uint8 g, Uint8 b, Uint8 amount ) const;
+            void RenderCrossfade( int iFrame, Uint8 amount ) const;
+            void RenderCrossfade( int iFrom, int iTo, Uint8 amount ) const;
+            void RenderWipe( int iFrame, int iDirection, Uint8 amount ) const;
+            void CaptureFrame( int iFrame, SDL_Surface* pSource = nullptr ) throw(runtime_error);
+            inline CTransition& GetTransition() { return m_Transition; }
+
+            void ClearScreen();
             void SetClearColor(Uint8 r, Uint8 g, Uint8 b);
             SDL_Surface* GetScreen() const;
+            // Whether a rect in screen coordinates is at least partly on the screen
+            inline bool IsVisible( int x, int y, int w, int h ) const {
+                return ( m_pScreen != nullptr && w > 0 && h > 0 && x < m_pScreen->w && y < m_pScreen->h && x + w > 0 && y + h > 0 );
+            }
+
+            // Dirty rectangle tracking (partial screen updates)
+            void SetDirtyRectangles( bool bEnabled );
+            bool IsDirtyRectangles() const;
+            void SetDirtyRectangleThreshold( float fCoverage );
+            void Invalidate();
+            inline float GetDirtyCoverage() const { return m_fDirtyCoverage; }
+            inline unsigned int GetPartialPresents() const { return m_nPartialPresents; }
+            inline unsigned int GetFullPresents() const { return m_nFullPresents; }
 
             CRenderer();
             virtual ~CRenderer();
@@ -95,9 +175,72 @@ namespace DemoEngine {
             CRenderer(const CRenderer& other)=delete;             // Because we have pointer datamembers this class can't be automatically copied correctly.
             CRenderer& operator=(const CRenderer& other)=delete;  // Because we have pointer datamembers this class can't be automatically copied correctly.
         protected:
+            void Blit( CImage* pImage, int iBlend, Uint32 nState, const int x, const int y, SDL_Rect* rect ) const;
+            void ApplyState( const CRenderQueue::Command_t& cmd ) const;
+            void SetBlendState( SDL_Surface* pSurface, int iBlend, Uint32 nState ) const;
+            void BlitSurface( SDL_Surface* pSurface, SDL_Rect* pSrc, SDL_Rect* pDst, int iBlend, Uint32 nState, const CSpanSprite* pSpans = nullptr ) const;
+            void GetBlend( CImageAlpha* pImage, int& iBlend, Uint32& nState ) const;
+            void Execute( const CRenderQueue::Command_t& cmd ) const;
+            void ExecuteWrapped( const CRenderQueue::Command_t& cmd ) const;
+            void FlushTiled() const;
+            void Track( const CRenderQueue::Command_t& cmd ) const;
+            static inline bool IsWholePrimitive( const CRenderQueue::Command_t& cmd ) {
+                return ( cmd.nSurfaceID == CRenderQueue::PRIMITIVE_LINE || cmd.nSurfaceID == CRenderQueue::PRIMITIVE_BATCH );
+            }
+            void Track( const SDL_Rect& rect ) const;
+            void Track( int x1, int y1, int x2, int y2 ) const;
+            void Present( vector<SDL_Rect>* pRects );
+            bool LockScreen() const;
+            void UnlockScreen() const;
+            void FreeScreen();
+
             // C++11 allows initializing here (for older compilers you can initialize at the ctor)
             SDL_Surface* m_pScreen = nullptr;
             Uint32 m_ClearColor = 0;
+            bool m_bHeadless = false;
+
+            // Internal resolution
+            SDL_Surface* m_pDisplay = nullptr;          // Video surface, m_pScreen when not scaled
+            int m_iScale = 1;
+            CUpscaler m_Upscaler;
+            vector<SDL_Rect> m_vScaledRects;
+
+            // Transitions
+            mutable CTransition m_Transition;
+
+            // Recording
+            CFrameRecorder m_Recorder;
+
+            // Dirty rectangles
+            const size_t kMaxDirtyRectangles = 64;     // Flip the whole screen when more rectangles than this are left after merging
+            mutable CDirtyRectangles m_DirtyDrawn;      // Drawn during this frame
+            CDirtyRectangles m_DirtyRestored;           // Drawn during the previous frame, restored by ClearScreen
+            CDirtyRectangles m_DirtyPresent;            // Passed to SDL_UpdateRects
+            bool m_bDirtyRectangles = false;
+            bool m_bInvalidated = true;
+            float m_fDirtyThreshold = 0.5f;
+            float m_fDirtyCoverage = 1.0f;
+            unsigned int m_nPartialPresents = 0;
+            unsigned int m_nFullPresents = 0;
+            SDL_Surface* m_pBackground = nullptr;
+            int m_iBackgroundBlend = CRenderQueue::BLEND_ALPHA;
+            Uint32 m_nBackgroundState = 255;
+            const CSpanSprite* m_pBackgroundSpans = nullptr;
+            bool m_bBackgroundUsed = false;
+
+            // Render queue
+            const size_t kRenderQueueReserve = 1024;
+            mutable CRenderQueue m_Queue;
+            bool m_bQueueing = false;
+            bool m_bQueueEnabled = true;
+            int m_iLayer = LAYER_SPRITES;
+            CPrimitiveBatch m_DebugBatch;
+            mutable unsigned int m_nStateChanges = 0;  // SDL_SetAlpha/SDL_SetColorKey calls made
+            mutable unsigned int m_nStateSkips = 0;    // and skipped because the surface already had the state
+
+            // Tile compositor
+            const Uint32 kMinTiledArea = 16384;        // Smaller runs of commands are drawn on the main thread
+            mutable CTileCompositor m_Compositor;
     };
 
 }
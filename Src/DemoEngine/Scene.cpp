@@ -36,41 +36,54 @@ namespace DemoEngine {
     }
 
     void CScene::Render( unique_ptr<CRenderer>& renderer ) {
+        // Objects outside the screen are not rendered at all
+        m_nDrawn = 0;
+        m_nCulled = 0;
+        // Collect everything into the render queue, it is sorted and drawn once at the end
+        renderer->SetQueueing( true );
         // Render Pre-Renderables
-        {
-            auto& lst = GetPreRenderables();
-            for ( auto& p : lst )
-            {
-                #ifdef DEBUG
-                p.second->RenderDebug( renderer );
-                #else
-                p.second->Render( renderer );
-                #endif
-            }
-        }
+        renderer->SetLayer( LAYER_BACKGROUND );
+        RenderList( renderer, GetPreRenderables() );
         // Render Renderables
+        renderer->SetLayer( LAYER_SPRITES );
+        RenderList( renderer, GetRenderables() );
+        // Render Post-Renderables
+        renderer->SetLayer( LAYER_OVERLAY );
+        RenderList( renderer, GetPostRenderables() );
+        renderer->SetQueueing( false );
+        renderer->SetLayer( LAYER_SPRITES );
+    }
+
+    /** \brief Renders the objects of a list that are at least partly on the screen
+     *
+     * Objects without render bounds are always rendered, objects with empty bounds are skipped.
+     *
+     * \param renderer unique_ptr<CRenderer>&
+     * \param lst RenderableList_t&
+     * \return void
+     *
+     */
+    void CScene::RenderList( unique_ptr<CRenderer>& renderer, RenderableList_t& lst ) {
+        for ( auto& p : lst )
         {
-            auto& lst = GetRenderables();
-            for ( auto& p : lst )
+            SDL_Rect rect;
+            bool bBounds = p.second->GetRenderBounds( rect );
+            // Nothing to draw (e.g. dead pooled objects), not counted as culled
+            if ( bBounds && ( rect.w == 0 || rect.h == 0 ) )
             {
-                #ifdef DEBUG
-                p.second->RenderDebug( renderer );
-                #else
-                p.second->Render( renderer );
-                #endif
+                continue;
             }
-        }
-        // Render Post-Renderables
-        {
-            auto& lst = GetPostRenderables();
-            for ( auto& p : lst )
+            if ( bBounds && !renderer->IsVisible( rect.x, rect.y, rect.w, rect.h ) )
             {
-                #ifdef DEBUG
-                p.second->RenderDebug( renderer );
-                #else
-                p.second->Render( renderer );
-                #endif
+                ++m_nCulled;
+                continue;
             }
+            ++m_nDrawn;
+            #ifdef DEBUG
+            p.second->RenderDebug( renderer );
+            #else
+            p.second->Render( renderer );
+            #endif
         }
     }
 
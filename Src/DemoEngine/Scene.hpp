@@ -106,6 +106,14 @@ namespace DemoEngine {
             inline Uint8 GetAlpha() { return m_iAlpha; }
             inline void SetAlpha( Uint8 a ) { m_iAlpha = a; }
 
+            // Renderables drawn and skipped as outside the screen by the last Render
+            inline unsigned int GetDrawnCount() const { return m_nDrawn; }
+            inline unsigned int GetCulledCount() const { return m_nCulled; }
+
+            // Scenes that draw mostly static screens can opt in to partial screen updates
+            inline bool UsesDirtyRectangles() { return m_bDirtyRectangles; }
+            inline void SetDirtyRectangles( bool bEnabled ) { m_bDirtyRectangles = bEnabled; }
+
             inline void SetID( SCENEID_t id ) { m_iSceneID = id; }
             inline SCENEID_t GetID() { return m_iSceneID; }
 
@@ -134,14 +142,19 @@ namespace DemoEngine {
 
         protected:
         private:
+            void RenderList( unique_ptr<CRenderer>& renderer, RenderableList_t& lst );
+
             RenderableList_t m_umapPreRenderables = {};
             RenderableList_t m_umapRenderables = {};
             RenderableList_t m_umapPostRenderables = {};
             UpdateableList_t m_umapUpdateables = {};
             bool m_bIsRunning = false;
             bool m_bIsLoaded = false;
+            bool m_bDirtyRectangles = false;
             SCENEID_t m_iSceneID = 0;
             Uint8 m_iAlpha = 255;
+            unsigned int m_nDrawn = 0;
+            unsigned int m_nCulled = 0;
     };
 
 }
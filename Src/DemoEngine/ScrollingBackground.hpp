@@ -58,32 +58,12 @@ namespace DemoEngine {
             void Render( unique_ptr<CRenderer>& renderer, int x0, int y0)
             {
                 auto& m_pImage = CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( m_imgResourceId );
-                int iImageHeight = m_pImage->GetSurface()->h;
-                int iImageWidth = m_pImage->GetSurface()->w;
-                int iScreenHeight = renderer->GetScreen()->h;
-                int iScreenWidth = renderer->GetScreen()->w;
-
                 int xStart = m_xSpeed == 0 ? -x0 : -x0/m_xSpeed;
                 int yStart = m_ySpeed == 0 ? -y0 : -y0/m_ySpeed;
 
-                // Module is your friend ;)
-                xStart = xStart % iImageWidth;
-                yStart = yStart % iImageHeight;
-
-                if ( xStart > 0 )
-                    xStart -= iImageWidth;
-
-                if ( yStart > 0 )
-                    yStart -= iImageHeight;
-
-                // Fill screen
-                for ( int y = yStart; y < iScreenHeight; y+= iImageHeight )
-                {
-                    for ( int x = xStart; x < iScreenWidth; x+= iImageWidth )
-                    {
-                        renderer->Render( m_pImage, x, y );
-                    }
-                }
+                // Fill screen in one pass, the renderer wraps the image around
+                SDL_Rect rect = { 0, 0, (Uint16)renderer->GetScreen()->w, (Uint16)renderer->GetScreen()->h };
+                renderer->RenderTiled( m_pImage, rect, -xStart, -yStart );
             }
 
             void SetSpeed( int xspeed, int yspeed )
@@ -0,0 +1,252 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <SDL_image.h>
+#include "ShadowedSprite.hpp"
+#include "AlphaBlitter.hpp"
+
+namespace DemoEngine {
+
+    namespace {
+
+        /** \brief a * b / 255 rounded
+         */
+        inline Uint32 Multiply255( Uint32 a, Uint32 b )
+        {
+            Uint32 x = a * b + 128;
+            return ( ( x + ( x >> 8 ) ) >> 8 );
+        }
+
+    }
+
+    /** \brief Loads the sprite and shadow images and builds the frames from them
+     *
+     * \param szSprite const char*
+     * \param szShadow const char*
+     * \param iShadowX int - Shadow position from the top left corner of the sprite.
+     * \param iShadowY int
+     * \param alpha Uint8 - Alpha the shadow was drawn with.
+     * \param vRects const vector<SDL_Rect>& - Frames in the sprite image, empty for one frame of the whole image.
+     * \param vShadowRects const vector<SDL_Rect>& - Frames in the shadow image, the whole image if missing.
+     * \return void
+     *
+     */
+    void CShadowedSprite::Build( const char *szSprite, const char *szShadow, int iShadowX, int iShadowY, Uint8 alpha,
+                                 const vector<SDL_Rect>& vRects, const vector<SDL_Rect>& vShadowRects ) throw( runtime_error )
+    {
+        #ifdef DEBUG
+        cout << "CShadowedSprite::Build( \"" << szSprite << "\", \"" << szShadow << "\" )" << endl;
+        #endif
+        SDL_Surface* pSprite = IMG_Load( szSprite );
+        if ( pSprite == nullptr ) {
+            throw ( runtime_error( "CShadowedSprite::Cannot load image: " + std::string(szSprite) ) );
+        }
+        SDL_Surface* pShadow = IMG_Load( szShadow );
+        if ( pShadow == nullptr ) {
+            SDL_FreeSurface( pSprite );
+            throw ( runtime_error( "CShadowedSprite::Cannot load image: " + std::string(szShadow) ) );
+        }
+        try {
+            Build( pSprite, pShadow, iShadowX, iShadowY, alpha, vRects, vShadowRects );
+        }
+        catch ( ... ) {
+            SDL_FreeSurface( pSprite );
+            SDL_FreeSurface( pShadow );
+            throw;
+        }
+        SDL_FreeSurface( pSprite );
+        SDL_FreeSurface( pShadow );
+    }
+
+    /** \brief Builds the frames from the sprite and shadow surfaces
+     *
+     * The surfaces must not be premultiplied (images converted by CImageAlpha can be).
+     *
+     * \param pSprite SDL_Surface*
+     * \param pShadow SDL_Surface*
+     * \param iShadowX int - Shadow position from the top left corner of the sprite.
+     * \param iShadowY int
+     * \param alpha Uint8 - Alpha the shadow was drawn with.
+     * \param vRects const vector<SDL_Rect>& - Frames in the sprite image, empty for one frame of the whole image.
+     * \param vShadowRects const vector<SDL_Rect>& - Frames in the shadow image, the whole image if missing.
+     * \return void
+     *
+     */
+    void CShadowedSprite::Build( SDL_Surface* pSprite, SDL_Surface* pShadow, int iShadowX, int iShadowY, Uint8 alpha,
+                                 const vector<SDL_Rect>& vRects, const vector<SDL_Rect>& vShadowRects ) throw( runtime_error )
+    {
+        Release();
+        if ( pSprite == nullptr || pShadow == nullptr ) return;
+        m_iSpriteX = std::max( 0, -iShadowX );
+        m_iSpriteY = std::max( 0, -iShadowY );
+        size_t nFrames = std::max( vRects.size(), (size_t)1 );
+        for ( size_t n = 0; n < nFrames; ++n ) {
+            SDL_Surface* pMask = Copy( pShadow, ( n < vShadowRects.size() ? &vShadowRects[n] : nullptr ) );
+            BakeMask( pMask, alpha );
+            SDL_Surface* pFrame = nullptr;
+            try {
+                SDL_Surface* pCopy = Copy( pSprite, ( n < vRects.size() ? &vRects[n] : nullptr ) );
+                pFrame = Combine( pCopy, pMask, iShadowX, iShadowY );
+                SDL_FreeSurface( pCopy );
+            }
+            catch ( ... ) {
+                SDL_FreeSurface( pMask );
+                throw;
+            }
+            SDL_FreeSurface( pMask );
+            m_vFrames.push_back( CreateImage( pFrame ) );
+        }
+    }
+
+    void CShadowedSprite::Release()
+    {
+        m_vFrames.clear();
+        m_iSpriteX = 0;
+        m_iSpriteY = 0;
+    }
+
+    void CShadowedSprite::AddTo( CSpriteAtlas& atlas )
+    {
+        for ( auto& pFrame : m_vFrames )
+            atlas.Add( pFrame );
+    }
+
+    /** \brief Copies a surface (or a part of it) into a new premultiplied 32-bit surface
+     *
+     * The alpha channel is copied as is, the per-surface alpha of the source is left out.
+     *
+     * \param pSource SDL_Surface*
+     * \param pRect const SDL_Rect* - nullptr for the whole surface.
+     * \return SDL_Surface* - Owned by the caller.
+     *
+     */
+    SDL_Surface* CShadowedSprite::Copy( SDL_Surface* pSource, const SDL_Rect* pRect ) throw( runtime_error )
+    {
+        SDL_Rect src = { 0, 0, (Uint16)pSource->w, (Uint16)pSource->h };
+        if ( pRect != nullptr ) src = *pRect;
+        SDL_Surface* pCopy = SDL_CreateRGBSurface( SDL_SWSURFACE, src.w, src.h, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+        if ( pCopy == nullptr )
+            throw runtime_error( std::string( SDL_GetError() ) );
+        // The alpha channel is copied when the blit doesn't blend
+        Uint32 nFlags = pSource->flags & ( SDL_SRCALPHA | SDL_RLEACCEL );
+        Uint8 alpha = pSource->format->alpha;
+        SDL_SetAlpha( pSource, 0, 0 );
+        SDL_BlitSurface( pSource, &src, pCopy, nullptr );
+        SDL_SetAlpha( pSource, nFlags, alpha );
+        CAlphaBlitter::Premultiply( pCopy );
+        return pCopy;
+    }
+
+    /** \brief Bakes the alpha a shadow is drawn with into its premultiplied pixels
+     *
+     * \param pShadow SDL_Surface* - Premultiplied 32-bit surface, see Copy.
+     * \param alpha Uint8
+     * \return void
+     *
+     */
+    void CShadowedSprite::BakeMask( SDL_Surface* pShadow, Uint8 alpha )
+    {
+        if ( alpha == 255 ) return;
+        Uint8* pRow = (Uint8*)pShadow->pixels;
+        for ( int y = 0; y < pShadow->h; ++y, pRow += pShadow->pitch ) {
+            Uint32* p = (Uint32*)pRow;
+            for ( int x = 0; x < pShadow->w; ++x ) {
+                Uint32 c = 0;
+                for ( int shift = 0; shift < 32; shift += 8 )
+                    c |= Multiply255( ( p[x] >> shift ) & 0xff, alpha ) << shift;
+                p[x] = c;
+            }
+        }
+    }
+
+    /** \brief Draws a sprite over its shadow into a new surface large enough for both
+     *
+     * The sprite is at ( max( 0, -iMaskX ), max( 0, -iMaskY ) ) in the new surface.
+     *
+     * \param pSprite SDL_Surface* - Premultiplied 32-bit surface, see Copy.
+     * \param pMask SDL_Surface* - Premultiplied 32-bit surface with the shadow alpha baked in, see BakeMask.
+     * \param iMaskX int - Shadow position from the top left corner of the sprite.
+     * \param iMaskY int
+     * \return SDL_Surface* - Premultiplied, owned by the caller.
+     *
+     */
+    SDL_Surface* CShadowedSprite::Combine( SDL_Surface* pSprite, SDL_Surface* pMask, int iMaskX, int iMaskY ) throw( runtime_error )
+    {
+        int iLeft = std::min( 0, iMaskX );
+        int iTop = std::min( 0, iMaskY );
+        int w = std::max( pSprite->w, iMaskX + pMask->w ) - iLeft;
+        int h = std::max( pSprite->h, iMaskY + pMask->h ) - iTop;
+        SDL_Surface* pCombined = SDL_CreateRGBSurface( SDL_SWSURFACE, w, h, 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+        if ( pCombined == nullptr )
+            throw runtime_error( std::string( SDL_GetError() ) );
+        SDL_FillRect( pCombined, nullptr, 0 );
+
+        // Shadow rows are copied, the sprite is drawn over them
+        Uint8* pBase = (Uint8*)pCombined->pixels;
+        for ( int y = 0; y < pMask->h; ++y ) {
+            Uint32* dst = (Uint32*)( pBase + ( iMaskY - iTop + y ) * pCombined->pitch ) + ( iMaskX - iLeft );
+            memcpy( dst, (Uint8*)pMask->pixels + y * pMask->pitch, pMask->w * 4 );
+        }
+        for ( int y = 0; y < pSprite->h; ++y ) {
+            Uint32* dst = (Uint32*)( pBase + ( y - iTop ) * pCombined->pitch ) - iLeft;
+            const Uint32* src = (const Uint32*)( (Uint8*)pSprite->pixels + y * pSprite->pitch );
+            for ( int x = 0; x < pSprite->w; ++x ) {
+                Uint32 s = src[x];
+                Uint32 inverse = 255 - ( s >> 24 );
+                if ( inverse == 0 || dst[x] == 0 ) {
+                    if ( s != 0 ) dst[x] = s;
+                    continue;
+                }
+                Uint32 c = 0;
+                for ( int shift = 0; shift < 32; shift += 8 )
+                    c |= ( ( ( s >> shift ) & 0xff ) + Multiply255( ( dst[x] >> shift ) & 0xff, inverse ) ) << shift;
+                dst[x] = c;
+            }
+        }
+        return pCombined;
+    }
+
+    /** \brief Wraps a premultiplied surface into an image
+     *
+     * The surface is converted back to straight alpha, CImageAlpha premultiplies it again
+     * when converted to the display format (right away if the video mode is set).
+     *
+     * \param pSurface SDL_Surface* - Owned by the image.
+     * \return unique_ptr<CImageAlpha>
+     *
+     */
+    unique_ptr<CImageAlpha> CShadowedSprite::CreateImage( SDL_Surface* pSurface )
+    {
+        CAlphaBlitter::Unpremultiply( pSurface );
+        unique_ptr<CImageAlpha> pImage( new CImageAlpha );
+        pImage->SetSurface( pSurface );
+        if ( SDL_GetVideoSurface() != NULL )
+            pImage->ConvertToDisplayFormat();
+        return pImage;
+    }
+
+}
@@ -0,0 +1,88 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+#ifndef SHADOWEDSPRITE_HPP
+#define SHADOWEDSPRITE_HPP
+
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include <SDL.h>
+#include "Singleton.hpp"
+#include "ResourceFactory.hpp"
+#include "ImageAlpha.hpp"
+#include "SpriteAtlas.hpp"
+
+namespace DemoEngine {
+
+    using std::unique_ptr;
+    using std::vector;
+    using std::runtime_error;
+
+    /// Sprite frames with their drop shadow baked in at load time, for sprites whose shadow is
+    /// always at the same offset. The shadow alpha is baked into the shadow pixels and the sprite
+    /// is composited over it, so a shadowed sprite is drawn with a single blit (on the sprite's
+    /// layer, so the shadow can fall over sprites drawn before it).
+    class CShadowedSprite
+    {
+        public:
+            CShadowedSprite() : m_vFrames() {};
+            virtual ~CShadowedSprite() {};
+
+            void Build( const char *szSprite, const char *szShadow, int iShadowX, int iShadowY, Uint8 alpha,
+                        const vector<SDL_Rect>& vRects = vector<SDL_Rect>(), const vector<SDL_Rect>& vShadowRects = vector<SDL_Rect>() ) throw( runtime_error );
+            void Build( SDL_Surface* pSprite, SDL_Surface* pShadow, int iShadowX, int iShadowY, Uint8 alpha,
+                        const vector<SDL_Rect>& vRects = vector<SDL_Rect>(), const vector<SDL_Rect>& vShadowRects = vector<SDL_Rect>() ) throw( runtime_error );
+            void Release();
+
+            inline CImageAlpha* Get( size_t nFrame ) const { return ( nFrame < m_vFrames.size() ? m_vFrames[nFrame].get() : nullptr ); }
+            inline size_t Count() const { return m_vFrames.size(); }
+            inline bool IsEmpty() const { return m_vFrames.empty(); }
+            // Position of the sprite inside the frames, draw the frame this much up and left from the sprite
+            inline int GetSpriteX() const { return m_iSpriteX; }
+            inline int GetSpriteY() const { return m_iSpriteY; }
+
+            // Adds every frame to the atlas, packed on its next Pack() call
+            void AddTo( CSpriteAtlas& atlas );
+
+            // Load time helpers, the surfaces are premultiplied 32-bit with the alpha in the top byte
+            static SDL_Surface* Copy( SDL_Surface* pSource, const SDL_Rect* pRect = nullptr ) throw( runtime_error );
+            static void BakeMask( SDL_Surface* pShadow, Uint8 alpha );
+            static SDL_Surface* Combine( SDL_Surface* pSprite, SDL_Surface* pMask, int iMaskX, int iMaskY ) throw( runtime_error );
+            static unique_ptr<CImageAlpha> CreateImage( SDL_Surface* pSurface );
+
+            CShadowedSprite(const CShadowedSprite& other)=delete;
+            CShadowedSprite& operator=(const CShadowedSprite& other)=delete;
+        protected:
+        private:
+            vector<unique_ptr<CImageAlpha>> m_vFrames;
+            int m_iSpriteX = 0;
+            int m_iSpriteY = 0;
+    };
+
+    typedef CSingleton<CResourceFactory<int, CShadowedSprite>> ShadowedSpriteFactory;
+
+}
+
+#endif // SHADOWEDSPRITE_HPP
@@ -0,0 +1,164 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef SKYLINEPACKER_HPP
+#define SKYLINEPACKER_HPP
+
+#include <vector>
+#include <limits>
+#include <SDL.h>
+
+namespace DemoEngine {
+
+    using std::vector;
+
+    /// Packs rectangles into a fixed size area using the skyline bottom-left heuristic.
+    /// The skyline is the upper edge of the packed rectangles, each new rectangle is placed
+    /// where its top edge ends up lowest (ties broken by the narrowest skyline segment).
+    class CSkylinePacker
+    {
+        public:
+            CSkylinePacker( int w, int h ) : m_vSkyline(), m_iWidth( w ), m_iHeight( h ) {
+                Clear();
+            }
+            ~CSkylinePacker() {};
+
+            void Clear()
+            {
+                m_vSkyline.clear();
+                m_vSkyline.push_back( { 0, 0, m_iWidth } );
+                m_nUsedArea = 0;
+            }
+
+            /** \brief Finds a place for a rectangle and adds it to the packed area.
+             *
+             * \param w int
+             * \param h int
+             * \param rect SDL_Rect& - Receives the position (and size) of the rectangle.
+             * \return bool - false if the rectangle does not fit anymore.
+             *
+             */
+            bool Insert( int w, int h, SDL_Rect& rect )
+            {
+                int iBestTop = std::numeric_limits<int>::max();
+                int iBestWidth = std::numeric_limits<int>::max();
+                int iBestIndex = -1;
+                int iBestX = 0;
+                for ( size_t i = 0; i < m_vSkyline.size(); ++i )
+                {
+                    int y;
+                    if ( !Fits( i, w, h, y ) ) continue;
+                    if ( y + h < iBestTop || ( y + h == iBestTop && m_vSkyline[i].w < iBestWidth ) )
+                    {
+                        iBestTop = y + h;
+                        iBestWidth = m_vSkyline[i].w;
+                        iBestIndex = (int)i;
+                        iBestX = m_vSkyline[i].x;
+                    }
+                }
+                if ( iBestIndex < 0 ) return false;
+
+                rect.x = (Sint16)iBestX;
+                rect.y = (Sint16)( iBestTop - h );
+                rect.w = (Uint16)w;
+                rect.h = (Uint16)h;
+                AddLevel( iBestIndex, iBestX, iBestTop, w );
+                m_nUsedArea += (long)w * h;
+                return true;
+            }
+
+            /** \brief Returns the used fraction of the area (0..1)
+             */
+            inline float Occupancy() const { return m_nUsedArea / (float)( (long)m_iWidth * m_iHeight ); }
+
+        protected:
+        private:
+            typedef struct {
+                int x;
+                int y;
+                int w;
+            } Node_t;
+
+            // Checks if a rectangle fits with its left edge at the start of skyline node i.
+            // y receives the height it would be placed at.
+            bool Fits( size_t i, int w, int h, int& y ) const
+            {
+                int x = m_vSkyline[i].x;
+                if ( x + w > m_iWidth ) return false;
+                int iWidthLeft = w;
+                y = m_vSkyline[i].y;
+                while ( iWidthLeft > 0 )
+                {
+                    if ( i >= m_vSkyline.size() ) return false;
+                    if ( m_vSkyline[i].y > y ) y = m_vSkyline[i].y;
+                    if ( y + h > m_iHeight ) return false;
+                    iWidthLeft -= m_vSkyline[i].w;
+                    ++i;
+                }
+                return true;
+            }
+
+            // Raises the skyline under a newly placed rectangle
+            void AddLevel( int iIndex, int x, int y, int w )
+            {
+                m_vSkyline.insert( m_vSkyline.begin() + iIndex, { x, y, w } );
+
+                // Shrink or remove the nodes now covered by the new one
+                for ( size_t i = iIndex + 1; i < m_vSkyline.size(); )
+                {
+                    Node_t& prev = m_vSkyline[i-1];
+                    Node_t& node = m_vSkyline[i];
+                    if ( node.x >= prev.x + prev.w ) break;
+                    int iShrink = prev.x + prev.w - node.x;
+                    node.x += iShrink;
+                    node.w -= iShrink;
+                    if ( node.w > 0 ) break;
+                    m_vSkyline.erase( m_vSkyline.begin() + i );
+                }
+
+                // Merge neighbours at the same height
+                for ( size_t i = 0; i + 1 < m_vSkyline.size(); )
+                {
+                    if ( m_vSkyline[i].y == m_vSkyline[i+1].y )
+                    {
+                        m_vSkyline[i].w += m_vSkyline[i+1].w;
+                        m_vSkyline.erase( m_vSkyline.begin() + i + 1 );
+                    }
+                    else
+                    {
+                        ++i;
+                    }
+                }
+            }
+
+            vector<Node_t> m_vSkyline;
+            int m_iWidth;
+            int m_iHeight;
+            long m_nUsedArea = 0;
+    };
+
+}
+
+#endif // SKYLINEPACKER_HPP
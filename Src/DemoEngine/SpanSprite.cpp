@@ -0,0 +1,135 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include "SpanSprite.hpp"
+
+namespace DemoEngine {
+
+    /** \brief Encodes the surface into spans
+     *
+     * Supports 32-bit surfaces with the alpha in the top byte (per-pixel alpha) and
+     * 32-bit colorkey surfaces without alpha. The colorkey surface must have its colorkey set.
+     *
+     * \param pSurface SDL_Surface*
+     * \return bool - false if the format is not supported (the sprite is left empty).
+     *
+     */
+    bool CSpanSprite::Build( SDL_Surface* pSurface )
+    {
+        Clear();
+        const SDL_PixelFormat* format = pSurface->format;
+        if ( format->BytesPerPixel != 4 || SDL_MUSTLOCK( pSurface ) ) return false;
+        if ( format->Amask == 0xff000000 ) {
+            m_bColorkey = false;
+        } else if ( format->Amask == 0 && ( pSurface->flags & SDL_SRCCOLORKEY ) ) {
+            m_bColorkey = true;
+            m_nColorkey = format->colorkey & 0xffffff;
+        } else {
+            return false;
+        }
+
+        // Type of a pixel: -1 transparent, otherwise SPANTYPE
+        auto type = [this]( Uint32 p ) -> int {
+            if ( m_bColorkey ) return ( ( p & 0xffffff ) == m_nColorkey ? -1 : SPAN_OPAQUE );
+            Uint32 a = p >> 24;
+            return ( a == 0 ? -1 : ( a == 255 ? SPAN_OPAQUE : SPAN_BLEND ) );
+        };
+
+        m_iWidth = m_iSurfaceWidth = pSurface->w;
+        m_iHeight = m_iSurfaceHeight = pSurface->h;
+        m_vRows.reserve( m_iHeight + 1 );
+        for ( int y = 0; y < m_iHeight; ++y ) {
+            const Uint32* pRow = (const Uint32*)( (const Uint8*)pSurface->pixels + y * pSurface->pitch );
+            m_vRows.push_back( (Uint32)m_vSpans.size() );
+            int x = 0;
+            while ( x < m_iWidth ) {
+                int iType = type( pRow[x] );
+                int iStart = x;
+                while ( x < m_iWidth && type( pRow[x] ) == iType ) ++x;
+                if ( iType >= 0 ) AddSpan( iStart, x - iStart, iType, pRow );
+            }
+        }
+        m_vRows.push_back( (Uint32)m_vSpans.size() );
+        return true;
+    }
+
+    /** \brief Moves the spans to a rect of another surface with the same pixels
+     *
+     * The spans then match that surface and are drawn with source rects inside
+     * ( x, y, GetWidth(), GetHeight() ) of it, like a sprite in an atlas page.
+     *
+     * \param pSurface SDL_Surface*
+     * \param x int - Position of the sprite in the surface.
+     * \param y int
+     * \return void
+     *
+     */
+    void CSpanSprite::Rebase( SDL_Surface* pSurface, int x, int y )
+    {
+        m_iX = x;
+        m_iY = y;
+        m_iSurfaceWidth = pSurface->w;
+        m_iSurfaceHeight = pSurface->h;
+    }
+
+    void CSpanSprite::Clear()
+    {
+        m_vSpans.clear();
+        m_vRows.clear();
+        m_vPixels.clear();
+        m_iWidth = m_iHeight = 0;
+        m_iX = m_iY = 0;
+        m_iSurfaceWidth = m_iSurfaceHeight = 0;
+        m_bColorkey = false;
+        m_nColorkey = 0;
+    }
+
+    /** \brief Checks that the spans were built for the surface as it is now
+     *
+     * \param pSurface SDL_Surface*
+     * \return bool - false if the size (of the surface the spans were rebased to) or the colorkey have changed.
+     *
+     */
+    bool CSpanSprite::Matches( SDL_Surface* pSurface ) const
+    {
+        if ( IsEmpty() || pSurface->w != m_iSurfaceWidth || pSurface->h != m_iSurfaceHeight ) return false;
+        if ( m_bColorkey ) return ( ( pSurface->flags & SDL_SRCCOLORKEY ) && ( pSurface->format->colorkey & 0xffffff ) == m_nColorkey );
+        return ( pSurface->format->Amask == 0xff000000 );
+    }
+
+    void CSpanSprite::AddSpan( int x, int w, Uint32 iType, const Uint32* pRow )
+    {
+        // Spans are limited to 16 bits, longer ones are split
+        while ( w > 0 ) {
+            int n = ( w > 0xffff ? 0xffff : w );
+            Span_t span = { (Uint16)x, (Uint16)n, iType, (Uint32)m_vPixels.size() };
+            m_vSpans.push_back( span );
+            m_vPixels.insert( m_vPixels.end(), pRow + x, pRow + x + n );
+            x += n;
+            w -= n;
+        }
+    }
+
+}
@@ -0,0 +1,101 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef SPANSPRITE_HPP
+#define SPANSPRITE_HPP
+
+#include <vector>
+#include <SDL.h>
+
+namespace DemoEngine {
+
+    using std::vector;
+
+    /// Run-length encoded copy of a 32-bit sprite. Every row is stored as a list of spans
+    /// that are either opaque (copied) or translucent (blended), transparent pixels are not
+    /// stored at all. Built from the display format surface when the image is converted
+    /// and drawn by CAlphaBlitter. Rebase moves the spans to a rect of another surface
+    /// holding the same pixels (a sprite atlas page).
+    class CSpanSprite
+    {
+        public:
+            typedef enum {
+                SPAN_OPAQUE = 0,
+                SPAN_BLEND
+            } SPANTYPE;
+
+            typedef struct {
+                Uint16 x;
+                Uint16 w;
+                Uint32 iType;
+                Uint32 nOffset;     // Index of the first pixel in the pixel array
+            } Span_t;
+
+            CSpanSprite() : m_vSpans(), m_vRows(), m_vPixels() {};
+            virtual ~CSpanSprite() {};
+
+            bool Build( SDL_Surface* pSurface );
+            void Rebase( SDL_Surface* pSurface, int x, int y );
+            void Clear();
+
+            inline bool IsEmpty() const { return m_vRows.empty(); }
+            inline int GetWidth() const { return m_iWidth; }
+            inline int GetHeight() const { return m_iHeight; }
+            // Position of the sprite in the surface it is drawn from
+            inline int GetX() const { return m_iX; }
+            inline int GetY() const { return m_iY; }
+            inline bool IsColorkey() const { return m_bColorkey; }
+            inline Uint32 GetColorkey() const { return m_nColorkey; }
+            // Spans of row y are [GetRowBegin(y), GetRowBegin(y+1))
+            inline Uint32 GetRowBegin( int y ) const { return m_vRows[y]; }
+            inline const Span_t& GetSpan( Uint32 n ) const { return m_vSpans[n]; }
+            inline const Uint32* GetPixels( Uint32 nOffset ) const { return &m_vPixels[nOffset]; }
+            // Share of the bounding box that is drawn (0..1)
+            inline float GetCoverage() const {
+                return ( m_iWidth * m_iHeight > 0 ? m_vPixels.size() / (float)( m_iWidth * m_iHeight ) : 0.0f );
+            }
+
+            bool Matches( SDL_Surface* pSurface ) const;
+
+        protected:
+        private:
+            void AddSpan( int x, int w, Uint32 iType, const Uint32* pRow );
+
+            vector<Span_t> m_vSpans;
+            vector<Uint32> m_vRows;
+            vector<Uint32> m_vPixels;
+            int m_iWidth = 0;
+            int m_iHeight = 0;
+            int m_iX = 0;
+            int m_iY = 0;
+            int m_iSurfaceWidth = 0;
+            int m_iSurfaceHeight = 0;
+            bool m_bColorkey = false;
+            Uint32 m_nColorkey = 0;
+    };
+
+}
+
+#endif // SPANSPRITE_HPP
@@ -0,0 +1,297 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef SPATIALGRID_HPP
+#define SPATIALGRID_HPP
+
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "Vector2.hpp"
+
+namespace DemoEngine
+{
+    using std::shared_ptr;
+    using std::vector;
+
+    /// Uniform grid for nearest target and radius queries.
+    /// The grid is meant to be cleared and filled again once per frame.
+    template<typename T>
+    class CSpatialGrid
+    {
+        public:
+            typedef shared_ptr<T> Item_t;
+
+            typedef struct {
+                Item_t item;
+                float fDistance2;       // squared distance to the query point
+            } Result_t;
+
+            CSpatialGrid( int iCellSize = 64 ) : m_vEntries(), m_vCells(), m_vCandidates(), m_vSingle(), m_iCellSize( iCellSize ) {};
+            ~CSpatialGrid() {};
+
+            /** \brief Sets the area covered by the grid and removes all entries.
+             *
+             * \param iWidth int - Width of the covered area in pixels.
+             * \param iHeight int - Height of the covered area in pixels.
+             * \return void
+             *
+             */
+            void Resize( int iWidth, int iHeight )
+            {
+                m_iCols = std::max( 1, (iWidth + m_iCellSize - 1) / m_iCellSize );
+                m_iRows = std::max( 1, (iHeight + m_iCellSize - 1) / m_iCellSize );
+                m_iWidth = iWidth;
+                m_iHeight = iHeight;
+                m_vCells.resize( m_iCols * m_iRows );
+                Clear();
+            }
+
+            /** \brief Removes all entries but keeps the allocated cells.
+             *
+             * \return void
+             *
+             */
+            void Clear()
+            {
+                for ( auto& cell : m_vCells ) {
+                    cell.clear();
+                }
+                m_vEntries.clear();
+            }
+
+            /** \brief Adds an item to the grid.
+             *
+             * \param item const Item_t& - Item to add.
+             * \param x float - Position of the item.
+             * \param y float - Position of the item.
+             * \return bool - false if the position is outside of the grid and the item was not added.
+             *
+             */
+            bool Insert( const Item_t& item, float x, float y )
+            {
+                if ( x < 0 || y < 0 || x >= m_iWidth || y >= m_iHeight ) {
+                    return false;
+                }
+                int nCell = CellIndex( static_cast<int>(x) / m_iCellSize, static_cast<int>(y) / m_iCellSize );
+                m_vCells[nCell].push_back( m_vEntries.size() );
+                m_vEntries.push_back( { item, x, y } );
+                return true;
+            }
+
+            inline size_t Count() const { return m_vEntries.size(); }
+
+            /** \brief Finds the k nearest items to a point.
+             *
+             * \param x float - Query position.
+             * \param y float - Query position.
+             * \param k size_t - Maximum number of results.
+             * \param vResults vector<Result_t>& - Results sorted by distance (closest first).
+             * \param fMaxRadius float - Items further away than this are ignored (<0 means no limit).
+             * \return size_t - Number of results found.
+             *
+             */
+            size_t KNearest( float x, float y, size_t k, vector<Result_t>& vResults, float fMaxRadius = -1.0f )
+            {
+                vResults.clear();
+                if ( k == 0 || m_vEntries.empty() ) {
+                    return 0;
+                }
+
+                float fMaxDistance2 = fMaxRadius < 0 ? -1.0f : fMaxRadius * fMaxRadius;
+
+                int cx = Clamp( static_cast<int>(x) / m_iCellSize, m_iCols );
+                int cy = Clamp( static_cast<int>(y) / m_iCellSize, m_iRows );
+                int iMaxRing = std::max( m_iCols, m_iRows );
+
+                // How far the query is outside the grid, the start cell is clamped to the edge
+                float fOutX = x < 0 ? -x : std::max( 0.0f, x - m_iWidth );
+                float fOutY = y < 0 ? -y : std::max( 0.0f, y - m_iHeight );
+
+                m_vCandidates.clear();
+                for ( int ring = 0; ring <= iMaxRing; ++ring ) {
+
+                    // Visit only the cells on the border of the current ring
+                    for ( int j = cy - ring; j <= cy + ring; ++j ) {
+                        if ( j < 0 || j >= m_iRows ) continue;
+                        bool bEdgeRow = ( j == cy - ring || j == cy + ring );
+                        int iStep = bEdgeRow ? 1 : ring * 2;
+                        for ( int i = cx - ring; i <= cx + ring; i += ( iStep > 0 ? iStep : 1 ) ) {
+                            if ( i < 0 || i >= m_iCols ) continue;
+                            for ( auto nEntry : m_vCells[CellIndex( i, j )] ) {
+                                const Entry_t& e = m_vEntries[nEntry];
+                                float dx = e.x - x;
+                                float dy = e.y - y;
+                                float d2 = dx*dx + dy*dy;
+                                if ( fMaxDistance2 >= 0 && d2 > fMaxDistance2 ) continue;
+                                AddCandidate( nEntry, d2, k );
+                            }
+                        }
+                    }
+
+                    // Cells outside this ring are at least ring*cellsize further away than the grid
+                    // edge on the x or the y axis, so we can stop once the k:th candidate is closer
+                    // than the nearer of the two.
+                    float fReach = static_cast<float>( ring * m_iCellSize );
+                    float fReach2 = std::min( (fOutX + fReach) * (fOutX + fReach) + fOutY * fOutY,
+                                              fOutX * fOutX + (fOutY + fReach) * (fOutY + fReach) );
+                    if ( m_vCandidates.size() == k && m_vCandidates.back().fDistance2 <= fReach2 ) {
+                        break;
+                    }
+                    if ( fMaxDistance2 >= 0 && fReach2 > fMaxDistance2 ) {
+                        break;
+                    }
+                }
+
+                for ( auto& c : m_vCandidates ) {
+                    vResults.push_back( { m_vEntries[c.nEntry].item, c.fDistance2 } );
+                }
+                return vResults.size();
+            }
+
+            /** \brief Finds the nearest item to a point.
+             *
+             * \param x float - Query position.
+             * \param y float - Query position.
+             * \param result Result_t& - Nearest item and its squared distance.
+             * \param fMaxRadius float - Items further away than this are ignored (<0 means no limit).
+             * \return bool - true if an item was found.
+             *
+             */
+            bool Nearest( float x, float y, Result_t& result, float fMaxRadius = -1.0f )
+            {
+                if ( KNearest( x, y, 1, m_vSingle, fMaxRadius ) == 0 ) {
+                    return false;
+                }
+                result = m_vSingle.front();
+                return true;
+            }
+
+            /** \brief Resolves the nearest item for many query points at once.
+             *
+             * \param vPositions const vector<CVector2f>& - Query positions.
+             * \param vResults vector<Result_t>& - One result per query, item is nullptr if nothing was found.
+             * \param fMaxRadius float - Items further away than this are ignored (<0 means no limit).
+             * \return size_t - Number of queries that found a target.
+             *
+             */
+            size_t NearestBatch( const vector<CVector2f>& vPositions, vector<Result_t>& vResults, float fMaxRadius = -1.0f )
+            {
+                size_t nFound = 0;
+                vResults.resize( vPositions.size() );
+                for ( size_t n = 0; n < vPositions.size(); ++n ) {
+                    if ( Nearest( vPositions[n][0], vPositions[n][1], vResults[n], fMaxRadius ) ) {
+                        nFound++;
+                    } else {
+                        vResults[n].item = nullptr;
+                        vResults[n].fDistance2 = -1.0f;
+                    }
+                }
+                return nFound;
+            }
+
+            /** \brief Finds all items inside a circle.
+             *
+             * \param x float - Center of the circle.
+             * \param y float - Center of the circle.
+             * \param fRadius float - Radius of the circle.
+             * \param vResults vector<Result_t>& - Items inside the circle (unordered).
+             * \return size_t - Number of results found.
+             *
+             */
+            size_t Radius( float x, float y, float fRadius, vector<Result_t>& vResults )
+            {
+                vResults.clear();
+                if ( m_vEntries.empty() || fRadius < 0 ) {
+                    return 0;
+                }
+
+                float fRadius2 = fRadius * fRadius;
+                int x0 = Clamp( static_cast<int>( std::floor( (x - fRadius) / m_iCellSize ) ), m_iCols );
+                int x1 = Clamp( static_cast<int>( std::floor( (x + fRadius) / m_iCellSize ) ), m_iCols );
+                int y0 = Clamp( static_cast<int>( std::floor( (y - fRadius) / m_iCellSize ) ), m_iRows );
+                int y1 = Clamp( static_cast<int>( std::floor( (y + fRadius) / m_iCellSize ) ), m_iRows );
+
+                for ( int j = y0; j <= y1; ++j ) {
+                    for ( int i = x0; i <= x1; ++i ) {
+                        for ( auto nEntry : m_vCells[CellIndex( i, j )] ) {
+                            const Entry_t& e = m_vEntries[nEntry];
+                            float dx = e.x - x;
+                            float dy = e.y - y;
+                            float d2 = dx*dx + dy*dy;
+                            if ( d2 <= fRadius2 ) {
+                                vResults.push_back( { e.item, d2 } );
+                            }
+                        }
+                    }
+                }
+                return vResults.size();
+            }
+
+        protected:
+        private:
+            typedef struct {
+                Item_t item;
+                float x;
+                float y;
+            } Entry_t;
+
+            typedef struct {
+                size_t nEntry;
+                float fDistance2;
+            } Candidate_t;
+
+            inline int CellIndex( int i, int j ) const { return j * m_iCols + i; }
+            inline int Clamp( int i, int n ) const { return i < 0 ? 0 : ( i >= n ? n-1 : i ); }
+
+            // Keeps m_vCandidates sorted and at most k long
+            void AddCandidate( size_t nEntry, float d2, size_t k )
+            {
+                if ( m_vCandidates.size() == k && d2 >= m_vCandidates.back().fDistance2 ) {
+                    return;
+                }
+                Candidate_t c = { nEntry, d2 };
+                auto it = std::upper_bound( m_vCandidates.begin(), m_vCandidates.end(), c,
+                    []( const Candidate_t& a, const Candidate_t& b ) { return a.fDistance2 < b.fDistance2; } );
+                m_vCandidates.insert( it, c );
+                if ( m_vCandidates.size() > k ) {
+                    m_vCandidates.pop_back();
+                }
+            }
+
+            vector<Entry_t> m_vEntries;
+            vector<vector<size_t>> m_vCells;
+            vector<Candidate_t> m_vCandidates;
+            vector<Result_t> m_vSingle;
+            int m_iCellSize = 64;
+            int m_iCols = 1;
+            int m_iRows = 1;
+            int m_iWidth = 0;
+            int m_iHeight = 0;
+    };
+}
+
+#endif // SPATIALGRID_HPP
@@ -0,0 +1,136 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include "SpriteAtlas.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace DemoEngine {
+
+    using std::cout;
+    using std::endl;
+
+    CSpriteAtlas::CSpriteAtlas( int iPageWidth, int iPageHeight ) :
+        m_vImages(), m_vPages(), m_vOccupancy(), m_iPageWidth( iPageWidth ), m_iPageHeight( iPageHeight ) {
+    }
+
+    /** \brief Adds an image to be packed on the next Pack() call
+     *
+     * Only images with per-pixel alpha and no colorkey are accepted, they must all share
+     * the same pixel format and be at most half of the page size in both directions.
+     *
+     * \param pImage CImage*
+     * \return bool - false if the image was not accepted (it is left as is).
+     *
+     */
+    bool CSpriteAtlas::Add( CImage* pImage )
+    {
+        if ( pImage == nullptr || pImage->IsInAtlas() ) return false;
+        SDL_Surface* pSurface = pImage->GetSurface();
+        if ( pSurface == nullptr ) return false;
+        if ( pSurface->format->Amask == 0 || ( pSurface->flags & SDL_SRCCOLORKEY ) ) return false;
+        if ( pSurface->w > m_iPageWidth / 2 || pSurface->h > m_iPageHeight / 2 ) return false;
+        if ( !m_vImages.empty() && !IsSameFormat( pSurface->format, m_vImages.front()->GetSurface()->format ) ) return false;
+        if ( std::find( m_vImages.begin(), m_vImages.end(), pImage ) != m_vImages.end() ) return false;
+        m_vImages.push_back( pImage );
+        return true;
+    }
+
+    /** \brief Packs the added images into pages and moves them there
+     *
+     * \return void
+     *
+     * \throw runtime_error if a page could not be created
+     *
+     */
+    void CSpriteAtlas::Pack() throw( runtime_error )
+    {
+        if ( m_vImages.empty() ) return;
+
+        // Tallest first packs best with the skyline heuristic
+        vector<CImage*> vSorted( m_vImages );
+        std::stable_sort( vSorted.begin(), vSorted.end(), []( CImage* a, CImage* b ) {
+            if ( a->GetSurface()->h != b->GetSurface()->h ) return a->GetSurface()->h > b->GetSurface()->h;
+            return a->GetSurface()->w > b->GetSurface()->w;
+        });
+
+        SDL_PixelFormat format = *vSorted.front()->GetSurface()->format;
+        vector<CSkylinePacker> vPackers;
+        for ( auto pImage : vSorted )
+        {
+            SDL_Surface* pSurface = pImage->GetSurface();
+            SDL_Rect rect;
+            size_t nPage = 0;
+            while ( nPage < vPackers.size() && !vPackers[nPage].Insert( pSurface->w, pSurface->h, rect ) )
+                ++nPage;
+            if ( nPage == vPackers.size() )
+            {
+                auto pPage = SDL_CreateRGBSurface( SDL_SWSURFACE, m_iPageWidth, m_iPageHeight, format.BitsPerPixel,
+                                                   format.Rmask, format.Gmask, format.Bmask, format.Amask );
+                if ( pPage == NULL ) {
+                    throw ( runtime_error( "CSpriteAtlas::Cannot create atlas page: " + std::string(SDL_GetError()) ) );
+                }
+                m_vPages.push_back( std::make_shared<CSurface>() );
+                m_vPages.back()->SetSurfacePointer( pPage );
+                vPackers.push_back( CSkylinePacker( m_iPageWidth, m_iPageHeight ) );
+                vPackers.back().Insert( pSurface->w, pSurface->h, rect );
+            }
+
+            // Copy the pixels as they are (alpha channel included) and move the image to the page
+            Uint32 nAlphaFlags = pSurface->flags & SDL_SRCALPHA;
+            Uint8 cAlpha = pSurface->format->alpha;
+            SDL_SetAlpha( pSurface, 0, 0 );
+            SDL_Rect dst = rect;
+            SDL_BlitSurface( pSurface, NULL, m_vPages[nPage]->GetSurfacePointer(), &dst );
+            SDL_SetAlpha( pSurface, nAlphaFlags, cAlpha );
+            pImage->SetAtlasPage( m_vPages[nPage], rect );
+        }
+
+        m_vOccupancy.clear();
+        for ( auto& packer : vPackers )
+            m_vOccupancy.push_back( packer.Occupancy() );
+    }
+
+    SDL_Surface* CSpriteAtlas::GetPage( size_t nPage ) const
+    {
+        return ( nPage < m_vPages.size() ? m_vPages[nPage]->GetSurfacePointer() : nullptr );
+    }
+
+    void CSpriteAtlas::Print() const
+    {
+        cout << "Sprite atlas: " << m_vImages.size() << " images in " << m_vPages.size() << " pages of "
+             << m_iPageWidth << "x" << m_iPageHeight;
+        for ( size_t i = 0; i < m_vOccupancy.size(); ++i )
+            cout << ( i == 0 ? " (" : ", " ) << (int)( m_vOccupancy[i] * 100 ) << "%" << ( i + 1 == m_vOccupancy.size() ? " used)" : "" );
+        cout << endl;
+    }
+
+    bool CSpriteAtlas::IsSameFormat( const SDL_PixelFormat* a, const SDL_PixelFormat* b ) const
+    {
+        return ( a->BitsPerPixel == b->BitsPerPixel &&
+                 a->Rmask == b->Rmask && a->Gmask == b->Gmask && a->Bmask == b->Bmask && a->Amask == b->Amask );
+    }
+
+}
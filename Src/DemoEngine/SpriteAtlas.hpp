@@ -0,0 +1,78 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef SPRITEATLAS_HPP
+#define SPRITEATLAS_HPP
+
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include <SDL.h>
+#include "Image.hpp"
+#include "Surface.hpp"
+#include "SkylinePacker.hpp"
+
+namespace DemoEngine {
+
+    using std::unique_ptr;
+    using std::shared_ptr;
+    using std::vector;
+    using std::runtime_error;
+
+    /// Packs small images into a few large atlas pages at load time.
+    /// Packed images are blitted from the shared page with their atlas rect as the source,
+    /// resource IDs, sizes and sub-rect blits stay as they were.
+    class CSpriteAtlas
+    {
+        public:
+            CSpriteAtlas( int iPageWidth = 512, int iPageHeight = 512 );
+            virtual ~CSpriteAtlas() {};
+
+            bool Add( CImage* pImage );
+            template<typename T> bool Add( unique_ptr<T>& pImage ) { return Add( pImage.get() ); }
+
+            void Pack() throw( runtime_error );
+
+            inline size_t GetPageCount() const { return m_vPages.size(); }
+            inline size_t GetImageCount() const { return m_vImages.size(); }
+            SDL_Surface* GetPage( size_t nPage ) const;
+            void Print() const;
+
+            CSpriteAtlas(const CSpriteAtlas& other)=delete;
+            CSpriteAtlas& operator=(const CSpriteAtlas& other)=delete;
+        protected:
+        private:
+            bool IsSameFormat( const SDL_PixelFormat* a, const SDL_PixelFormat* b ) const;
+
+            vector<CImage*> m_vImages;
+            vector<shared_ptr<CSurface>> m_vPages;
+            vector<float> m_vOccupancy;
+            int m_iPageWidth;
+            int m_iPageHeight;
+    };
+
+}
+
+#endif // SPRITEATLAS_HPP
@@ -0,0 +1,185 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <SDL_image.h>
+#include <SDL_rotozoom.h>
+#include "SpriteBank.hpp"
+#include "Math.hpp"
+
+namespace DemoEngine {
+
+    namespace {
+
+        // Rotates and zooms a premultiplied surface at iSupersampling times the size and shrinks it back
+        SDL_Surface* Resample( SDL_Surface* pSource, double fDegrees, double fScale, int iSupersampling )
+        {
+            SDL_Surface* pVariant = rotozoomSurface( pSource, fDegrees, fScale * iSupersampling, SMOOTHING_ON );
+            if ( pVariant != nullptr && iSupersampling > 1 ) {
+                SDL_Surface* pLarge = pVariant;
+                pVariant = shrinkSurface( pLarge, iSupersampling, iSupersampling );
+                SDL_FreeSurface( pLarge );
+            }
+            return pVariant;
+        }
+
+    }
+
+    /** \brief Loads an image and builds the variants from it
+     *
+     * \param szFileName const char*
+     * \param nAngles int - Number of angles, evenly spaced around the full circle.
+     * \param vScales const vector<float>& - Scales built for every angle.
+     * \param iSupersampling int - The variants are resampled at this many times their size and shrunk back.
+     * \return void
+     *
+     */
+    void CSpriteBank::Build( const char *szFileName, int nAngles, const vector<float>& vScales, int iSupersampling ) throw( runtime_error )
+    {
+        #ifdef DEBUG
+        cout << "CSpriteBank::Build( \"" << szFileName << "\" )" << endl;
+        #endif
+        SDL_Surface* pSource = IMG_Load( szFileName );
+        if ( pSource == nullptr ) {
+            throw ( runtime_error( "CSpriteBank::Cannot load image: " + std::string(szFileName) ) );
+        }
+        try {
+            Build( pSource, nAngles, vScales, iSupersampling );
+        }
+        catch ( ... ) {
+            SDL_FreeSurface( pSource );
+            throw;
+        }
+        SDL_FreeSurface( pSource );
+    }
+
+    /** \brief Builds the variants from a surface
+     *
+     * The source must not be premultiplied (images converted by CImageAlpha can be), it is
+     * copied so it is left as it is. The variants are converted to the display format right
+     * away if the video mode is set.
+     *
+     * \param pSource SDL_Surface*
+     * \param nAngles int - Number of angles, evenly spaced around the full circle.
+     * \param vScales const vector<float>& - Scales built for every angle.
+     * \param iSupersampling int - The variants are resampled at this many times their size and shrunk back.
+     * \return void
+     *
+     */
+    void CSpriteBank::Build( SDL_Surface* pSource, int nAngles, const vector<float>& vScales, int iSupersampling ) throw( runtime_error )
+    {
+        Release();
+        if ( pSource == nullptr || nAngles < 1 || vScales.empty() ) return;
+        if ( iSupersampling < 1 ) iSupersampling = 1;
+
+        SDL_Surface* pRGBA = CShadowedSprite::Copy( pSource );
+
+        m_nAngles = nAngles;
+        m_vScales = vScales;
+        m_vVariants.reserve( m_nAngles * m_vScales.size() );
+        for ( float fScale : m_vScales ) {
+            for ( int i = 0; i < m_nAngles; ++i ) {
+                double fDegrees = 360.0 * i / m_nAngles;
+                SDL_Surface* pVariant = Resample( pRGBA, fDegrees, fScale, iSupersampling );
+                if ( pVariant == nullptr ) {
+                    SDL_FreeSurface( pRGBA );
+                    Release();
+                    throw runtime_error( "CSpriteBank::Cannot resample variant" );
+                }
+                Variant_t variant = { nullptr, pVariant->w / 2, pVariant->h / 2 };
+                variant.pImage = CShadowedSprite::CreateImage( pVariant );
+                m_vVariants.push_back( std::move( variant ) );
+            }
+        }
+        SDL_FreeSurface( pRGBA );
+    }
+
+    void CSpriteBank::Release()
+    {
+        m_vVariants.clear();
+        m_vScales.clear();
+        m_nAngles = 0;
+    }
+
+    /** \brief Gets the index of the variant nearest to the angle and scale
+     *
+     * \param fDegrees float - Any angle, wrapped around the full circle.
+     * \param fScale float
+     * \return size_t - Count() if the bank is empty.
+     *
+     */
+    size_t CSpriteBank::GetIndex( float fDegrees, float fScale ) const
+    {
+        if ( m_vVariants.empty() ) return m_vVariants.size();
+        int iAngle = (int)floor( fDegrees * m_nAngles / 360.0f + 0.5f ) % m_nAngles;
+        if ( iAngle < 0 ) iAngle += m_nAngles;
+        size_t nScale = 0;
+        for ( size_t n = 1; n < m_vScales.size(); ++n ) {
+            if ( fabs( m_vScales[n] - fScale ) < fabs( m_vScales[nScale] - fScale ) )
+                nScale = n;
+        }
+        return ( nScale * m_nAngles + iAngle );
+    }
+
+    /** \brief Gets the variant nearest to the angle and scale
+     *
+     * \param fDegrees float
+     * \param fScale float
+     * \return CImageAlpha* - nullptr if the bank is empty.
+     *
+     */
+    CImageAlpha* CSpriteBank::Get( float fDegrees, float fScale ) const
+    {
+        return GetVariant( GetIndex( fDegrees, fScale ) );
+    }
+
+    void CSpriteBank::SetAlpha( Uint8 alpha )
+    {
+        for ( auto& variant : m_vVariants )
+            variant.pImage->SetAlpha( alpha );
+    }
+
+    void CSpriteBank::AddTo( CSpriteAtlas& atlas )
+    {
+        for ( auto& variant : m_vVariants )
+            atlas.Add( variant.pImage );
+    }
+
+    /** \brief Gets the angle that turns a sprite drawn facing down towards a direction
+     *
+     * Add 180 degrees for sprites drawn facing up.
+     *
+     * \param dx float
+     * \param dy float
+     * \return float - Angle in degrees.
+     *
+     */
+    float CSpriteBank::GetDirection( float dx, float dy )
+    {
+        return ( atan2( dx, dy ) * 180 / Math::kPI );
+    }
+
+}
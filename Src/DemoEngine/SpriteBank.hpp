@@ -0,0 +1,96 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+#ifndef SPRITEBANK_HPP
+#define SPRITEBANK_HPP
+
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include <SDL.h>
+#include "Singleton.hpp"
+#include "ResourceFactory.hpp"
+#include "ImageAlpha.hpp"
+#include "SpriteAtlas.hpp"
+#include "ShadowedSprite.hpp"
+
+namespace DemoEngine {
+
+    using std::unique_ptr;
+    using std::vector;
+    using std::runtime_error;
+
+    /// Pre-rotated (and optionally pre-scaled) variants of a sprite, rendered once at load time.
+    /// Each variant is rotated and zoomed at a multiple of its size and box filtered back down, in
+    /// premultiplied alpha so the transparent edges don't bleed dark fringes. Drawing picks the
+    /// variant nearest to the wanted angle and scale, so nothing is transformed per frame.
+    /// Angles are in degrees counter-clockwise like in rotozoomSurface.
+    class CSpriteBank
+    {
+        struct Variant_t {
+            unique_ptr<CImageAlpha> pImage;
+            int iCenterX;   // Center of the sprite in the variant
+            int iCenterY;
+        };
+
+        public:
+            CSpriteBank() : m_vVariants(), m_vScales() {};
+            virtual ~CSpriteBank() {};
+
+            void Build( const char *szFileName, int nAngles, const vector<float>& vScales = vector<float>( 1, 1.0f ), int iSupersampling = 2 ) throw( runtime_error );
+            void Build( SDL_Surface* pSource, int nAngles, const vector<float>& vScales = vector<float>( 1, 1.0f ), int iSupersampling = 2 ) throw( runtime_error );
+            void Release();
+
+            CImageAlpha* Get( float fDegrees, float fScale = 1.0f ) const;
+            size_t GetIndex( float fDegrees, float fScale = 1.0f ) const;
+            inline CImageAlpha* GetVariant( size_t nIndex ) const { return ( nIndex < m_vVariants.size() ? m_vVariants[nIndex].pImage.get() : nullptr ); }
+            inline int GetCenterX( size_t nIndex ) const { return m_vVariants[nIndex].iCenterX; }
+            inline int GetCenterY( size_t nIndex ) const { return m_vVariants[nIndex].iCenterY; }
+            inline size_t Count() const { return m_vVariants.size(); }
+            inline bool IsEmpty() const { return m_vVariants.empty(); }
+            inline int GetAngles() const { return m_nAngles; }
+            inline const vector<float>& GetScales() const { return m_vScales; }
+
+            // Applies to every variant (see CImageAlpha)
+            void SetAlpha( Uint8 alpha );
+            // Adds every variant to the atlas, packed on its next Pack() call
+            void AddTo( CSpriteAtlas& atlas );
+
+            // Angle that turns a sprite drawn facing down (+y) towards the direction dx, dy
+            static float GetDirection( float dx, float dy );
+
+            CSpriteBank(const CSpriteBank& other)=delete;
+            CSpriteBank& operator=(const CSpriteBank& other)=delete;
+        protected:
+        private:
+            vector<Variant_t> m_vVariants;      // Angle by angle for the first scale, then the next scale
+            vector<float> m_vScales;
+            int m_nAngles = 0;
+    };
+
+    typedef CSingleton<CResourceFactory<int, CSpriteBank>> SpriteBankFactory;
+
+}
+
+#endif // SPRITEBANK_HPP
@@ -52,6 +52,7 @@ namespace DemoEngine {
                 Free();
             }
             SDL_Surface* GetSurfacePointer() { return m_pSurface; }
+            inline int GetID() const { return m_ObjectID; }
             void SetSurfacePointer( SDL_Surface* pSurface ) {
                 Free();
                 m_pSurface = pSurface;
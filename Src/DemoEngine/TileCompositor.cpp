@@ -0,0 +1,251 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include "TileCompositor.hpp"
+#include <algorithm>
+
+namespace DemoEngine {
+
+    using std::min;
+    using std::max;
+
+    /** \brief Starts the worker threads
+     *
+     * \param nThreads int - Number of worker threads, the screen is split into nThreads+1 bands.
+     * \return void
+     *
+     */
+    void CTileCompositor::Start( int nThreads )
+    {
+        Stop();
+        for ( int i = 0; i < nThreads; ++i )
+        {
+            m_vWorkers.push_back( unique_ptr<CWorker>( new CWorker ) );
+            m_vWorkers.back()->StartThread();
+        }
+    }
+
+    void CTileCompositor::Stop()
+    {
+        for ( auto& worker : m_vWorkers )
+            worker->Quit();
+        m_vWorkers.clear();
+    }
+
+    /** \brief Draws the commands, one band per thread, and returns when all bands are done
+     *
+     * \param pScreen SDL_Surface* - Must not require locking.
+     * \param pCommands const Command_t*
+     * \param nCount size_t
+     * \return void
+     *
+     */
+    void CTileCompositor::Execute( SDL_Surface* pScreen, const Command_t* pCommands, size_t nCount )
+    {
+        int nBands = (int)GetBandCount();
+        int iBandHeight = ( pScreen->h + nBands - 1 ) / nBands;
+        for ( int i = 1; i < nBands; ++i )
+            m_vWorkers[i-1]->Post( pScreen, pCommands, nCount, i * iBandHeight, min( pScreen->h, ( i + 1 ) * iBandHeight ) );
+        DrawBand( pScreen, pCommands, nCount, 0, min( pScreen->h, iBandHeight ) );
+        for ( auto& worker : m_vWorkers )
+            worker->Wait();
+    }
+
+    /** \brief Draws one command to the whole screen (same as the serial renderer)
+     */
+    void CTileCompositor::DrawSerial( SDL_Surface* pScreen, const Command_t& cmd )
+    {
+        DrawBand( pScreen, &cmd, 1, 0, pScreen->h );
+    }
+
+    /** \brief Draws the commands clipped to the rows y0..y1-1
+     *
+     * Blits are clipped the same way SDL_UpperBlit does it, only against the band
+     * instead of the whole clip rectangle, and then drawn with CAlphaBlitter or SDL_LowerBlit.
+     *
+     * \param pScreen SDL_Surface*
+     * \param pCommands const Command_t*
+     * \param nCount size_t
+     * \param y0 int - First row of the band.
+     * \param y1 int - Row after the last row of the band.
+     * \return void
+     *
+     */
+    void CTileCompositor::DrawBand( SDL_Surface* pScreen, const Command_t* pCommands, size_t nCount, int y0, int y1 )
+    {
+        const SDL_Rect& clip = pScreen->clip_rect;
+        int iClipX0 = clip.x;
+        int iClipX1 = clip.x + clip.w;
+        int iClipY0 = max( (int)clip.y, y0 );
+        int iClipY1 = min( clip.y + clip.h, y1 );
+        if ( iClipY1 <= iClipY0 ) return;
+        auto& blitter = CSingleton<CAlphaBlitter>::Instance();
+
+        for ( size_t i = 0; i < nCount; ++i )
+        {
+            const Command_t& cmd = pCommands[i];
+            if ( cmd.iBlend == CRenderQueue::BLEND_PRIMITIVE )
+            {
+                Uint8 r = cmd.nState >> 24;
+                Uint8 g = ( cmd.nState >> 16 ) & 0xff;
+                Uint8 b = ( cmd.nState >> 8 ) & 0xff;
+                Uint8 a = cmd.nState & 0xff;
+                int ya = min( cmd.y, cmd.y2 );
+                int yb = max( cmd.y, cmd.y2 );
+                switch ( cmd.nSurfaceID ) {
+                    default:
+                    case CRenderQueue::PRIMITIVE_PIXEL:
+                        if ( cmd.y >= y0 && cmd.y < y1 )
+                            pixelRGBA( pScreen, cmd.x, cmd.y, r, g, b, a );
+                        break;
+                    case CRenderQueue::PRIMITIVE_LINE:
+                        // Only drawn whole, a line clipped to a band would not hit the same pixels
+                        if ( y0 == 0 && y1 >= pScreen->h )
+                            lineRGBA( pScreen, cmd.x, cmd.y, cmd.x2, cmd.y2, r, g, b, a );
+                        break;
+                    case CRenderQueue::PRIMITIVE_BOX:
+                        ya = max( ya, iClipY0 );
+                        yb = min( yb, iClipY1 - 1 );
+                        if ( ya <= yb )
+                            boxRGBA( pScreen, cmd.x, ya, cmd.x2, yb, r, g, b, a );
+                        break;
+                    case CRenderQueue::PRIMITIVE_HLINE:
+                        if ( cmd.y >= y0 && cmd.y < y1 )
+                            hlineRGBA( pScreen, cmd.x, cmd.x2, cmd.y, r, g, b, a );
+                        break;
+                    case CRenderQueue::PRIMITIVE_VLINE:
+                        ya = max( ya, iClipY0 );
+                        yb = min( yb, iClipY1 - 1 );
+                        if ( ya <= yb )
+                            vlineRGBA( pScreen, cmd.x, ya, yb, r, g, b, a );
+                        break;
+                    case CRenderQueue::PRIMITIVE_BATCH:
+                        // Drawn whole like lines
+                        if ( y0 == 0 && y1 >= pScreen->h )
+                            cmd.pBatch->Draw( pScreen );
+                        break;
+                }
+                continue;
+            }
+
+            SDL_Surface* pSource = cmd.pSurface;
+            int srcx, srcy, w, h;
+            int dstx = cmd.x;
+            int dsty = cmd.y;
+
+            // Clip the source rectangle to the source surface
+            if ( cmd.bHasSource ) {
+                srcx = cmd.source.x;
+                w = cmd.source.w;
+                if ( srcx < 0 ) {
+                    w += srcx;
+                    dstx -= srcx;
+                    srcx = 0;
+                }
+                w = min( w, pSource->w - srcx );
+                srcy = cmd.source.y;
+                h = cmd.source.h;
+                if ( srcy < 0 ) {
+                    h += srcy;
+                    dsty -= srcy;
+                    srcy = 0;
+                }
+                h = min( h, pSource->h - srcy );
+            } else {
+                srcx = srcy = 0;
+                w = pSource->w;
+                h = pSource->h;
+            }
+
+            // Clip the destination to the band
+            int dx = iClipX0 - dstx;
+            if ( dx > 0 ) {
+                w -= dx;
+                dstx += dx;
+                srcx += dx;
+            }
+            dx = dstx + w - iClipX1;
+            if ( dx > 0 ) w -= dx;
+            int dy = iClipY0 - dsty;
+            if ( dy > 0 ) {
+                h -= dy;
+                dsty += dy;
+                srcy += dy;
+            }
+            dy = dsty + h - iClipY1;
+            if ( dy > 0 ) h -= dy;
+            if ( w <= 0 || h <= 0 ) continue;
+
+            SDL_Rect src = { (Sint16)srcx, (Sint16)srcy, (Uint16)w, (Uint16)h };
+            SDL_Rect dst = { (Sint16)dstx, (Sint16)dsty, (Uint16)w, (Uint16)h };
+            bool bPremultiplied = ( cmd.iBlend == CRenderQueue::BLEND_PREMULTIPLIED );
+            Uint8 cAlpha = 255;
+            if ( cmd.iBlend == CRenderQueue::BLEND_ALPHA ) cAlpha = (Uint8)cmd.nState;
+            else if ( bPremultiplied ) cAlpha = (Uint8)( cmd.nState >> 24 );
+            if ( !blitter->LowerBlit( pSource, src, pScreen, dst, cAlpha, cmd.pSpans, bPremultiplied, cmd.nState & 0xffffff ) && !bPremultiplied )
+                SDL_LowerBlit( pSource, &src, pScreen, &dst );
+        }
+    }
+
+    CTileCompositor::CWorker::CWorker() {
+        m_pStart = SDL_CreateSemaphore( 0 );
+        m_pDone = SDL_CreateSemaphore( 0 );
+    }
+
+    CTileCompositor::CWorker::~CWorker() {
+        SDL_DestroySemaphore( m_pStart );
+        SDL_DestroySemaphore( m_pDone );
+    }
+
+    int CTileCompositor::CWorker::Execute() {
+        while ( true ) {
+            SDL_SemWait( m_pStart );
+            if ( !IsThreadRunning() ) break;
+            DrawBand( m_pScreen, m_pCommands, m_nCount, m_iY0, m_iY1 );
+            SDL_SemPost( m_pDone );
+        }
+        return( 0 );
+    }
+
+    void CTileCompositor::CWorker::Post( SDL_Surface* pScreen, const Command_t* pCommands, size_t nCount, int y0, int y1 ) {
+        m_pScreen = pScreen;
+        m_pCommands = pCommands;
+        m_nCount = nCount;
+        m_iY0 = y0;
+        m_iY1 = y1;
+        SDL_SemPost( m_pStart );
+    }
+
+    void CTileCompositor::CWorker::Wait() {
+        SDL_SemWait( m_pDone );
+    }
+
+    void CTileCompositor::CWorker::Quit() {
+        StopThread();
+        SDL_SemPost( m_pStart );
+        WaitThread();
+    }
+
+}
@@ -0,0 +1,99 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef TILECOMPOSITOR_HPP
+#define TILECOMPOSITOR_HPP
+
+#include <vector>
+#include <memory>
+#include <SDL.h>
+#include <SDL_gfxPrimitives.h>
+#include "Threaded.hpp"
+#include "RenderQueue.hpp"
+#include "AlphaBlitter.hpp"
+#include "PrimitiveBatch.hpp"
+
+namespace DemoEngine {
+
+    using std::vector;
+    using std::unique_ptr;
+
+    /// Draws runs of render queue commands in parallel. The screen is split into horizontal
+    /// bands and every band is drawn by its own thread (the calling thread draws the first one).
+    /// Whole rows are always drawn by the same blitter with the same width, so the result is
+    /// bit-identical to drawing the commands serially.
+    ///
+    /// The caller must set the blend state of the source surface before Execute, all the
+    /// commands in one call must share it. Lines are not supported (clipping them would change
+    /// the rasterization), draw those with DrawSerial.
+    class CTileCompositor
+    {
+        public:
+            typedef CRenderQueue::Command_t Command_t;
+
+            CTileCompositor() : m_vWorkers() {};
+            virtual ~CTileCompositor() { Stop(); }
+
+            void Start( int nThreads );
+            void Stop();
+            inline bool IsRunning() const { return !m_vWorkers.empty(); }
+            inline size_t GetBandCount() const { return m_vWorkers.size() + 1; }
+
+            void Execute( SDL_Surface* pScreen, const Command_t* pCommands, size_t nCount );
+
+            static void DrawSerial( SDL_Surface* pScreen, const Command_t& cmd );
+            static void DrawBand( SDL_Surface* pScreen, const Command_t* pCommands, size_t nCount, int y0, int y1 );
+
+            CTileCompositor(const CTileCompositor& other)=delete;
+            CTileCompositor& operator=(const CTileCompositor& other)=delete;
+        protected:
+        private:
+            class CWorker : public CThreaded
+            {
+                public:
+                    CWorker();
+                    virtual ~CWorker();
+                    int Execute() override;
+                    void Post( SDL_Surface* pScreen, const Command_t* pCommands, size_t nCount, int y0, int y1 );
+                    void Wait();
+                    void Quit();
+                    CWorker(const CWorker& other)=delete;
+                    CWorker& operator=(const CWorker& other)=delete;
+                private:
+                    SDL_sem* m_pStart = nullptr;
+                    SDL_sem* m_pDone = nullptr;
+                    SDL_Surface* m_pScreen = nullptr;
+                    const Command_t* m_pCommands = nullptr;
+                    size_t m_nCount = 0;
+                    int m_iY0 = 0;
+                    int m_iY1 = 0;
+            };
+
+            vector<unique_ptr<CWorker>> m_vWorkers;
+    };
+
+}
+
+#endif // TILECOMPOSITOR_HPP
@@ -32,6 +32,39 @@
 
 namespace DemoEngine
 {
+    /// Source of the game time in milliseconds for all timers. Follows SDL_GetTicks, or
+    /// with a fixed step only advances when stepped (once per frame by CGame) so that
+    /// headless runs are repeatable.
+    class CClock
+    {
+        public:
+            CClock() {};
+            virtual ~CClock() {};
+
+            inline Uint32 GetTicks() const
+            {
+                return ( m_nFixedStep ? m_nTicks : SDL_GetTicks() );
+            }
+
+            // Advance a fixed amount of milliseconds per step instead of the wall clock (0 = off)
+            void SetFixedStep( Uint32 nMilliseconds )
+            {
+                m_nFixedStep = nMilliseconds;
+            }
+
+            inline bool IsFixedStep() const { return ( m_nFixedStep != 0 ); }
+
+            void Step()
+            {
+                m_nTicks += m_nFixedStep;
+            }
+
+        protected:
+        private:
+            Uint32 m_nTicks = 0;
+            Uint32 m_nFixedStep = 0;
+    };
+
     class CTimer
     {
         public:
@@ -44,12 +77,12 @@ namespace DemoEngine
 
             void Update()
             {
-                m_CurrentTime = SDL_GetTicks();
+                m_CurrentTime = CSingleton<CClock>::Instance()->GetTicks();
             }
 
             void Reset()
             {
-                m_PreviousTime = m_CurrentTime = SDL_GetTicks();
+                m_PreviousTime = m_CurrentTime = CSingleton<CClock>::Instance()->GetTicks();
             }
 
             float GetPassedTime()
@@ -0,0 +1,398 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include <cstring>
+#include <string>
+#include "Transition.hpp"
+
+#if defined(__SSE2__) || ( defined(__GNUC__) && ( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) ) && ( defined(__i386__) || defined(__x86_64__) ) )
+#define TRANSITION_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace DemoEngine {
+
+    namespace {
+
+        /** \brief x / 255 rounded, for x up to 255 * 255
+         */
+        inline Uint32 Divide255( Uint32 x )
+        {
+            x += 128;
+            return ( ( x + ( x >> 8 ) ) >> 8 );
+        }
+
+        inline bool SameFormat( const SDL_PixelFormat* a, const SDL_PixelFormat* b )
+        {
+            return ( a->BytesPerPixel == b->BytesPerPixel && a->Rmask == b->Rmask && a->Gmask == b->Gmask &&
+                     a->Bmask == b->Bmask && a->palette == nullptr && b->palette == nullptr );
+        }
+
+        // dst = a + ( b - a ) * amount / 255, dst may be a
+        void LerpBytes( Uint8* dst, const Uint8* a, const Uint8* b, int n, Uint8 amount )
+        {
+            const Uint32 wa = 255 - amount;
+            for ( int i = 0; i < n; ++i )
+                dst[i] = Divide255( a[i] * wa + b[i] * amount );
+        }
+
+        // dst = dst + src * amount / 255, saturated
+        void AddBytes( Uint8* dst, const Uint8* src, int n, Uint8 amount )
+        {
+            for ( int i = 0; i < n; ++i ) {
+                Uint32 c = dst[i] + Divide255( src[i] * amount );
+                dst[i] = ( c > 255 ? 255 : c );
+            }
+        }
+
+        #ifdef TRANSITION_SSE2
+        // Sixteen bytes at a time, the tail is done in C
+        __attribute__((target("sse2"))) void LerpBytesSSE2( Uint8* dst, const Uint8* a, const Uint8* b, int n, Uint8 amount )
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i wa = _mm_set1_epi16( 255 - amount );
+            const __m128i wb = _mm_set1_epi16( amount );
+            const __m128i round = _mm_set1_epi16( 128 );
+            const __m128i div = _mm_set1_epi16( 257 );
+            int i = 0;
+            for ( ; i + 16 <= n; i += 16 ) {
+                __m128i va = _mm_loadu_si128( (const __m128i*)( a + i ) );
+                __m128i vb = _mm_loadu_si128( (const __m128i*)( b + i ) );
+                __m128i lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( va, zero ), wa ),
+                                            _mm_mullo_epi16( _mm_unpacklo_epi8( vb, zero ), wb ) );
+                __m128i hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( va, zero ), wa ),
+                                            _mm_mullo_epi16( _mm_unpackhi_epi8( vb, zero ), wb ) );
+                lo = _mm_mulhi_epu16( _mm_add_epi16( lo, round ), div );
+                hi = _mm_mulhi_epu16( _mm_add_epi16( hi, round ), div );
+                _mm_storeu_si128( (__m128i*)( dst + i ), _mm_packus_epi16( lo, hi ) );
+            }
+            LerpBytes( dst + i, a + i, b + i, n - i, amount );
+        }
+
+        __attribute__((target("sse2"))) void AddBytesSSE2( Uint8* dst, const Uint8* src, int n, Uint8 amount )
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i wb = _mm_set1_epi16( amount );
+            const __m128i round = _mm_set1_epi16( 128 );
+            const __m128i div = _mm_set1_epi16( 257 );
+            int i = 0;
+            for ( ; i + 16 <= n; i += 16 ) {
+                __m128i vs = _mm_loadu_si128( (const __m128i*)( src + i ) );
+                __m128i lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( vs, zero ), wb ), round );
+                __m128i hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( vs, zero ), wb ), round );
+                __m128i add = _mm_packus_epi16( _mm_mulhi_epu16( lo, div ), _mm_mulhi_epu16( hi, div ) );
+                __m128i vd = _mm_loadu_si128( (const __m128i*)( dst + i ) );
+                _mm_storeu_si128( (__m128i*)( dst + i ), _mm_adds_epu8( vd, add ) );
+            }
+            AddBytes( dst + i, src + i, n - i, amount );
+        }
+        #endif
+
+        // 16-bit pixels are blended per channel
+        void Lerp16( Uint16* dst, const Uint16* a, const Uint16* b, int w, const SDL_PixelFormat* format, Uint8 amount )
+        {
+            const Uint32 wa = 255 - amount;
+            const Uint32 masks[3] = { format->Rmask, format->Gmask, format->Bmask };
+            const Uint8 shifts[3] = { format->Rshift, format->Gshift, format->Bshift };
+            for ( int x = 0; x < w; ++x ) {
+                Uint32 pa = a[x], pb = b[x], p = 0;
+                for ( int c = 0; c < 3; ++c ) {
+                    Uint32 ca = ( pa & masks[c] ) >> shifts[c];
+                    Uint32 cb = ( pb & masks[c] ) >> shifts[c];
+                    p |= Divide255( ca * wa + cb * amount ) << shifts[c];
+                }
+                dst[x] = p;
+            }
+        }
+
+        void Add16( Uint16* dst, const Uint16* src, int w, const SDL_PixelFormat* format, Uint8 amount )
+        {
+            const Uint32 masks[3] = { format->Rmask, format->Gmask, format->Bmask };
+            const Uint8 shifts[3] = { format->Rshift, format->Gshift, format->Bshift };
+            for ( int x = 0; x < w; ++x ) {
+                Uint32 pd = dst[x], ps = src[x], p = 0;
+                for ( int c = 0; c < 3; ++c ) {
+                    Uint32 nMax = masks[c] >> shifts[c];
+                    Uint32 cd = ( ( pd & masks[c] ) >> shifts[c] ) + Divide255( ( ( ps & masks[c] ) >> shifts[c] ) * amount );
+                    p |= ( cd > nMax ? nMax : cd ) << shifts[c];
+                }
+                dst[x] = p;
+            }
+        }
+
+    }
+
+    CTransition::CTransition() : m_vColorRow()
+    {
+        #ifdef TRANSITION_SSE2
+        m_bHasSSE2 = ( SDL_HasSSE2() != 0 );
+        #endif
+        m_bSSE2 = m_bHasSSE2;
+    }
+
+    CTransition::~CTransition()
+    {
+        Release();
+    }
+
+    /** \brief Frees the cached frames (call before SDL_Quit)
+     *
+     * \return void
+     *
+     */
+    void CTransition::Release()
+    {
+        for ( auto& pFrame : m_pFrames ) {
+            if ( pFrame != nullptr )
+                SDL_FreeSurface( pFrame );
+            pFrame = nullptr;
+        }
+    }
+
+    /** \brief Copies a surface into a frame slot
+     *
+     * The slot is reused when the source has the same size and format, otherwise the
+     * source is converted to pFormat (normally the screen format).
+     *
+     * \param pSource SDL_Surface*
+     * \param iFrame int - FRAME_FROM or FRAME_TO
+     * \param pFormat const SDL_PixelFormat*
+     * \return void
+     *
+     */
+    void CTransition::Capture( SDL_Surface* pSource, int iFrame, const SDL_PixelFormat* pFormat ) throw(runtime_error)
+    {
+        if ( pSource == nullptr || iFrame < 0 || iFrame >= FRAME_COUNT ) return;
+        SDL_Surface*& pFrame = m_pFrames[iFrame];
+        if ( pFrame != nullptr && pFrame->w == pSource->w && pFrame->h == pSource->h && SameFormat( pFrame->format, pSource->format ) ) {
+            bool bLocked = SDL_MUSTLOCK( pSource );
+            if ( bLocked && SDL_LockSurface( pSource ) < 0 ) return;
+            const size_t nRowBytes = pSource->w * pSource->format->BytesPerPixel;
+            for ( int y = 0; y < pSource->h; ++y )
+                memcpy( (Uint8*)pFrame->pixels + y * pFrame->pitch, (const Uint8*)pSource->pixels + y * pSource->pitch, nRowBytes );
+            if ( bLocked ) SDL_UnlockSurface( pSource );
+            return;
+        }
+        if ( pFrame != nullptr )
+            SDL_FreeSurface( pFrame );
+        pFrame = SDL_ConvertSurface( pSource, const_cast<SDL_PixelFormat*>( pFormat ), SDL_SWSURFACE );
+        if ( pFrame == nullptr )
+            throw runtime_error( std::string( SDL_GetError() ) );
+    }
+
+    SDL_Surface* CTransition::GetFrame( int iFrame ) const
+    {
+        return ( iFrame >= 0 && iFrame < FRAME_COUNT ? m_pFrames[iFrame] : nullptr );
+    }
+
+    /** \brief Blends the screen towards a color
+     *
+     * The screen must be locked by the caller if needed.
+     *
+     * \param pScreen SDL_Surface*
+     * \param nColor Uint32 - mapped to the screen format
+     * \param amount Uint8 - 0 keeps the screen, 255 fills it with the color
+     * \return bool - false if the screen format is not supported.
+     *
+     */
+    bool CTransition::Fade( SDL_Surface* pScreen, Uint32 nColor, Uint8 amount ) const
+    {
+        if ( !IsSupported( pScreen ) ) return false;
+        if ( amount == 0 ) return true;
+        const Uint8* pColor = ColorRow( pScreen, nColor );
+        for ( int y = 0; y < pScreen->h; ++y ) {
+            Uint8* dst = (Uint8*)pScreen->pixels + y * pScreen->pitch;
+            LerpRow( dst, dst, pColor, pScreen->w, pScreen->format, amount );
+        }
+        return true;
+    }
+
+    /** \brief Adds a color to the screen, saturating each channel
+     *
+     * \param pScreen SDL_Surface*
+     * \param nColor Uint32 - mapped to the screen format
+     * \param amount Uint8 - share of the color added
+     * \return bool - false if the screen format is not supported.
+     *
+     */
+    bool CTransition::Flash( SDL_Surface* pScreen, Uint32 nColor, Uint8 amount ) const
+    {
+        if ( !IsSupported( pScreen ) ) return false;
+        if ( amount == 0 ) return true;
+        const Uint8* pColor = ColorRow( pScreen, nColor );
+        for ( int y = 0; y < pScreen->h; ++y )
+            AddRow( (Uint8*)pScreen->pixels + y * pScreen->pitch, pColor, pScreen->w, pScreen->format, amount );
+        return true;
+    }
+
+    /** \brief Blends the screen towards a cached frame
+     *
+     * \param pScreen SDL_Surface*
+     * \param iFrame int
+     * \param amount Uint8 - 0 keeps the screen, 255 shows only the frame
+     * \return bool - false if the frame is missing or doesn't match the screen.
+     *
+     */
+    bool CTransition::Crossfade( SDL_Surface* pScreen, int iFrame, Uint8 amount ) const
+    {
+        const SDL_Surface* pFrame = GetFrame( iFrame );
+        if ( !IsCompatible( pScreen, pFrame ) ) return false;
+        for ( int y = 0; y < pScreen->h; ++y ) {
+            Uint8* dst = (Uint8*)pScreen->pixels + y * pScreen->pitch;
+            LerpRow( dst, dst, (const Uint8*)pFrame->pixels + y * pFrame->pitch, pScreen->w, pScreen->format, amount );
+        }
+        return true;
+    }
+
+    /** \brief Writes a blend of two cached frames to the screen
+     *
+     * \param pScreen SDL_Surface*
+     * \param iFrom int
+     * \param iTo int
+     * \param amount Uint8 - 0 shows only iFrom, 255 only iTo
+     * \return bool - false if a frame is missing or doesn't match the screen.
+     *
+     */
+    bool CTransition::Crossfade( SDL_Surface* pScreen, int iFrom, int iTo, Uint8 amount ) const
+    {
+        const SDL_Surface* pFrom = GetFrame( iFrom );
+        const SDL_Surface* pTo = GetFrame( iTo );
+        if ( !IsCompatible( pScreen, pFrom ) || !IsCompatible( pScreen, pTo ) ) return false;
+        for ( int y = 0; y < pScreen->h; ++y ) {
+            LerpRow( (Uint8*)pScreen->pixels + y * pScreen->pitch,
+                     (const Uint8*)pFrom->pixels + y * pFrom->pitch,
+                     (const Uint8*)pTo->pixels + y * pTo->pitch, pScreen->w, pScreen->format, amount );
+        }
+        return true;
+    }
+
+    /** \brief Covers part of the screen with a cached frame
+     *
+     * \param pScreen SDL_Surface*
+     * \param iFrame int
+     * \param iDirection int - WIPE_LEFT, WIPE_RIGHT, WIPE_UP or WIPE_DOWN
+     * \param amount Uint8 - share of the screen covered
+     * \return bool - false if the frame is missing or doesn't match the screen.
+     *
+     */
+    bool CTransition::Wipe( SDL_Surface* pScreen, int iFrame, int iDirection, Uint8 amount ) const
+    {
+        const SDL_Surface* pFrame = GetFrame( iFrame );
+        if ( pFrame == nullptr || pFrame->w != pScreen->w || pFrame->h != pScreen->h ||
+             !SameFormat( pFrame->format, pScreen->format ) ) return false;
+        const int bpp = pScreen->format->BytesPerPixel;
+        int x0 = 0, y0 = 0, x1 = pScreen->w, y1 = pScreen->h;
+        switch ( iDirection ) {
+            default:
+            case WIPE_LEFT:
+                x0 = pScreen->w - pScreen->w * amount / 255;
+                break;
+            case WIPE_RIGHT:
+                x1 = pScreen->w * amount / 255;
+                break;
+            case WIPE_UP:
+                y0 = pScreen->h - pScreen->h * amount / 255;
+                break;
+            case WIPE_DOWN:
+                y1 = pScreen->h * amount / 255;
+                break;
+        }
+        if ( x0 >= x1 || y0 >= y1 ) return true;
+        const size_t nRowBytes = ( x1 - x0 ) * bpp;
+        for ( int y = y0; y < y1; ++y )
+            memcpy( (Uint8*)pScreen->pixels + y * pScreen->pitch + x0 * bpp,
+                    (const Uint8*)pFrame->pixels + y * pFrame->pitch + x0 * bpp, nRowBytes );
+        return true;
+    }
+
+    bool CTransition::IsSupported( const SDL_Surface* pSurface ) const
+    {
+        return ( pSurface != nullptr && pSurface->format->palette == nullptr && pSurface->format->BytesPerPixel >= 2 );
+    }
+
+    bool CTransition::IsCompatible( const SDL_Surface* pScreen, const SDL_Surface* pFrame ) const
+    {
+        return ( IsSupported( pScreen ) && pFrame != nullptr && pFrame->w == pScreen->w && pFrame->h == pScreen->h &&
+                 SameFormat( pFrame->format, pScreen->format ) );
+    }
+
+    /** \brief Fills a row as wide as the screen with a color
+     */
+    const Uint8* CTransition::ColorRow( const SDL_Surface* pScreen, Uint32 nColor ) const
+    {
+        const int bpp = pScreen->format->BytesPerPixel;
+        m_vColorRow.resize( pScreen->w * bpp );
+        Uint8* p = m_vColorRow.data();
+        for ( int x = 0; x < pScreen->w; ++x, p += bpp ) {
+            switch ( bpp ) {
+                case 2:
+                    *(Uint16*)p = nColor;
+                    break;
+                case 3:
+                    #if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                    p[0] = nColor; p[1] = nColor >> 8; p[2] = nColor >> 16;
+                    #else
+                    p[0] = nColor >> 16; p[1] = nColor >> 8; p[2] = nColor;
+                    #endif
+                    break;
+                default:
+                    *(Uint32*)p = nColor;
+                    break;
+            }
+        }
+        return ( m_vColorRow.data() );
+    }
+
+    void CTransition::LerpRow( Uint8* dst, const Uint8* a, const Uint8* b, int w, const SDL_PixelFormat* format, Uint8 amount ) const
+    {
+        if ( format->BytesPerPixel == 2 ) {
+            Lerp16( (Uint16*)dst, (const Uint16*)a, (const Uint16*)b, w, format, amount );
+            return;
+        }
+        #ifdef TRANSITION_SSE2
+        if ( m_bSSE2 ) {
+            LerpBytesSSE2( dst, a, b, w * format->BytesPerPixel, amount );
+            return;
+        }
+        #endif
+        LerpBytes( dst, a, b, w * format->BytesPerPixel, amount );
+    }
+
+    void CTransition::AddRow( Uint8* dst, const Uint8* src, int w, const SDL_PixelFormat* format, Uint8 amount ) const
+    {
+        if ( format->BytesPerPixel == 2 ) {
+            Add16( (Uint16*)dst, (const Uint16*)src, w, format, amount );
+            return;
+        }
+        #ifdef TRANSITION_SSE2
+        if ( m_bSSE2 ) {
+            AddBytesSSE2( dst, src, w * format->BytesPerPixel, amount );
+            return;
+        }
+        #endif
+        AddBytes( dst, src, w * format->BytesPerPixel, amount );
+    }
+
+}
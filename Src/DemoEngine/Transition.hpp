@@ -0,0 +1,92 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef TRANSITION_HPP
+#define TRANSITION_HPP
+
+#include <stdexcept>
+#include <vector>
+#include <SDL.h>
+
+namespace DemoEngine {
+
+    using std::runtime_error;
+    using std::vector;
+
+    /// Full screen transition passes done in place on the screen surface (fade to a color, flash,
+    /// crossfade and wipe). Frames to blend from are cached in slots with Capture. 24-bit and 32-bit
+    /// surfaces are blended byte by byte (with SSE2 when the CPU supports it), 16-bit surfaces per
+    /// channel. Palettized surfaces are not supported and the passes return false for them.
+    class CTransition
+    {
+        public:
+            enum FRAME {
+                FRAME_FROM = 0,
+                FRAME_TO,
+                FRAME_COUNT
+            };
+
+            enum WIPE {
+                WIPE_LEFT = 0,      // Covers the screen from the right edge towards the left
+                WIPE_RIGHT,
+                WIPE_UP,
+                WIPE_DOWN
+            };
+
+            CTransition();
+            virtual ~CTransition();
+
+            inline void SetSSE2( bool bSSE2 ) { m_bSSE2 = bSSE2 && m_bHasSSE2; }
+            inline bool IsSSE2() const { return m_bSSE2; }
+
+            void Capture( SDL_Surface* pSource, int iFrame, const SDL_PixelFormat* pFormat ) throw(runtime_error);
+            SDL_Surface* GetFrame( int iFrame ) const;
+            void Release();
+
+            bool Fade( SDL_Surface* pScreen, Uint32 nColor, Uint8 amount ) const;
+            bool Flash( SDL_Surface* pScreen, Uint32 nColor, Uint8 amount ) const;
+            bool Crossfade( SDL_Surface* pScreen, int iFrame, Uint8 amount ) const;
+            bool Crossfade( SDL_Surface* pScreen, int iFrom, int iTo, Uint8 amount ) const;
+            bool Wipe( SDL_Surface* pScreen, int iFrame, int iDirection, Uint8 amount ) const;
+
+            CTransition(const CTransition& other)=delete;             // Because we have pointer datamembers this class can't be automatically copied correctly.
+            CTransition& operator=(const CTransition& other)=delete;  // Because we have pointer datamembers this class can't be automatically copied correctly.
+        protected:
+        private:
+            bool IsSupported( const SDL_Surface* pSurface ) const;
+            bool IsCompatible( const SDL_Surface* pScreen, const SDL_Surface* pFrame ) const;
+            const Uint8* ColorRow( const SDL_Surface* pScreen, Uint32 nColor ) const;
+            void LerpRow( Uint8* dst, const Uint8* a, const Uint8* b, int w, const SDL_PixelFormat* format, Uint8 amount ) const;
+            void AddRow( Uint8* dst, const Uint8* src, int w, const SDL_PixelFormat* format, Uint8 amount ) const;
+
+            SDL_Surface* m_pFrames[FRAME_COUNT] = { nullptr, nullptr };
+            mutable vector<Uint8> m_vColorRow;          // One row of the fade or flash color
+            bool m_bHasSSE2 = false;
+            bool m_bSSE2 = false;
+    };
+
+}
+
+#endif // TRANSITION_HPP
@@ -0,0 +1,191 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#include <cstring>
+#include "Upscaler.hpp"
+
+#if defined(__SSE2__) || ( defined(__GNUC__) && ( __GNUC__ > 4 || ( __GNUC__ == 4 && __GNUC_MINOR__ >= 9 ) ) && ( defined(__i386__) || defined(__x86_64__) ) )
+#define UPSCALER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace DemoEngine {
+
+    namespace {
+
+        template<typename T>
+        void ScaleRowT( const T* src, T* dst, int w, int iScale )
+        {
+            switch ( iScale ) {
+                case 2:
+                    for ( int x = 0; x < w; ++x, dst += 2 ) {
+                        T p = src[x];
+                        dst[0] = p; dst[1] = p;
+                    }
+                    break;
+                case 3:
+                    for ( int x = 0; x < w; ++x, dst += 3 ) {
+                        T p = src[x];
+                        dst[0] = p; dst[1] = p; dst[2] = p;
+                    }
+                    break;
+                default:
+                    for ( int x = 0; x < w; ++x ) {
+                        T p = src[x];
+                        for ( int k = 0; k < iScale; ++k ) *dst++ = p;
+                    }
+                    break;
+            }
+        }
+
+        // 8-bit and 24-bit pixels
+        void ScaleRowBytes( const Uint8* src, Uint8* dst, int w, int iBytesPerPixel, int iScale )
+        {
+            for ( int x = 0; x < w; ++x, src += iBytesPerPixel ) {
+                for ( int k = 0; k < iScale; ++k, dst += iBytesPerPixel )
+                    memcpy( dst, src, iBytesPerPixel );
+            }
+        }
+
+        #ifdef UPSCALER_SSE2
+        // Four source pixels at a time, the tail is done in C
+        __attribute__((target("sse2"))) void ScaleRow32SSE2( const Uint32* src, Uint32* dst, int w, int iScale )
+        {
+            int x = 0;
+            switch ( iScale ) {
+                case 2:
+                    for ( ; x + 4 <= w; x += 4, dst += 8 ) {
+                        __m128i s = _mm_loadu_si128( (const __m128i*)( src + x ) );
+                        _mm_storeu_si128( (__m128i*)dst, _mm_unpacklo_epi32( s, s ) );
+                        _mm_storeu_si128( (__m128i*)( dst + 4 ), _mm_unpackhi_epi32( s, s ) );
+                    }
+                    break;
+                case 3:
+                    for ( ; x + 4 <= w; x += 4, dst += 12 ) {
+                        __m128i s = _mm_loadu_si128( (const __m128i*)( src + x ) );
+                        _mm_storeu_si128( (__m128i*)dst, _mm_shuffle_epi32( s, _MM_SHUFFLE( 1, 0, 0, 0 ) ) );
+                        _mm_storeu_si128( (__m128i*)( dst + 4 ), _mm_shuffle_epi32( s, _MM_SHUFFLE( 2, 2, 1, 1 ) ) );
+                        _mm_storeu_si128( (__m128i*)( dst + 8 ), _mm_shuffle_epi32( s, _MM_SHUFFLE( 3, 3, 3, 2 ) ) );
+                    }
+                    break;
+                case 4:
+                    for ( ; x + 4 <= w; x += 4, dst += 16 ) {
+                        __m128i s = _mm_loadu_si128( (const __m128i*)( src + x ) );
+                        _mm_storeu_si128( (__m128i*)dst, _mm_shuffle_epi32( s, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+                        _mm_storeu_si128( (__m128i*)( dst + 4 ), _mm_shuffle_epi32( s, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+                        _mm_storeu_si128( (__m128i*)( dst + 8 ), _mm_shuffle_epi32( s, _MM_SHUFFLE( 2, 2, 2, 2 ) ) );
+                        _mm_storeu_si128( (__m128i*)( dst + 12 ), _mm_shuffle_epi32( s, _MM_SHUFFLE( 3, 3, 3, 3 ) ) );
+                    }
+                    break;
+                default:
+                    break;
+            }
+            ScaleRowT<Uint32>( src + x, dst, w - x, iScale );
+        }
+        #endif
+
+    }
+
+    CUpscaler::CUpscaler()
+    {
+        #ifdef UPSCALER_SSE2
+        m_bHasSSE2 = ( SDL_HasSSE2() != 0 );
+        #endif
+        m_bSSE2 = m_bHasSSE2;
+    }
+
+    /** \brief Scales a rectangle of the source surface into the destination surface
+     *
+     * The surfaces must have the same pixel format and be locked by the caller if needed.
+     * The destination rectangle is the source rectangle multiplied by iScale.
+     *
+     * \param pSrc SDL_Surface*
+     * \param pDst SDL_Surface*
+     * \param iScale int
+     * \param rect const SDL_Rect& - in source coordinates, clipped to both surfaces
+     * \return void
+     *
+     */
+    void CUpscaler::Scale( SDL_Surface* pSrc, SDL_Surface* pDst, int iScale, const SDL_Rect& rect ) const
+    {
+        if ( iScale < 1 ) return;
+        int x0 = ( rect.x > 0 ? rect.x : 0 );
+        int y0 = ( rect.y > 0 ? rect.y : 0 );
+        int x1 = rect.x + rect.w;
+        int y1 = rect.y + rect.h;
+        if ( x1 > pSrc->w ) x1 = pSrc->w;
+        if ( y1 > pSrc->h ) y1 = pSrc->h;
+        if ( x1 > pDst->w / iScale ) x1 = pDst->w / iScale;
+        if ( y1 > pDst->h / iScale ) y1 = pDst->h / iScale;
+        if ( x0 >= x1 || y0 >= y1 ) return;
+
+        const int bpp = pSrc->format->BytesPerPixel;
+        const int w = x1 - x0;
+        const size_t nRowBytes = w * iScale * bpp;
+        for ( int y = y0; y < y1; ++y ) {
+            const Uint8* src = (const Uint8*)pSrc->pixels + y * pSrc->pitch + x0 * bpp;
+            Uint8* dst = (Uint8*)pDst->pixels + y * iScale * pDst->pitch + x0 * iScale * bpp;
+            ScaleRow( src, dst, w, bpp, iScale );
+            for ( int k = 1; k < iScale; ++k )
+                memcpy( dst + k * pDst->pitch, dst, nRowBytes );
+        }
+    }
+
+    /** \brief Scales the whole source surface into the destination surface
+     *
+     * \param pSrc SDL_Surface*
+     * \param pDst SDL_Surface*
+     * \param iScale int
+     * \return void
+     *
+     */
+    void CUpscaler::Scale( SDL_Surface* pSrc, SDL_Surface* pDst, int iScale ) const
+    {
+        SDL_Rect rect = { 0, 0, (Uint16)pSrc->w, (Uint16)pSrc->h };
+        Scale( pSrc, pDst, iScale, rect );
+    }
+
+    void CUpscaler::ScaleRow( const Uint8* src, Uint8* dst, int w, int iBytesPerPixel, int iScale ) const
+    {
+        switch ( iBytesPerPixel ) {
+            case 4:
+                #ifdef UPSCALER_SSE2
+                if ( m_bSSE2 ) {
+                    ScaleRow32SSE2( (const Uint32*)src, (Uint32*)dst, w, iScale );
+                    break;
+                }
+                #endif
+                ScaleRowT<Uint32>( (const Uint32*)src, (Uint32*)dst, w, iScale );
+                break;
+            case 2:
+                ScaleRowT<Uint16>( (const Uint16*)src, (Uint16*)dst, w, iScale );
+                break;
+            default:
+                ScaleRowBytes( src, dst, w, iBytesPerPixel, iScale );
+                break;
+        }
+    }
+
+}
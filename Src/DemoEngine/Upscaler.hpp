@@ -0,0 +1,58 @@
+/*
+ *     _/_/_/_/  _/                                      _/
+ *    _/            _/_/_/      _/_/_/    _/_/      _/_/_/  _/  _/_/
+ *   _/_/_/    _/  _/    _/  _/        _/    _/  _/    _/  _/_/
+ *  _/        _/  _/    _/  _/        _/    _/  _/    _/  _/
+ * _/        _/  _/    _/    _/_/_/    _/_/      _/_/_/  _/
+ *
+ * Copyright (c) 2012 Mika Luoma-aho <fincodr@mxl.fi>
+ *
+ * This source code and software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from the use of this source code or software.
+ *
+ * Permission is granted to anyone to use this software (and the source code when its released from the author)
+ * as a learning point to create games, including commercial applications.
+ *
+ * You are however subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software.
+ *    If you use this software's source code in a product,
+ *    an acknowledgment in the product documentation would be appreciated but is not required.
+ * 2. Altered versions must be plainly marked as such, and must not be misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any distribution.
+ *
+ */
+
+#ifndef UPSCALER_HPP
+#define UPSCALER_HPP
+
+#include <SDL.h>
+
+namespace DemoEngine {
+
+    /// Nearest neighbour integer upscaler used to present a low resolution render target in a
+    /// larger window. Every source pixel becomes an iScale x iScale block, rows are widened once
+    /// and then copied. 32-bit rows use SSE2 for 2x, 3x and 4x when the CPU supports it.
+    class CUpscaler
+    {
+        public:
+            CUpscaler();
+            virtual ~CUpscaler() {};
+
+            inline void SetSSE2( bool bSSE2 ) { m_bSSE2 = bSSE2 && m_bHasSSE2; }
+            inline bool IsSSE2() const { return m_bSSE2; }
+
+            void Scale( SDL_Surface* pSrc, SDL_Surface* pDst, int iScale, const SDL_Rect& rect ) const;
+            void Scale( SDL_Surface* pSrc, SDL_Surface* pDst, int iScale ) const;
+
+        protected:
+        private:
+            void ScaleRow( const Uint8* src, Uint8* dst, int w, int iBytesPerPixel, int iScale ) const;
+
+            bool m_bHasSSE2 = false;
+            bool m_bSSE2 = false;
+    };
+
+}
+
+#endif // UPSCALER_HPP
@@ -28,6 +28,7 @@
 
 #include "DemoEngine/Game.hpp"
 #include "DemoEngine/ImageAlpha.hpp"
+#include "DemoEngine/ShadowedSprite.hpp"
 #include "DemoEngine/GameObject.hpp"
 #include "DemoEngine/Rectangle.hpp"
 #include "ResourceIDs.hpp"
@@ -47,7 +48,7 @@ class EntityEnemy : public CGameObjectFloat
             // Load ship image
             auto& m_enemyShipImg = ImageAlphaFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_RED );
 
-            // TODO: Rotate ship image
+            // Size of the ship image
             m_iShipW = m_enemyShipImg->GetSurface()->w;
             m_iShipH = m_enemyShipImg->GetSurface()->h;
 
@@ -67,37 +68,45 @@ class EntityEnemy : public CGameObjectFloat
             #endif
         }
 
+        // The ship with room around it for the shadow (below right of it)
+        bool GetRenderBounds( SDL_Rect& rect ) override
+        {
+            if ( IsDead() ) {
+                rect.x = rect.y = 0;
+                rect.w = rect.h = 0;
+                return true;
+            }
+            rect.x = (int)GetX() - m_iShipW/2 - m_iShipW;
+            rect.y = (int)GetY() - m_iShipH/2 - m_iShipH;
+            rect.w = m_iShipW*3;
+            rect.h = m_iShipH*3;
+            return true;
+        }
+
         void Render( unique_ptr<CRenderer>& renderer ) override
         {
             if ( !IsDead() ) {
                 int m_iShipX = GetX() - m_iShipW/2;
                 int m_iShipY = GetY() - m_iShipH/2;
-                if ( ( m_iShipX < -m_iShipW*2 /* shadow too! */ ) ||
-                    ( m_iShipX > m_iScreenW+m_iShipW ) ||
-                    ( m_iShipY < -m_iShipH*2 /* shadow too */ ) ||
-                    ( m_iShipY > m_iScreenH+m_iShipH ) )
-                {
-                    // object is not visible, do nothing.
-                }
+                int nShipID;
+                if ( !m_bHit )
+                    nShipID = ( m_nEnemyType == 0 ? RESOURCE::ENEMY_PLANE_GREEN : RESOURCE::ENEMY_PLANE_RED );
                 else
+                    nShipID = ( m_nEnemyType == 0 ? RESOURCE::ENEMY_PLANE_GREEN_HIT : RESOURCE::ENEMY_PLANE_RED_HIT );
+                // Sprites with the shadow baked in draw both with one blit
+                auto& shadowed = ShadowedSpriteFactory::Instance()->Get( nShipID );
+                if ( !shadowed->IsEmpty() )
                 {
-                    ImageAlphaFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_SHADOW )->SetAlpha(50);
-                    renderer->Render( ImageAlphaFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_SHADOW ), m_iShipX + 45, m_iShipY + 55 );
-                    if ( !m_bHit )
-                    {
-                        if ( m_nEnemyType == 0 )
-                            renderer->Render( ImageAlphaFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_GREEN ), m_iShipX, m_iShipY );
-                        else
-                            renderer->Render( ImageAlphaFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_RED ), m_iShipX, m_iShipY );
-                    }
-                    else
-                    {
-                        if ( m_nEnemyType == 0 )
-                            renderer->Render( ImageAlphaFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_GREEN_HIT ), m_iShipX, m_iShipY );
-                        else
-                            renderer->Render( ImageAlphaFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_RED_HIT ), m_iShipX, m_iShipY );
-                    }
+                    renderer->Render( shadowed, 0, m_iShipX, m_iShipY );
+                    return;
                 }
+                int iLayer = renderer->GetLayer();
+                auto& shadowImg = ImageAlphaFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_SHADOW );
+                shadowImg->SetAlpha(50);
+                renderer->SetLayer( LAYER_SHADOWS );
+                renderer->Render( shadowImg, m_iShipX + 45, m_iShipY + 55 );
+                renderer->SetLayer( iLayer );
+                renderer->Render( ImageAlphaFactory::Instance()->Get( nShipID ), m_iShipX, m_iShipY );
             }
         }
 
@@ -110,9 +119,8 @@ class EntityEnemy : public CGameObjectFloat
                 int by = bb.GetY();
                 int bw = bb.GetWidth();
                 int bh = bb.GetHeight();
-                CRectangle r( bx, by, bw, bh );
-                r.SetColor( 255, 64, 64, 128 );
-                renderer->Render( &r );
+                SDL_Color c = { 255, 64, 64, 128 };
+                renderer->GetDebugBatch().AddRect( bx, by, bx + bw, by + bh, c );
                 Render( renderer );
             }
         }
@@ -121,6 +129,9 @@ class EntityEnemy : public CGameObjectFloat
         {
             DISCARD_UNUNSED_PARAMETER( fRealSeconds );
 
+            // Pooled entity waiting to be respawned, or moved by the activation zone while asleep
+            if ( IsDead() || IsSleeping() ) return;
+
             m_fTime += fSeconds;
 
             m_vPosition[0] += GetSpeed()[0] * fSeconds;
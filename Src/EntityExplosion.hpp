@@ -66,25 +66,32 @@ class EntityExplosion : public CGameObjectFloat
 
         void Fire();
 
+        bool GetRenderBounds( SDL_Rect& rect ) override
+        {
+            if ( IsDead() ) {
+                rect.x = rect.y = 0;
+                rect.w = rect.h = 0;
+                return true;
+            }
+            rect.x = (int)GetX() - m_iW/2;
+            rect.y = (int)GetY() - m_iH/2;
+            rect.w = m_iW;
+            rect.h = m_iH;
+            return true;
+        }
+
         void Render( unique_ptr<CRenderer>& renderer ) override
         {
             if ( !IsDead() ) {
                 int m_iX = GetX() - m_iW/2;
                 int m_iY = GetY() - m_iH/2;
-                if ( ( m_iX < -m_iW ) ||
-                    ( m_iX > m_iScreenW+m_iW ) ||
-                    ( m_iY < -m_iH ) ||
-                    ( m_iY > m_iScreenH+m_iH ) )
-                {
-                    // object is not visible, do nothing.
-                }
-                else
-                {
-                    auto& img = ImageAlphaFactory::Instance()->Get( RESOURCE::EXPLOSION );
-                    auto& anim = AnimationFactory::Instance()->Get( RESOURCE::EXPLOSION );
-                    auto& rect = anim->GetAnimationRect( kAnimationName, m_iFrame );
-                    renderer->Render( img, m_iX, m_iY, &rect );
-                }
+                auto& img = ImageAlphaFactory::Instance()->Get( RESOURCE::EXPLOSION );
+                auto& anim = AnimationFactory::Instance()->Get( RESOURCE::EXPLOSION );
+                auto& rect = anim->GetAnimationRect( kAnimationName, m_iFrame );
+                int iLayer = renderer->GetLayer();
+                renderer->SetLayer( LAYER_EFFECTS );
+                renderer->Render( img, m_iX, m_iY, &rect );
+                renderer->SetLayer( iLayer );
             }
         }
 
@@ -97,6 +104,9 @@ class EntityExplosion : public CGameObjectFloat
         {
             DISCARD_UNUNSED_PARAMETER( fRealSeconds );
 
+            // Pooled entity waiting to be respawned
+            if ( IsDead() ) return;
+
             m_fTime += fSeconds;
             m_iFrame = static_cast<int>(m_fTime * m_iFPS);
             if ( m_iFrame >= m_iFrames ) {
@@ -28,6 +28,7 @@
 
 #include "DemoEngine/Game.hpp"
 #include "DemoEngine/ImageAlpha.hpp"
+#include "DemoEngine/ShadowedSprite.hpp"
 #include "DemoEngine/GameObject.hpp"
 #include "ResourceIDs.hpp"
 
@@ -80,26 +81,21 @@ class EntityPlayer : public CGameObjectFloat
             m_bHit = true;
         }
 
+        // The mirrored copies can be anywhere on the screen, only a dead player is culled
+        bool GetRenderBounds( SDL_Rect& rect ) override
+        {
+            if ( !IsDead() ) return false;
+            rect.x = rect.y = 0;
+            rect.w = rect.h = 0;
+            return true;
+        }
+
         void Render( unique_ptr<CRenderer>& renderer ) override
         {
             if ( !IsDead() ) {
                 int m_iX = GetX();
                 int m_iY = GetY();
 
-                auto& m_playerShipImg = ImageAlphaFactory::Instance()->Get( RESOURCE::PLAYER_PLANE );
-                auto& m_playerShipImgHit = ImageAlphaFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_HIT );
-                auto& m_playerShipShadow = ImageAlphaFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_SHADOW );
-                auto& anim = AnimationFactory::Instance()->Get( RESOURCE::PLAYER_PLANE );
-                auto& animShadow = AnimationFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_SHADOW );
-                auto& rect = anim->GetAnimationRect( kAnimationName, m_iFrame );
-                auto& rectShadow = animShadow->GetAnimationRect( kAnimationName, m_iFrame );
-                m_playerShipShadow->SetAlpha(50);
-                renderer->Render( m_playerShipShadow, m_iX - (m_iW/2) + 45, m_iY - (m_iH/2) + 55, &rectShadow );
-                if ( !m_bHit )
-                    renderer->Render( m_playerShipImg, m_iX - (m_iW/2), m_iY - (m_iH/2), &rect );
-                else
-                    renderer->Render( m_playerShipImgHit, m_iX - (m_iW/2), m_iY - (m_iH/2), &rect );
-
                 // if we are at the edge we can mirror the ship to other side to simulate wrapping
                 // calculate where would be the mirror ships
                 // M1 = top-right
@@ -123,12 +119,48 @@ class EntityPlayer : public CGameObjectFloat
                 if ( M3y > m_iScreenH*2-m_iH/2 ) {
                     M3y = M3y - m_iScreenH*2;
                 }
-                renderer->Render( m_playerShipImg, M1x - (m_iW/2), M1y - (m_iH/2), &rect );
-                renderer->Render( m_playerShipShadow, M1x - (m_iW/2) + 45, M1y - (m_iH/2) + 55, &rectShadow );
-                renderer->Render( m_playerShipImg, M2x - (m_iW/2), M2y - (m_iH/2), &rect );
-                renderer->Render( m_playerShipShadow, M2x - (m_iW/2) + 45, M2y - (m_iH/2) + 55, &rectShadow );
-                renderer->Render( m_playerShipImg, M3x - (m_iW/2), M3y - (m_iH/2), &rect );
-                renderer->Render( m_playerShipShadow, M2x - (m_iW/2) + 45, M3y - (m_iH/2) + 55, &rectShadow );
+
+                // Mirrored copies (with their shadow) that are off the screen are skipped
+                bool bM1 = renderer->IsVisible( M1x - (m_iW/2), M1y - (m_iH/2), m_iW + 45, m_iH + 55 );
+                bool bM2 = renderer->IsVisible( M2x - (m_iW/2), M2y - (m_iH/2), m_iW + 45, m_iH + 55 );
+                bool bM3 = renderer->IsVisible( M3x - (m_iW/2), M3y - (m_iH/2), m_iW + 45, m_iH + 55 );
+
+                // The shadow baked into the frames, one blit per ship
+                auto& shadowed = ShadowedSpriteFactory::Instance()->Get( RESOURCE::PLAYER_PLANE );
+                if ( !shadowed->IsEmpty() )
+                {
+                    if ( !m_bHit )
+                        renderer->Render( shadowed, m_iFrame, m_iX - (m_iW/2), m_iY - (m_iH/2) );
+                    else
+                        renderer->Render( ShadowedSpriteFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_HIT ), m_iFrame, m_iX - (m_iW/2), m_iY - (m_iH/2) );
+                    if ( bM1 ) renderer->Render( shadowed, m_iFrame, M1x - (m_iW/2), M1y - (m_iH/2) );
+                    if ( bM2 ) renderer->Render( shadowed, m_iFrame, M2x - (m_iW/2), M2y - (m_iH/2) );
+                    if ( bM3 ) renderer->Render( shadowed, m_iFrame, M3x - (m_iW/2), M3y - (m_iH/2) );
+                    return;
+                }
+
+                auto& m_playerShipImg = ImageAlphaFactory::Instance()->Get( RESOURCE::PLAYER_PLANE );
+                auto& m_playerShipImgHit = ImageAlphaFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_HIT );
+                auto& m_playerShipShadow = ImageAlphaFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_SHADOW );
+                auto& anim = AnimationFactory::Instance()->Get( RESOURCE::PLAYER_PLANE );
+                auto& animShadow = AnimationFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_SHADOW );
+                auto& rect = anim->GetAnimationRect( kAnimationName, m_iFrame );
+                auto& rectShadow = animShadow->GetAnimationRect( kAnimationName, m_iFrame );
+                int iLayer = renderer->GetLayer();
+                m_playerShipShadow->SetAlpha(50);
+                renderer->SetLayer( LAYER_SHADOWS );
+                renderer->Render( m_playerShipShadow, m_iX - (m_iW/2) + 45, m_iY - (m_iH/2) + 55, &rectShadow );
+                if ( bM1 ) renderer->Render( m_playerShipShadow, M1x - (m_iW/2) + 45, M1y - (m_iH/2) + 55, &rectShadow );
+                if ( bM2 ) renderer->Render( m_playerShipShadow, M2x - (m_iW/2) + 45, M2y - (m_iH/2) + 55, &rectShadow );
+                if ( bM3 ) renderer->Render( m_playerShipShadow, M3x - (m_iW/2) + 45, M3y - (m_iH/2) + 55, &rectShadow );
+                renderer->SetLayer( iLayer );
+                if ( !m_bHit )
+                    renderer->Render( m_playerShipImg, m_iX - (m_iW/2), m_iY - (m_iH/2), &rect );
+                else
+                    renderer->Render( m_playerShipImgHit, m_iX - (m_iW/2), m_iY - (m_iH/2), &rect );
+                if ( bM1 ) renderer->Render( m_playerShipImg, M1x - (m_iW/2), M1y - (m_iH/2), &rect );
+                if ( bM2 ) renderer->Render( m_playerShipImg, M2x - (m_iW/2), M2y - (m_iH/2), &rect );
+                if ( bM3 ) renderer->Render( m_playerShipImg, M3x - (m_iW/2), M3y - (m_iH/2), &rect );
             }
 
         }
@@ -142,9 +174,8 @@ class EntityPlayer : public CGameObjectFloat
                 int by = bb.GetY();
                 int bw = bb.GetWidth();
                 int bh = bb.GetHeight();
-                CRectangle r( bx, by, bw, bh );
-                r.SetColor( 64, 255, 64, 128 );
-                renderer->Render( &r );
+                SDL_Color c = { 64, 255, 64, 128 };
+                renderer->GetDebugBatch().AddRect( bx, by, bx + bw, by + bh, c );
                 Render( renderer );
             }
         }
@@ -28,6 +28,7 @@
 
 #include "DemoEngine/Game.hpp"
 #include "DemoEngine/ImageAlpha.hpp"
+#include "DemoEngine/SpriteBank.hpp"
 #include "DemoEngine/GameObject.hpp"
 
 using namespace DemoEngine;
@@ -65,9 +66,40 @@ class EntityProjectile : public CGameObjectFloat
             bounds.SetPosition( 0, 0 );
         }
 
+        // The rotated variant that Render draws, or the plain image around the center
+        bool GetRenderBounds( SDL_Rect& rect ) override
+        {
+            if ( IsDead() ) {
+                rect.x = rect.y = 0;
+                rect.w = rect.h = 0;
+                return true;
+            }
+            auto& bank = SpriteBankFactory::Instance()->Get( m_nProjectileID );
+            if ( !bank->IsEmpty() ) {
+                size_t nIndex = bank->GetIndex( CSpriteBank::GetDirection( GetSpeed()[0], GetSpeed()[1] ) + 180 );
+                SDL_Surface* pSurface = bank->GetVariant( nIndex )->GetSurface();
+                rect.x = (int)GetX() - bank->GetCenterX( nIndex );
+                rect.y = (int)GetY() - bank->GetCenterY( nIndex );
+                rect.w = pSurface->w;
+                rect.h = pSurface->h;
+                return true;
+            }
+            rect.x = (int)GetX() - m_iW/2;
+            rect.y = (int)GetY() - m_iH/2;
+            rect.w = m_iW;
+            rect.h = m_iH;
+            return true;
+        }
+
         void Render( unique_ptr<CRenderer>& renderer ) override
         {
             if ( !IsDead() ) {
+                // Projectiles with a sprite bank are drawn facing up, turned towards the direction of travel
+                auto& bank = SpriteBankFactory::Instance()->Get( m_nProjectileID );
+                if ( !bank->IsEmpty() ) {
+                    renderer->Render( bank, GetX(), GetY(), CSpriteBank::GetDirection( GetSpeed()[0], GetSpeed()[1] ) + 180 );
+                    return;
+                }
                 int m_iX = GetX() - m_iW/2;
                 int m_iY = GetY() - m_iH/2;
                 renderer->Render( ImageAlphaFactory::Instance()->Get( m_nProjectileID ), m_iX, m_iY );
@@ -83,9 +115,8 @@ class EntityProjectile : public CGameObjectFloat
                 int by = bb.GetY();
                 int bw = bb.GetWidth();
                 int bh = bb.GetHeight();
-                CRectangle r( bx, by, bw, bh );
-                r.SetColor( 64, 64, 255, 128 );
-                renderer->Render( &r );
+                SDL_Color c = { 64, 64, 255, 128 };
+                renderer->GetDebugBatch().AddRect( bx, by, bx + bw, by + bh, c );
                 Render( renderer );
 
                 #ifdef DEBUGMORE
@@ -105,6 +136,9 @@ class EntityProjectile : public CGameObjectFloat
         {
             DISCARD_UNUNSED_PARAMETER( fRealSeconds );
 
+            // Pooled entity waiting to be respawned
+            if ( IsDead() ) return;
+
             // Update position and calculate new velocity
             m_vPosition[0] += GetSpeed()[0] * fSeconds;
             m_vPosition[1] += GetSpeed()[1] * fSeconds;
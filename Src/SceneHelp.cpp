@@ -27,6 +27,7 @@
 
 void SceneHelp::Initialize() {
     cout << "SceneHelp::Initialize() called" << endl;
+    SetDirtyRectangles( true );
     InitHandlers();
     SetInitialized( true );
 }
@@ -104,6 +105,8 @@ void SceneHelp::InitHandlers()
                 {
                     SetState( (int)STATE::DISPLAY_PAGE2 );
                     m_bDisplayNote = true;
+                    // The cached pages are not needed anymore
+                    CSingleton<CRenderer>::Instance()->GetTransition().Release();
                 }
             }
 
@@ -140,6 +143,10 @@ void SceneHelp::InitHandlers()
             (int)STATE::DISPLAY,
             [&](SDL_Event& ev){
                 if ( ev.key.keysym.sym == SDLK_SPACE || ev.key.keysym.sym == SDLK_RETURN ) {
+                    // Cache both pages in the screen format for the crossfade
+                    auto& renderer = CSingleton<CRenderer>::Instance();
+                    renderer->CaptureFrame( CTransition::FRAME_FROM, ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_HELP1 )->GetSurface() );
+                    renderer->CaptureFrame( CTransition::FRAME_TO, ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_HELP2 )->GetSurface() );
                     SetState( (int)STATE::FADE_TO_PAGE2 );
                     m_bDisplayNote = false;
                     TimerFactory::Instance()->Get( RESOURCE::TIMER_SCENE_FADEIN )->Reset();
@@ -172,7 +179,7 @@ void SceneHelp::InitHandlers()
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
                 ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_HELP1 )->SetAlpha( m_iScreenAlpha );
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP1 ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP1 ) );
                 if ( m_bDisplayNote ) renderer->Render( TextFactory::Instance()->Get( RESOURCE::TEXT_SPACE_TO_CONTINUE ), m_iScreenW/2-m_noteImgWidth/2, m_iScreenH-35 );
             }
         },
@@ -185,7 +192,7 @@ void SceneHelp::InitHandlers()
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
                 ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_HELP1 )->SetAlpha( 255 );
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP1 ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP1 ) );
                 if ( m_bDisplayNote ) renderer->Render( TextFactory::Instance()->Get( RESOURCE::TEXT_SPACE_TO_CONTINUE ), m_iScreenW/2-m_noteImgWidth/2, m_iScreenH-35 );
             }
         },
@@ -197,10 +204,7 @@ void SceneHelp::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_HELP1 )->SetAlpha( 255-m_iScreenAlpha );
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP1 ), 0, 0 );
-                ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_HELP2 )->SetAlpha( m_iScreenAlpha );
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP2 ), 0, 0 );
+                renderer->RenderCrossfade( CTransition::FRAME_FROM, CTransition::FRAME_TO, m_iScreenAlpha );
             }
         },
         {
@@ -212,7 +216,7 @@ void SceneHelp::InitHandlers()
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
                 ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_HELP2 )->SetAlpha( 255 );
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP2 ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP2 ) );
                 if ( m_bDisplayNote ) renderer->Render( TextFactory::Instance()->Get( RESOURCE::TEXT_SPACE_TO_CONTINUE ), m_iScreenW/2-m_noteImgWidth/2, m_iScreenH-35 );
             }
         },
@@ -225,7 +229,7 @@ void SceneHelp::InitHandlers()
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
                 ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_HELP2 )->SetAlpha( m_iScreenAlpha );
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP2 ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_HELP2 ) );
             }
         }
     };
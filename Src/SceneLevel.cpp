@@ -69,9 +69,24 @@ void SceneLevel::OnEnter()
     m_iScreenW = screen->w;
     m_iScreenH = screen->h;
 
-    m_blankImg.SetWidth(m_iScreenW);
-    m_blankImg.SetHeight(m_iScreenH);
-    m_blankImg.SetPosition(0,0);
+    m_EnemyGrid.Resize( m_iScreenW, m_iScreenH );
+
+    // HUD widgets are drawn into cached surfaces and updated only when their values change
+    m_pHudScore = make_shared<CHudText>( FontFactory::Instance()->Get( RESOURCE::FONT_SCORE ), 255, 255, 255, m_iScreenW - 10, 10, CHudText::ALIGN_RIGHT );
+    m_pHudShields = make_shared<CHudBar>( 32, m_iScreenH - 32, 6 );
+    m_pHudShields->SetColors( { 130, 200, 130, 128 }, { 64, 255, 64, 128 }, { 0, 64, 0, 128 } );
+    m_pHudEnergy = make_shared<CHudBar>( 32, m_iScreenH - 32 + 10, 6 );
+    m_pHudEnergy->SetColors( { 180, 180, 180, 128 }, { 200, 200, 200, 128 }, { 100, 100, 100, 128 } );
+    m_HudScore.Clear();
+    m_HudScore.Add( m_pHudScore );
+    m_HudStatus.Clear();
+    m_HudStatus.Add( m_pHudShields );
+    m_HudStatus.Add( m_pHudEnergy );
+
+    // Enemies sleep until they are closer than the margin to the screen
+    int iActivationMargin = (Uint32)CSingleton<CProperties>::Instance()->Property( "Game", "ActivationMargin", (Uint32)kDefaultActivationMargin );
+    m_EnemyZone.SetBounds( 0, 0, m_iScreenW, m_iScreenH, iActivationMargin );
+    m_fSceneTime = 0.0f;
 
     // Create player entity
     m_pPlayer = make_shared<EntityPlayer>();
@@ -97,6 +112,9 @@ void SceneLevel::OnEnter()
     preRenderables = { { moonLayer->GetID(), moonLayer } };
     postRenderables = { { cloudsLayer->GetID(), cloudsLayer } };
 
+    // Allocate all entities before the level starts
+    PrewarmPools();
+
     SetState( (int)STATE::START );
 
     // Reset score
@@ -107,6 +125,7 @@ void SceneLevel::OnEnter()
     m_level = 1;
     m_levelOld = -1;
     m_bLevelStarted = false;
+    BuildPatterns();
 
     // Reset statistics
     m_iEnemyKilled = 0;
@@ -157,6 +176,12 @@ void SceneLevel::OnExit()
     m_umapDeadBullets.clear();
     m_umapExplosions.clear();
     m_umapDeadExplosions.clear();
+    m_vPendingPooled.clear();
+    m_EnemyGrid.Clear();
+    m_EnemyZone.Clear();
+    m_vFiringEnemies.clear();
+    m_vFiringOrigins.clear();
+    m_vProjectileSpawns.clear();
 }
 
 void SceneLevel::NextLevel()
@@ -164,6 +189,7 @@ void SceneLevel::NextLevel()
     m_level++;
     m_iEnemyKilled = 0;
     m_bLevelStarted = false;
+    BuildPatterns();
 
     // add bullet time
     m_iPlayerBulletTimeMax += kBulletTimeAdder;
@@ -178,26 +204,134 @@ void SceneLevel::NextLevel()
     m_pPlayer->SetHealth( nHealth );
 }
 
+/** \brief Fills the bullet, enemy and explosion pools up to the capacities set in
+ * properties (Pools/Bullets, Pools/Enemies and Pools/Explosions).
+ *
+ * The pooled objects are registered once to the object maps and to the updateables and
+ * renderables, they stay there for the whole scene and are only toggled dead/alive, so
+ * no allocations are needed during play. Dead objects push themselves to the free lists.
+ *
+ * \return void
+ *
+ */
+void SceneLevel::PrewarmPools()
+{
+    auto& properties = CSingleton<CProperties>::Instance();
+    size_t nBullets = (Uint32)properties->Property( "Pools", "Bullets", (Uint32)kDefaultBulletPool );
+    size_t nEnemies = (Uint32)properties->Property( "Pools", "Enemies", (Uint32)kDefaultEnemyPool );
+    size_t nExplosions = (Uint32)properties->Property( "Pools", "Explosions", (Uint32)kDefaultExplosionPool );
+
+    // Reserve buckets so the maps never rehash during play
+    m_umapBullets.reserve( nBullets );
+    m_umapEnemies.reserve( nEnemies );
+    m_umapExplosions.reserve( nExplosions );
+    GetUpdateables().reserve( nBullets + nEnemies + nExplosions + 8 );
+    GetRenderables().reserve( nBullets + nEnemies + nExplosions + 8 );
+
+    m_umapDeadBullets.reserve( nBullets );
+    m_umapDeadEnemies.reserve( nEnemies );
+    m_umapDeadExplosions.reserve( nExplosions );
+
+    m_vPendingPooled.reserve( nBullets + nEnemies + nExplosions );
+
+    while ( m_umapBullets.size() < nBullets ) {
+        auto pBullet = make_shared<EntityProjectile>();
+        AddPooled( pBullet, m_umapBullets, m_umapDeadBullets );
+        pBullet->SetDead( true );
+    }
+    while ( m_umapEnemies.size() < nEnemies ) {
+        auto pEnemy = make_shared<EntityEnemy>();
+        AddPooled( pEnemy, m_umapEnemies, m_umapDeadEnemies );
+        pEnemy->SetDead( true );
+    }
+    while ( m_umapExplosions.size() < nExplosions ) {
+        auto pExplosion = make_shared<EntityExplosion>();
+        AddPooled( pExplosion, m_umapExplosions, m_umapDeadExplosions );
+        pExplosion->SetDead( true );
+    }
+    RegisterPooled();
+
+    m_vFiringEnemies.reserve( nEnemies );
+    m_vFiringOrigins.reserve( nEnemies );
+    m_EnemyZone.Reserve( nEnemies );
+    m_vProjectileSpawns.reserve( nBullets );
+
+    #ifdef DEBUG_ALLOCATIONS
+    m_nAllocationFrames = 0;
+    #endif
+}
+
+/** \brief Rebuilds the spatial index used for target queries from the enemies that are alive and on screen.
+ *
+ * \return void
+ *
+ */
+void SceneLevel::UpdateTargetGrid()
+{
+    m_EnemyGrid.Clear();
+    for ( auto& enemy : m_umapEnemies ) {
+        if ( enemy.second->GetY() > 0 && !enemy.second->IsDead() && !enemy.second->IsSleeping() ) {
+            m_EnemyGrid.Insert( enemy.second, enemy.second->GetX(), enemy.second->GetY() );
+        }
+    }
+}
+
+/** \brief Adds an object to a pool.
+ *
+ * The object is added to the object map and gets the free list of the pool right away, it is
+ * added to the updateables and renderables by RegisterPooled (they may be iterated while
+ * objects are respawned). The object stays registered while it is dead, the entities skip
+ * themselves until respawned.
+ *
+ * \param pObject const shared_ptr<GameObject_t>&
+ * \param objects GameObjectList_t& Object map of the pool
+ * \param deadObjects DeadGameObjectList_t& Free list of the pool
+ * \return void
+ *
+ */
+void SceneLevel::AddPooled( const shared_ptr<GameObject_t>& pObject, GameObjectList_t& objects, DeadGameObjectList_t& deadObjects )
+{
+    objects[pObject->GetID()] = pObject;
+    pObject->SetFreeList( &deadObjects );
+    m_vPendingPooled.push_back( pObject );
+}
+
+/** \brief Adds the objects added to the pools since the last call to the updateables and renderables.
+ *
+ * \return void
+ *
+ */
+void SceneLevel::RegisterPooled()
+{
+    auto& updateables = GetUpdateables();
+    auto& renderables = GetRenderables();
+    for ( auto& pObject : m_vPendingPooled ) {
+        int objID = pObject->GetID();
+        updateables[objID] = pObject;
+        renderables[objID] = pObject;
+    }
+    m_vPendingPooled.clear();
+}
+
 shared_ptr<GameObject_t> SceneLevel::RespawnBullet()
 {
     // Do we have dead bullet that we can use?
     if ( !m_umapDeadBullets.empty() ) {
         // Reuse dead bullet
-        auto m_pBullet1 = m_umapDeadBullets.front();
+        auto m_pBullet1 = m_umapBullets[m_umapDeadBullets.back()];
         m_pBullet1->SetDead( false );
         // remove from list
-        m_umapDeadBullets.pop_front();
+        m_umapDeadBullets.pop_back();
         #ifdef DEBUG
         cout << "Reactivating bullet with ID " << m_pBullet1->GetID() << endl;
         #endif
-        m_umapBullets[ m_pBullet1->GetID() ] = m_pBullet1;
         return ( m_pBullet1 );
     }
     else
     {
         // Instantiate new bullet
         auto m_pBullet1 = make_shared<EntityProjectile>();
-        m_umapBullets[ m_pBullet1->GetID() ] = m_pBullet1;
+        AddPooled( m_pBullet1, m_umapBullets, m_umapDeadBullets );
         return ( m_pBullet1 );
     }
 }
@@ -207,21 +341,22 @@ shared_ptr<GameObject_t> SceneLevel::RespawnEnemy()
     // Do we have dead enemy that we can use?
     if ( !m_umapDeadEnemies.empty() ) {
         // Reuse dead enemy
-        auto m_pEnemy = m_umapDeadEnemies.front();
+        auto m_pEnemy = m_umapEnemies[m_umapDeadEnemies.back()];
         m_pEnemy->SetDead( false );
         // remove from list
-        m_umapDeadEnemies.pop_front();
+        m_umapDeadEnemies.pop_back();
+        // the enemy may have died while sleeping
+        if ( m_pEnemy->IsSleeping() ) m_EnemyZone.Remove( m_pEnemy );
         #ifdef DEBUG
         cout << "Reactivating enemy with ID " << m_pEnemy->GetID() << endl;
         #endif
-        m_umapEnemies[ m_pEnemy->GetID() ] = m_pEnemy;
         return ( m_pEnemy );
     }
     else
     {
         // Instantiate new enemy
         auto m_pEnemy = make_shared<EntityEnemy>();
-        m_umapEnemies[ m_pEnemy->GetID() ] = m_pEnemy;
+        AddPooled( m_pEnemy, m_umapEnemies, m_umapDeadEnemies );
         return ( m_pEnemy );
     }
 }
@@ -231,25 +366,115 @@ shared_ptr<GameObject_t> SceneLevel::RespawnExplosion()
     // Do we have dead explosion that we can use?
     if ( !m_umapDeadExplosions.empty() ) {
         // Reuse dead explosion
-        auto m_pExplosion = std::static_pointer_cast<EntityExplosion>(m_umapDeadExplosions.front());
+        auto m_pExplosion = std::static_pointer_cast<EntityExplosion>(m_umapExplosions[m_umapDeadExplosions.back()]);
         // remove from list
-        m_umapDeadExplosions.pop_front();
+        m_umapDeadExplosions.pop_back();
         #ifdef DEBUG
         cout << "Reactivating explosion with ID " << m_pExplosion->GetID() << endl;
         #endif
         m_pExplosion->SetFrame( 0 );
         m_pExplosion->SetDead( false );
-        m_umapExplosions[ m_pExplosion->GetID() ] = m_pExplosion;
         return ( m_pExplosion );
     }
     else
     {
         // Instantiate new explosion
         auto m_pExplosion = make_shared<EntityExplosion>();
-        m_umapExplosions[ m_pExplosion->GetID() ] = m_pExplosion;
+        AddPooled( m_pExplosion, m_umapExplosions, m_umapDeadExplosions );
         return ( m_pExplosion );
     }
 }
+
+/** \brief Compiles the player and enemy bullet patterns for the current level.
+ *
+ * \return void
+ *
+ */
+void SceneLevel::BuildPatterns()
+{
+    // Player: one bullet on first levels, two after that
+    CBulletPattern player;
+    player.fAngle = 180;
+    player.fOffsetY = -5;
+    player.nCount = ( m_level <= 2 ) ? 1 : 2;
+    player.fSpacing = 24;
+    player.fSpeed = 300 + Math::Limits::clampmax<int>(m_level*100,700);
+    player.nProjectile = RESOURCE::PLAYER_PROJECTILE;
+    player.nDamage = kBulletDamage;
+
+    if ( m_level > 8 )
+    {
+        // Diagonal bullets (-350,-1000) and (350,-1000)
+        CBulletPattern diagonal;
+        diagonal.nCount = 2;
+        diagonal.fSpacing = 24;
+        diagonal.fSpread = 2 * atan2( 350.0f, 1000.0f ) * 180 / Math::kPI;
+        diagonal.fSpeed = sqrt( 350.0f*350.0f + 1000.0f*1000.0f );
+        diagonal.nProjectile = RESOURCE::PLAYER_PROJECTILE;
+        diagonal.nDamage = kBulletDamage;
+        player.vSubEmitters.push_back( diagonal );
+    }
+
+    if ( m_level > 12 )
+    {
+        // Guided projectile aimed at the closest enemy
+        CBulletPattern guided;
+        guided.fOffsetY = 10;
+        guided.bAimed = true;
+        guided.nEvery = 10-Math::Limits::clampmax<int>(m_level-12,5);
+        guided.fSpeed = 300 + Math::Limits::clampmax<int>((m_level-12)*10,500);
+        guided.nProjectile = RESOURCE::PLAYER_PROJECTILE_GUIDED;
+        guided.nDamage = kGuidedBulletDamage;
+        player.vSubEmitters.push_back( guided );
+    }
+
+    #ifdef DEBUG
+    if ( m_bStressPattern )
+    {
+        // Rotating ring with a counter rotating inner ring for stress testing
+        CBulletPattern ring;
+        ring.nCount = 36;
+        ring.fSpread = 350;
+        ring.fRotationSpeed = 7;
+        ring.fSpeed = 250;
+        ring.nProjectile = RESOURCE::PLAYER_PROJECTILE_GUIDED;
+        ring.nDamage = kBulletDamage;
+        CBulletPattern inner = ring;
+        inner.nCount = 12;
+        inner.fSpread = 330;
+        inner.fRotationSpeed = -14;
+        inner.fSpeed = 150;
+        ring.vSubEmitters.push_back( inner );
+        player.vSubEmitters.push_back( ring );
+    }
+    #endif
+
+    m_PlayerPattern.Compile( player );
+
+    // Easy enemy: straight forward on the first levels, then aimed with a lot of variation but only forward
+    CBulletPattern easy;
+    easy.fOffsetY = 3;
+    easy.fSpeed = 100 + Math::Limits::clampmax<int>(m_level*10,300);
+    easy.bAimed = ( m_level >= 3 );
+    easy.bForwardOnly = true;
+    easy.iJitter = easy.bAimed ? 45 - Math::Limits::clampmax<int>(m_level*2,44) : 0;
+    easy.nProjectile = RESOURCE::ENEMY_PROJECTILE_SLOW;
+    easy.nDamage = kBulletDamage;
+
+    // Hard enemy: aimed (not that much variation)
+    CBulletPattern hard;
+    hard.fOffsetY = 3;
+    hard.fSpeed = 300 + Math::Limits::clampmax<int>(m_level*10,100);
+    hard.bAimed = true;
+    hard.iJitter = 20 - Math::Limits::clampmax<int>(m_level*2,19);
+    hard.nProjectile = RESOURCE::ENEMY_PROJECTILE_FAST;
+    hard.nDamage = kBulletDamage;
+
+    m_vEnemyPatterns.resize( 2 );
+    m_vEnemyPatterns[0].Compile( easy );
+    m_vEnemyPatterns[1].Compile( hard );
+}
+
 /** \brief
  *
  * \return void
@@ -264,230 +489,89 @@ void SceneLevel::PlayerFire()
         auto& sound = CSingleton<CSoundServer>::Instance();
         sound->Play( RESOURCE::SOUND_PLAYER_FIRE );
 
-        // Add to updateable and renderable list
-        auto& updateables = GetUpdateables();
-        auto& renderables = GetRenderables();
-
-        int objID;
-
-        int X = m_pPlayer->GetX();
-        int Y = m_pPlayer->GetY();
-
-        int iBulletDelta = 12;
+        // Target the enemy closest to the player (for guided projectiles)
+        CBulletPatternProgram::Target_t target;
+        CBulletPatternProgram::Target_t* pTarget = nullptr;
+        GameObjectGrid_t::Result_t nearest = { nullptr, 0.0f };
+        if ( m_PlayerPattern.IsAimed() && m_EnemyGrid.Nearest( m_pPlayer->GetX(), m_pPlayer->GetY(), nearest ) ) {
+            target.x = nearest.item->GetX();
+            target.y = nearest.item->GetY();
+            target.vx = nearest.item->GetSpeed()[0];
+            target.vy = nearest.item->GetSpeed()[1];
+            target.fMinX = -99999.0f;
+            target.fMaxX = 99999.0f;
+            pTarget = &target;
+        }
 
-        if ( m_level <= 2 ) {
+        m_vProjectileSpawns.clear();
+        m_iPlayerFiredTotal += m_PlayerPattern.Execute( m_pPlayer->GetX(), m_pPlayer->GetY(), m_iPlayerFireCount, pTarget, m_pPlayer->GetID(), m_vProjectileSpawns );
+        SpawnProjectiles();
+    }
+}
 
-            shared_ptr<EntityProjectile> m_pBullet1 = std::dynamic_pointer_cast<EntityProjectile>(RespawnBullet());
-            m_pBullet1->SetPosition( X, Y-5 );
-            m_pBullet1->UpdateBoundingBox();
-            m_pBullet1->SetOwner( m_pPlayer->GetID() );
-            m_pBullet1->SetSpeed( 0, -300 - Math::Limits::clampmax<int>(m_level*100,700) );
-            m_pBullet1->SetProjectile( RESOURCE::PLAYER_PROJECTILE );
-            m_pBullet1->SetHealth( kBulletDamage );
-            objID = m_pBullet1->GetID();
-            updateables[objID] = m_pBullet1;
-            renderables[objID] = m_pBullet1;
-            m_iPlayerFiredTotal++;
-        }
-        else
-        {
-            shared_ptr<EntityProjectile> m_pBullet1 = std::dynamic_pointer_cast<EntityProjectile>(RespawnBullet());
-            m_pBullet1->SetPosition( X-iBulletDelta, Y-5 );
-            m_pBullet1->UpdateBoundingBox();
-            m_pBullet1->SetOwner( m_pPlayer->GetID() );
-            m_pBullet1->SetSpeed( 0, -300 - Math::Limits::clampmax<int>(m_level*100,700) );
-            m_pBullet1->SetProjectile( RESOURCE::PLAYER_PROJECTILE );
-            m_pBullet1->SetHealth( kBulletDamage );
-            objID = m_pBullet1->GetID();
-            updateables[objID] = m_pBullet1;
-            renderables[objID] = m_pBullet1;
-            m_iPlayerFiredTotal++;
-
-            shared_ptr<EntityProjectile> m_pBullet2 = std::dynamic_pointer_cast<EntityProjectile>(RespawnBullet());
-            m_pBullet2->SetPosition( X+iBulletDelta, Y-5 );
-            m_pBullet2->UpdateBoundingBox();
-            m_pBullet2->SetOwner( m_pPlayer->GetID() );
-            m_pBullet2->SetSpeed( 0, -300 - Math::Limits::clampmax<int>(m_level*100,700) );
-            m_pBullet2->SetProjectile( RESOURCE::PLAYER_PROJECTILE );
-            m_pBullet2->SetHealth( kBulletDamage );
-            objID = m_pBullet2->GetID();
-            updateables[objID] = m_pBullet2;
-            renderables[objID] = m_pBullet2;
-            m_iPlayerFiredTotal++;
-        }
+/** \brief Fires projectiles from all enemies queued in m_vFiringEnemies in one batch per enemy pattern.
+ *
+ * \return void
+ *
+ */
+void SceneLevel::EnemyFire()
+{
+    if ( m_vFiringEnemies.empty() ) {
+        return;
+    }
 
-        if ( m_level > 8 )
-        {
+    m_vProjectileSpawns.clear();
 
-            shared_ptr<EntityProjectile> m_pBullet3 = std::dynamic_pointer_cast<EntityProjectile>(RespawnBullet());
-            m_pBullet3->SetPosition( X-iBulletDelta, Y-5 );
-            m_pBullet3->UpdateBoundingBox();
-            m_pBullet3->SetOwner( m_pPlayer->GetID() );
-            m_pBullet3->SetSpeed( -350, -1000 );
-            m_pBullet3->SetProjectile( RESOURCE::PLAYER_PROJECTILE );
-            m_pBullet3->SetHealth( kBulletDamage );
-            objID = m_pBullet3->GetID();
-            updateables[objID] = m_pBullet3;
-            renderables[objID] = m_pBullet3;
-            m_iPlayerFiredTotal++;
-
-            shared_ptr<EntityProjectile> m_pBullet4 = std::dynamic_pointer_cast<EntityProjectile>(RespawnBullet());
-            m_pBullet4->SetPosition( X+iBulletDelta, Y-5 );
-            m_pBullet4->UpdateBoundingBox();
-            m_pBullet4->SetOwner( m_pPlayer->GetID() );
-            m_pBullet4->SetSpeed( 350, -1000 );
-            m_pBullet4->SetProjectile( RESOURCE::PLAYER_PROJECTILE );
-            m_pBullet4->SetHealth( kBulletDamage );
-            objID = m_pBullet4->GetID();
-            updateables[objID] = m_pBullet4;
-            renderables[objID] = m_pBullet4;
-            m_iPlayerFiredTotal++;
-        }
+    if ( !m_pPlayer->IsDead() ) {
 
-        int x2 = -1;
-        int y2 = -1;
-        float fDistanceMin = 99999.0f;
-        int xs = -1;
-        int ys = -1;
-        if ( m_level > 12 ) {
-            // Guided projectile for player
-            // Check which enemy is the closest to the player
-            // check collision between enemy and player
-            for ( auto& enemy : m_umapEnemies ) {
-                // is the enemy alive and on screen?
-                if ( enemy.second->GetY() > 0 && !enemy.second->IsDead() ) {
-                    float fDistance = Math::Coordinates::GetDistance( X, Y, enemy.second->GetX(), enemy.second->GetY() );
-                    if ( fDistance < fDistanceMin )
-                    {
-                        fDistanceMin = fDistance;
-                        x2 = enemy.second->GetX();
-                        y2 = enemy.second->GetY();
-                        xs = enemy.second->GetSpeed()[0];
-                        ys = enemy.second->GetSpeed()[1];
-                    }
-                }
+        // Every enemy aims at the same player position this frame
+        CBulletPatternProgram::Target_t target;
+        target.x = m_pPlayer->GetX();
+        target.y = m_pPlayer->GetY();
+        target.vx = Math::Limits::clampmax<float>(m_pPlayer->GetSpeed()[0],250.f);
+        target.vy = Math::Limits::clampmax<float>(m_pPlayer->GetSpeed()[1],250.f);
+        target.fMinX = 0;
+        target.fMaxX = m_iScreenW-1;
+
+        // Each enemy pattern is run once for all the enemies using it
+        for ( size_t nPattern = 0; nPattern < m_vEnemyPatterns.size(); ++nPattern ) {
+            m_vFiringOrigins.clear();
+            for ( auto& enemy : m_vFiringEnemies ) {
+                if ( enemy->IsDead() || (size_t)std::static_pointer_cast<EntityEnemy>(enemy)->GetEnemyType() != nPattern ) continue;
+                CBulletPatternProgram::Origin_t origin = { (float)enemy->GetX(), (float)enemy->GetY(), enemy->GetID() };
+                m_vFiringOrigins.push_back( origin );
             }
-        }
-
-        if ( x2 != -1 && ( m_iPlayerFireCount% (10-Math::Limits::clampmax<int>(m_level-12,5))==0) && m_level > 12 )
-        {
-            shared_ptr<EntityProjectile> m_pBullet5 = std::dynamic_pointer_cast<EntityProjectile>(RespawnBullet());
-            m_pBullet5->SetPosition( X, Y+5 );
-            m_pBullet5->UpdateBoundingBox();
-            m_pBullet5->SetOwner( m_pPlayer->GetID() );
-            m_pBullet5->SetProjectile( RESOURCE::PLAYER_PROJECTILE_GUIDED );
-            m_pBullet5->SetHealth( kGuidedBulletDamage );
-            float fProjectileSpeed = 300.0f + Math::Limits::clampmax<int>((m_level-12)*10,500);
-            float fFlyTime = fDistanceMin / fProjectileSpeed;
-            int x3 = x2 + xs*fFlyTime;
-            int y3 = y2 + ys*fFlyTime;
-            // Direct bullets to player position
-            float degrees = Math::Coordinates::GetAngleForLine( X, Y+5, x3, y3 );
-            float radians = ((float)degrees-180) * DemoEngine::Math::kPI / 180;
-            m_pBullet5->SetSpeed( sin(radians)*fProjectileSpeed, cos(radians)*fProjectileSpeed );
-            objID = m_pBullet5->GetID();
-            updateables[objID] = m_pBullet5;
-            renderables[objID] = m_pBullet5;
-            m_iPlayerFiredTotal++;
+            m_vEnemyPatterns[nPattern].Execute( m_vFiringOrigins, 0, &target, m_vProjectileSpawns );
         }
     }
-}
-
-void SceneLevel::EnemyFire( shared_ptr<GameObject_t> enemy )
-{
-    if ( !enemy->IsDead() && !m_pPlayer->IsDead() ) {
 
-        auto enemyClass = std::static_pointer_cast<EntityEnemy>(enemy);
+    m_vFiringEnemies.clear();
 
+    if ( !m_vProjectileSpawns.empty() ) {
         auto& sound = CSingleton<CSoundServer>::Instance();
         sound->Play( RESOURCE::SOUND_ENEMY_FIRE );
+        SpawnProjectiles();
+    }
+}
 
-        auto m_pBullet1 = std::dynamic_pointer_cast<EntityProjectile>(RespawnBullet());
-
-        int m_iX = enemy->GetX();
-        int m_iY = enemy->GetY();
-        int m_iX2 = m_pPlayer->GetX();
-        int m_iY2 = m_pPlayer->GetY();
-        m_pBullet1->SetPosition( m_iX, m_iY+3 );
-        m_pBullet1->SetHealth( kBulletDamage );
-
-        int nEnemyType = enemyClass->GetEnemyType();
-
-        float fProjectileSpeed;
-        if ( nEnemyType == 0 )
-        {
-            if ( m_level < 3 )
-            {
-                fProjectileSpeed = 100.0f + Math::Limits::clampmax<int>(m_level*10,300);
-                // Direct bullets to random positions (only forward of enemy plane)
-                float degrees = 180; //90 + rand()%180;
-                float radians = ((float)degrees-180) * DemoEngine::Math::kPI / 180;
-                m_pBullet1->SetSpeed( sin(radians)*fProjectileSpeed, cos(radians)*fProjectileSpeed );
-            }
-            else
-            {
-                fProjectileSpeed = 100.0f + Math::Limits::clampmax<int>(m_level*10,300);
-                float fDistance = Math::Coordinates::GetDistance( m_iX, m_iY+3, m_iX2, m_iY2 );
-                float fFlyTime = fDistance / fProjectileSpeed;
-                int m_iX3 = m_iX2 + Math::Limits::clampmax<float>(m_pPlayer->GetSpeed()[0],250.f)*fFlyTime;
-                int m_iY3 = m_iY2 + Math::Limits::clampmax<float>(m_pPlayer->GetSpeed()[1],250.f)*fFlyTime;
-                // if the calculated x position is outside of the screen we should just fire at the player position instead
-                if ( m_iX3 < 0 || m_iX3 > m_iScreenW-1 )
-                {
-                    m_iX3 = m_iX2;
-                    m_iY3 = m_iY2;
-                }
-                // Direct bullets to player position
-                float degrees = Math::Coordinates::GetAngleForLine( m_iX, m_iY+3, m_iX3, m_iY3 );
-                // randomize accuracy a bit
-                int randDegreesMax = 45 - Math::Limits::clampmax<int>(m_level*2,44);
-                degrees += -randDegreesMax/2 + rand()%randDegreesMax;
-                // only shoot forward (so degrees must be >90 and <270
-                if ( degrees < 90 || degrees > 270 )
-                {
-                    degrees = 180;
-                }
-                float radians = ((float)degrees-180) * DemoEngine::Math::kPI / 180;
-                m_pBullet1->SetSpeed( sin(radians)*fProjectileSpeed, cos(radians)*fProjectileSpeed );
-            }
-        }
-        else
-        {
-            fProjectileSpeed = 300.0f + Math::Limits::clampmax<int>(m_level*10,100);
-            float fDistance = Math::Coordinates::GetDistance( m_iX, m_iY+3, m_iX2, m_iY2 );
-            float fFlyTime = fDistance / fProjectileSpeed;
-            int m_iX3 = m_iX2 + Math::Limits::clampmax<float>(m_pPlayer->GetSpeed()[0],250.f)*fFlyTime;
-            int m_iY3 = m_iY2 + Math::Limits::clampmax<float>(m_pPlayer->GetSpeed()[1],250.f)*fFlyTime;
-            // if the calculated x position is outside of the screen we should just fire at the player position instead
-            if ( m_iX3 < 0 || m_iX3 > m_iScreenW-1 )
-            {
-                m_iX3 = m_iX2;
-                m_iY3 = m_iY2;
-            }
-            // Direct bullets to player position
-            float degrees = Math::Coordinates::GetAngleForLine( m_iX, m_iY+3, m_iX3, m_iY3 );
-            // randomize accuracy a bit (not that much for harded enemies)
-            int randDegreesMax = 20 - Math::Limits::clampmax<int>(m_level*2,19);
-            degrees += -randDegreesMax/2 + rand()%randDegreesMax;
-            float radians = ((float)degrees-180) * DemoEngine::Math::kPI / 180;
-            m_pBullet1->SetSpeed( sin(radians)*fProjectileSpeed, cos(radians)*fProjectileSpeed );
-        }
-
+/** \brief Spawns all projectiles queued in m_vProjectileSpawns.
+ *
+ * \return void
+ *
+ */
+void SceneLevel::SpawnProjectiles()
+{
+    for ( auto& spawn : m_vProjectileSpawns ) {
+        auto m_pBullet1 = std::static_pointer_cast<EntityProjectile>(RespawnBullet());
+        m_pBullet1->SetPosition( spawn.x, spawn.y );
+        m_pBullet1->SetHealth( spawn.nDamage );
+        m_pBullet1->SetSpeed( spawn.vx, spawn.vy );
         m_pBullet1->UpdateBoundingBox();
-        m_pBullet1->SetOwner( enemy->GetID() );
-        if ( nEnemyType == 0 )
-            m_pBullet1->SetProjectile( RESOURCE::ENEMY_PROJECTILE_SLOW );
-        else
-            m_pBullet1->SetProjectile( RESOURCE::ENEMY_PROJECTILE_FAST );
-
-        // Add to updateable and renderable list
-        auto& updateables = GetUpdateables();
-        auto& renderables = GetRenderables();
-
-        int objID = m_pBullet1->GetID();
-        updateables[objID] = m_pBullet1;
-        renderables[objID] = m_pBullet1;
+        m_pBullet1->SetOwner( spawn.nOwner );
+        m_pBullet1->SetProjectile( spawn.nProjectile );
     }
+
+    m_vProjectileSpawns.clear();
 }
 
 void SceneLevel::DeployEnemy()
@@ -499,7 +583,7 @@ void SceneLevel::DeployEnemy()
 
     int YMAX = -(65*2);
     for ( auto& enemy : m_umapEnemies ) {
-        if ( enemy.second->GetY() < YMAX ) {
+        if ( !enemy.second->IsDead() && enemy.second->GetY() < YMAX ) {
             YMAX = enemy.second->GetY();
         }
     }
@@ -518,27 +602,32 @@ void SceneLevel::DeployEnemy()
     enemyClass->SetSpeed( 0, 25 + (rand()%50 + (nEnemyType*50)) + (Math::Limits::clampmax<float>(static_cast<float>((float)m_level*5.0f),100.0f)) );
     enemyClass->SetEnemyType( nEnemyType );
 
-    // Add to updateable and renderable list
-    auto& updateables = GetUpdateables();
-    auto& renderables = GetRenderables();
+    // Enemies deployed above the activation band sleep until they get close to the screen
+    m_EnemyZone.Sleep( m_pEnemy, m_fSceneTime );
+}
+
+/** \brief Updates objects, moves sleeping enemies and wakes up the ones entering the activation band.
+ *
+ * Objects allocated when a pool ran dry are registered first. Dead and sleeping objects skip their own update.
+ *
+ * \param fSeconds float
+ * \param fRealSeconds float
+ * \return void
+ *
+ */
+void SceneLevel::Update( float fSeconds, float fRealSeconds )
+{
+    RegisterPooled();
+    CScene::Update( fSeconds, fRealSeconds );
 
-    int objID = enemyClass->GetID();
-    updateables[objID] = m_pEnemy;
-    renderables[objID] = m_pEnemy;
+    m_fSceneTime += fSeconds;
+    m_EnemyZone.Advance( m_fSceneTime );
 }
 
 void SceneLevel::Explosion( int x, int y, int frame, int fps )
 {
     shared_ptr<EntityExplosion> m_pExplosion = std::static_pointer_cast<EntityExplosion>(RespawnExplosion());
 
-    // Add to updateable and renderable list
-    auto& updateables = GetUpdateables();
-    auto& renderables = GetRenderables();
-
-    int objID = m_pExplosion->GetID();
-    updateables[objID] = m_pExplosion;
-    renderables[objID] = m_pExplosion;
-
     m_pExplosion->SetPosition( x, y );
     m_pExplosion->SetFrame( frame );
     m_pExplosion->SetFPS( fps );
@@ -706,21 +795,22 @@ void SceneLevel::InitHandlers()
                     #ifdef DEBUG
                     case SDLK_t:
                         {
-                            auto& renderables = GetRenderables();
-                            auto& updateables = GetUpdateables();
                             shared_ptr<GameObject_t> m_pEnemy = RespawnEnemy();
                             m_pEnemy->SetPosition( m_iScreenW/2, 64 ); //m_iScreenW/2, 32 ); //-(1024 + (rand() % (m_iScreenH*5))) );
                             m_pEnemy->SetHealth( kEnemyHealth );
                             m_pEnemy->SetSpeed( 0, 0 ); //25 + (rand()%75) );
-                            int objID = m_pEnemy->GetID();
-                            updateables[objID] = m_pEnemy;
-                            renderables[objID] = m_pEnemy;
                         }
                         break;
                     case SDLK_r:
                         m_pPlayer->GetAcceleration()[0] = 0.0f;
                         m_pPlayer->GetAcceleration()[1] = 0.0f;
                         break;
+                    case SDLK_p:
+                        // Toggle stress test bullet pattern
+                        m_bStressPattern = !m_bStressPattern;
+                        cout << "Info: Stress pattern set to " << std::boolalpha << m_bStressPattern << endl;
+                        BuildPatterns();
+                        break;
                     #endif
                     case SDLK_d:
                         // Report loaded asset counts
@@ -805,13 +895,21 @@ void SceneLevel::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
 
+                #ifdef DEBUG_ALLOCATIONS
+                m_AllocationGuard.Begin();
+                #endif
+
+                // Index enemies for target queries (only the guided projectiles need them)
+                if ( m_PlayerPattern.IsAimed() )
+                    UpdateTargetGrid();
+
                 // Fire if player is pressing space
                 if ( m_bKeySpace || m_bFire ) {
-                    if ( SDL_GetTicks() - m_iCooldownTick >= m_iPlayerCooldown / (1.0f+Math::Limits::clampmax<float>((float)m_level/(float)20,3.0f)) )
+                    if ( CSingleton<CClock>::Instance()->GetTicks() - m_iCooldownTick >= m_iPlayerCooldown / (1.0f+Math::Limits::clampmax<float>((float)m_level/(float)20,3.0f)) )
                     {
                         m_bFire = false;
                         PlayerFire();
-                        m_iCooldownTick = SDL_GetTicks();
+                        m_iCooldownTick = CSingleton<CClock>::Instance()->GetTicks();
                     }
                 }
 
@@ -851,7 +949,7 @@ void SceneLevel::InitHandlers()
                         if ( m_bBulletTime && m_iPlayerBulletTime-kPlayerBulletTimeMin>0 )
                         {
                             // yes, start bullet time (slowing down)
-                            m_iPlayerBulletTimeStartTick = SDL_GetTicks();
+                            m_iPlayerBulletTimeStartTick = CSingleton<CClock>::Instance()->GetTicks();
                             m_iPlayerBulletTimeOld = m_iPlayerBulletTime;
                             m_iBulletTimeState++;
                             #ifdef DEBUG
@@ -862,17 +960,17 @@ void SceneLevel::InitHandlers()
                         {
                             if ( m_iPlayerBulletTimeOld == -1 )
                             {
-                                m_iPlayerBulletTimeStartTick = SDL_GetTicks();
+                                m_iPlayerBulletTimeStartTick = CSingleton<CClock>::Instance()->GetTicks();
                                 m_iPlayerBulletTimeOld = m_iPlayerBulletTime;
                             }
 
-                            int iTime = SDL_GetTicks() - m_iPlayerBulletTimeStartTick;
+                            int iTime = CSingleton<CClock>::Instance()->GetTicks() - m_iPlayerBulletTimeStartTick;
                             m_iPlayerBulletTime = m_iPlayerBulletTimeOld + iTime / 2;
                             if ( m_iPlayerBulletTime > m_iPlayerBulletTimeMax )
                             {
                                 m_iPlayerBulletTime = m_iPlayerBulletTimeMax;
                                 m_iPlayerBulletTimeOld = m_iPlayerBulletTime;
-                                m_iPlayerBulletTimeStartTick = SDL_GetTicks();
+                                m_iPlayerBulletTimeStartTick = CSingleton<CClock>::Instance()->GetTicks();
                             }
                         }
 
@@ -882,7 +980,7 @@ void SceneLevel::InitHandlers()
                 // slowing down
                 case 1:
                     {
-                        int iTime = SDL_GetTicks() - m_iPlayerBulletTimeStartTick;
+                        int iTime = CSingleton<CClock>::Instance()->GetTicks() - m_iPlayerBulletTimeStartTick;
                         if ( iTime < 500 ) {
                             float factor = 1.0f - ((float)iTime/500);
                             if ( factor < 0.05f ) factor = 0.05f;
@@ -894,7 +992,7 @@ void SceneLevel::InitHandlers()
                             m_iPlayerBulletTime = m_iPlayerBulletTimeOld - kPlayerBulletTimeMin;
                             CSingleton<CProperties>::Instance()->Property( "Game", "Speed" ) = 0.05f;
                             m_iBulletTimeState++;
-                            m_iPlayerBulletTimeStartTick = SDL_GetTicks();
+                            m_iPlayerBulletTimeStartTick = CSingleton<CClock>::Instance()->GetTicks();
                             m_iPlayerBulletTimeOld = m_iPlayerBulletTime;
                             #ifdef DEBUG
                             cout << "BULLETTIME::STATE==SLOW" << endl;
@@ -907,7 +1005,7 @@ void SceneLevel::InitHandlers()
                 case 2:
                     {
                         // eat bullet time at constant rate
-                        int iTime = SDL_GetTicks() - m_iPlayerBulletTimeStartTick;
+                        int iTime = CSingleton<CClock>::Instance()->GetTicks() - m_iPlayerBulletTimeStartTick;
                         if ( m_iPlayerBulletTimeOld - iTime > 0 )
                             m_iPlayerBulletTime = m_iPlayerBulletTimeOld - iTime;
                         else
@@ -919,11 +1017,11 @@ void SceneLevel::InitHandlers()
                         if ( !m_bBulletTime )
                         {
                             m_iBulletTimeState++;
-                            m_iPlayerBulletTimeStartTick = SDL_GetTicks();
+                            m_iPlayerBulletTimeStartTick = CSingleton<CClock>::Instance()->GetTicks();
                             #ifdef DEBUG
                             cout << "BULLETTIME::STATE==SPEEDING_UP" << endl;
                             #endif
-                            m_iPlayerBulletTimeStartTick = SDL_GetTicks();
+                            m_iPlayerBulletTimeStartTick = CSingleton<CClock>::Instance()->GetTicks();
                             m_iPlayerBulletTimeOld = m_iPlayerBulletTime;
                         }
                     }
@@ -931,7 +1029,7 @@ void SceneLevel::InitHandlers()
 
                 // speedind up
                 case 3:
-                    int iTime = SDL_GetTicks() - m_iPlayerBulletTimeStartTick;
+                    int iTime = CSingleton<CClock>::Instance()->GetTicks() - m_iPlayerBulletTimeStartTick;
                     if ( iTime < 1000 ) {
                         float factor = ((float)iTime/1000);
                         if ( factor < 0.05f ) factor = 0.05f;
@@ -954,11 +1052,14 @@ void SceneLevel::InitHandlers()
                 }
 
                 /// DO ENEMY AI
+                float fCooldownDivisor = 0.1f+Math::Limits::clampmax<float>((float)m_level/(float)25,4.0f);
+                float fEasyCooldown = kfEasyEnemyCooldown / fCooldownDivisor;
+                float fHardCooldown = kfHardEnemyCooldown / fCooldownDivisor;
                 for ( auto& enemy : m_umapEnemies ) {
 
                     auto enemyClass = std::static_pointer_cast<EntityEnemy>(enemy.second);
 
-                    if ( enemyClass->GetY() > 0 && !enemyClass->IsDead() ) {
+                    if ( enemyClass->GetY() > 0 && !enemyClass->IsDead() && !enemyClass->IsSleeping() ) {
 
                         if ( enemyClass->GetY() > m_iScreenH+65 )
                         {
@@ -969,34 +1070,26 @@ void SceneLevel::InitHandlers()
                                 // Respawn to last
                                 int YMAX = -(65*2);
                                 for ( auto& enemyTemp : m_umapEnemies ) {
-                                    if ( enemyTemp.second->GetY() < YMAX ) {
+                                    if ( !enemyTemp.second->IsDead() && enemyTemp.second->GetY() < YMAX ) {
                                         YMAX = enemyTemp.second->GetY();
                                     }
                                 }
                                 enemyClass->SetPosition( rand() % ( m_iScreenW - (65) ) + 65/2, YMAX - 65*2 );
+                                // sleep until it gets close to the screen again
+                                if ( m_EnemyZone.Sleep( enemy.second, m_fSceneTime ) ) {
+                                    continue;
+                                }
                             }
                         }
 
                         if ( m_level > 1 )
                         {
-                            int nEnemyType = enemyClass->GetEnemyType();
-                            if ( nEnemyType == 0 )
+                            // Queue enemies whose cooldown has expired, they are fired in one batch below
+                            float fCooldown = ( enemyClass->GetEnemyType() == 0 ) ? fEasyCooldown : fHardCooldown;
+                            if ( enemyClass->GetCooldownTimer() >= fCooldown )
                             {
-                                // easy enemy
-                                if ( enemyClass->GetCooldownTimer() >= kfEasyEnemyCooldown / (0.1f+Math::Limits::clampmax<float>((float)m_level/(float)25,4.0f)) )
-                                {
-                                    enemyClass->Fire();
-                                    EnemyFire( enemy.second );
-                                }
-                            }
-                            else
-                            {
-                                // hard enemy
-                                if ( enemyClass->GetCooldownTimer() >= kfHardEnemyCooldown / (0.1f+Math::Limits::clampmax<float>((float)m_level/(float)25,4.0f)) )
-                                {
-                                    enemyClass->Fire();
-                                    EnemyFire( enemy.second );
-                                }
+                                enemyClass->Fire();
+                                m_vFiringEnemies.push_back( enemy.second );
                             }
                         }
 
@@ -1004,6 +1097,9 @@ void SceneLevel::InitHandlers()
 
                 }
 
+                // Fire all queued enemies at once
+                EnemyFire();
+
                 /// CHECK COLLISIONS FROM LAST RENDERER SCENE
 
                 // check bullets vs enemies and player
@@ -1018,7 +1114,7 @@ void SceneLevel::InitHandlers()
 
                             // check vs enemy bullet
                             for ( auto& bullet2 : m_umapBullets ) {
-                                if ( bullet2.second->GetOwner() != m_pPlayer->GetID() ) {
+                                if ( !bullet2.second->IsDead() && bullet2.second->GetOwner() != m_pPlayer->GetID() ) {
 
                                     // Check collision between bullet vs bullet
                                     if ( CCollisionDetector::Collides( bullet.second->GetBoundingBox(), bullet2.second->GetBoundingBox() ) ) {
@@ -1042,7 +1138,7 @@ void SceneLevel::InitHandlers()
                                 auto enemyClass = std::static_pointer_cast<EntityEnemy>(enemy.second);
 
                                 // is the enemy alive and on screen?
-                                if ( enemy.second->GetY() > 0 && !enemy.second->IsDead() ) {
+                                if ( enemy.second->GetY() > 0 && !enemy.second->IsDead() && !enemy.second->IsSleeping() ) {
 
                                     // Check collision between bullet vs enemy
                                     if ( CCollisionDetector::Collides( enemy.second->GetBoundingBox(), bullet.second->GetBoundingBox() ) ) {
@@ -1146,7 +1242,7 @@ void SceneLevel::InitHandlers()
                     auto enemyClass = std::static_pointer_cast<EntityEnemy>(enemy.second);
 
                     // is the enemy alive and on screen?
-                    if ( enemy.second->GetY() > 0 && !enemy.second->IsDead() ) {
+                    if ( enemy.second->GetY() > 0 && !enemy.second->IsDead() && !enemy.second->IsSleeping() ) {
 
                         // check player vs enemy
                         if ( !m_pPlayer->IsDead() && CCollisionDetector::Collides( enemy.second->GetBoundingBox(), m_pPlayer->GetBoundingBox() ) ) {
@@ -1200,87 +1296,28 @@ void SceneLevel::InitHandlers()
 
                 /// UPDATE FOR NEXT RENDERING
 
-                // 1. Find dead bullets
-                tmpDeadLst.clear();
-                for ( auto& p : m_umapBullets ) {
-                    if ( p.second->IsDead() ) tmpDeadLst.push_back( p.second->GetID() );
-                }
-
-                // 2. Transfer to dead list
-                for ( auto id : tmpDeadLst ) {
-                    auto& pBullet = m_umapBullets[id];
-                    m_umapDeadBullets.push_front( std::move(pBullet) );
-                    m_umapBullets[id] = nullptr;
-                    m_umapBullets.erase( id );
-                    // remove also from updateables and renderables
-                    auto& updateables = GetUpdateables();
-                    auto& renderables = GetRenderables();
-                    updateables[id] = nullptr;
-                    renderables[id] = nullptr;
-                    updateables.erase( id );
-                    renderables.erase( id );
-                }
-
-                // 1. Find dead enemies
-                tmpDeadLst.clear();
-                for ( auto& p : m_umapEnemies ) {
-                    if ( p.second->IsDead() ) tmpDeadLst.push_back( p.second->GetID() );
-                }
-
-                // 2. Transfer to dead list
-                for ( auto id : tmpDeadLst ) {
-                    auto& pEnemy = m_umapEnemies[id];
-                    m_umapDeadEnemies.push_front( std::move(pEnemy) );
-                    m_umapEnemies[id] = nullptr;
-                    m_umapEnemies.erase( id );
-                    // remove also from updateables and renderables
-                    auto& updateables = GetUpdateables();
-                    auto& renderables = GetRenderables();
-                    updateables[id] = nullptr;
-                    renderables[id] = nullptr;
-                    updateables.erase( id );
-                    renderables.erase( id );
-                }
+                // Dead objects are in the free lists of the pools, they stay registered and are skipped while dead
+                size_t nActiveEnemies = m_umapEnemies.size() - m_umapDeadEnemies.size();
 
                 if ( m_bLevelStarted )
                 {
                     // Deploy enemies if there are under the needed amount
-                    if ( m_umapEnemies.size() < static_cast<unsigned int>(m_level-m_iEnemyKilled) )
+                    if ( nActiveEnemies < static_cast<unsigned int>(m_level-m_iEnemyKilled) )
                     {
                         DeployEnemy();
                     }
 
-                    if ( m_umapEnemies.size() == 0 )
+                    if ( nActiveEnemies == 0 )
                     {
                         // No enemies left, We must start new level
                         NextLevel();
                     }
                 }
 
-
-                // 1. Find dead explosions
-                tmpDeadLst.clear();
-                for ( auto& p : m_umapExplosions ) {
-                    if ( p.second->IsDead() ) tmpDeadLst.push_back( p.second->GetID() );
-                }
-
-                // 2. Transfer to dead list
-                for ( auto id : tmpDeadLst ) {
-                    auto& pExplosion = m_umapExplosions[id];
-                    m_umapDeadExplosions.push_front( std::move(pExplosion) );
-                    m_umapExplosions[id] = nullptr;
-                    m_umapExplosions.erase( id );
-                    // remove also from updateables and renderables
-                    auto& updateables = GetUpdateables();
-                    auto& renderables = GetRenderables();
-                    updateables[id] = nullptr;
-                    renderables[id] = nullptr;
-                    updateables.erase( id );
-                    renderables.erase( id );
-                }
+                size_t nActiveExplosions = m_umapExplosions.size() - m_umapDeadExplosions.size();
 
                 // Go to FADE_OUT it player is dead and no explosions are active
-                if ( m_pPlayer->IsDead() && m_umapExplosions.empty() ) {
+                if ( m_pPlayer->IsDead() && nActiveExplosions == 0 ) {
                     SetState( (int)STATE::FADE_OUT );
                     TimerFactory::Instance()->Get( RESOURCE::TIMER_SCENE_FADEOUT )->Reset();
                 }
@@ -1374,7 +1411,7 @@ void SceneLevel::InitHandlers()
 
                 int m_iShipFrame = m_pPlayer->GetFrame();
 
-                Uint32 ticks = SDL_GetTicks();
+                Uint32 ticks = CSingleton<CClock>::Instance()->GetTicks();
 
                 if ( m_pPlayer->IsMovingX() )
                 {
@@ -1382,13 +1419,13 @@ void SceneLevel::InitHandlers()
                     {
                         if ( m_iShipFrame > 2 ) {
                             m_iShipFrame = 1;
-                            m_iTurnTick = SDL_GetTicks();
+                            m_iTurnTick = CSingleton<CClock>::Instance()->GetTicks();
                         }
                         if ( ticks-m_iTurnTick > 700 ) {
                             if ( m_iShipFrame > 0 ) {
                                 m_iShipFrame--;
                             }
-                            m_iTurnTick = SDL_GetTicks();
+                            m_iTurnTick = CSingleton<CClock>::Instance()->GetTicks();
                         }
                     }
 
@@ -1396,13 +1433,13 @@ void SceneLevel::InitHandlers()
                     {
                         if ( m_iShipFrame < 2 ) {
                             m_iShipFrame = 3;
-                            m_iTurnTick = SDL_GetTicks();
+                            m_iTurnTick = CSingleton<CClock>::Instance()->GetTicks();
                         }
                         if ( ticks-m_iTurnTick > 700 ) {
                             if ( m_iShipFrame < 4 ) {
                                 m_iShipFrame++;
                             }
-                            m_iTurnTick = SDL_GetTicks();
+                            m_iTurnTick = CSingleton<CClock>::Instance()->GetTicks();
                         }
                     }
 
@@ -1413,14 +1450,14 @@ void SceneLevel::InitHandlers()
                     if ( m_iShipFrame > 2 ) {
                         if ( ticks-m_iTurnTick > 100 ) {
                             m_iShipFrame--;
-                            m_iTurnTick = SDL_GetTicks();
+                            m_iTurnTick = CSingleton<CClock>::Instance()->GetTicks();
                         }
                     }
 
                     if ( m_iShipFrame < 2 ) {
                         if ( ticks-m_iTurnTick > 100 ) {
                             m_iShipFrame++;
-                            m_iTurnTick = SDL_GetTicks();
+                            m_iTurnTick = CSingleton<CClock>::Instance()->GetTicks();
                         }
                     }
                 }
@@ -1446,20 +1483,19 @@ void SceneLevel::InitHandlers()
                 auto& renderer = CSingleton<CRenderer>::Instance();
                 auto& fontScore = FontFactory::Instance()->Get( RESOURCE::FONT_SCORE );
                 auto& fontInfo = FontFactory::Instance()->Get( RESOURCE::FONT_SMALL );
-                auto& textScore = TextFactory::Instance()->Get( RESOURCE::TEXT_SCORE );
                 auto& textLevelStarting = TextFactory::Instance()->Get( RESOURCE::TEXT_LEVEL_STARTING );
                 auto& textLevel = TextFactory::Instance()->Get( RESOURCE::TEXT_LEVEL );
                 auto& textLevelInfo = TextFactory::Instance()->Get( RESOURCE::TEXT_LEVEL_INFO );
 
-                // Render score
-                if ( m_score != m_scoreOld || textScore == nullptr ) {
+                // Render score (the text is rendered again only when the score changes)
+                if ( m_score != m_scoreOld ) {
                     // create string
                     std::ostringstream ss;
                     ss << std::setw( 7 ) << std::setfill( '0' ) << m_score;
-                    textScore->Create( fontScore, ss.str().c_str(), 255, 255, 255 );
+                    m_pHudScore->SetText( ss.str() );
                     m_scoreOld = m_score;
                 }
-                renderer->Render( textScore, m_iScreenW - (textScore->GetSurface()->w) - 10, 10 );
+                m_HudScore.Render( renderer );
 
                 // Render level info
                 if ( m_level != m_levelOld || textLevel == nullptr ) {
@@ -1495,45 +1531,19 @@ void SceneLevel::InitHandlers()
                         m_bLevelStarted = true;
                 }
 
-                // Draw shields indicator
-                int nHealth = static_cast<int>((float)m_pPlayer->GetHealth() / 2.5f);
-                int nMaxHealth = static_cast<int>((float)kPlayerHealth / 2.5f);
-
-                m_RectShields.SetPosition( 32-1, m_iScreenH - 32-1 );
-                m_RectShields.SetDimensions( nMaxHealth + 1, 7 );
-                m_RectShields.SetFilled( false );
-                m_RectShields.SetColor( 130, 200, 130, 128 );
-                renderer->Render( &m_RectShields );
-
-                m_RectShields.SetPosition( 32, m_iScreenH - 32 );
-                m_RectShields.SetDimensions( nHealth, 6 );
-                m_RectShields.SetFilled( true );
-                m_RectShields.SetColor( 64, 255, 64, 128 );
-                renderer->Render( &m_RectShields );
-                m_RectShields.SetPosition( 32 + nHealth, m_iScreenH - 32 );
-                m_RectShields.SetDimensions( nMaxHealth - nHealth, 6 );
-                m_RectShields.SetColor( 0, 64, 0, 128 );
-                renderer->Render( &m_RectShields );
-
-                // Draw bullet-time energy indicator
-                int nEnergy = static_cast<int>((float)m_iPlayerBulletTime / 15.0f);
-                int nMaxEnergy = static_cast<int>((float)m_iPlayerBulletTimeMax / 15.0f);
-                m_RectEnergy.SetPosition( 32-1, m_iScreenH - 32 + 9 );
-                m_RectEnergy.SetDimensions( nMaxEnergy + 1, 7 );
-                m_RectEnergy.SetFilled( false );
-                m_RectEnergy.SetColor( 180, 180, 180, 128 );
-                renderer->Render( &m_RectEnergy );
-
-                m_RectEnergy.SetPosition( 32, m_iScreenH - 32 + 10 );
-                m_RectEnergy.SetDimensions( nEnergy, 6 );
-                m_RectEnergy.SetFilled( true );
-                m_RectEnergy.SetColor( 200, 200, 200, 128 );
-                renderer->Render( &m_RectEnergy );
-
-                m_RectEnergy.SetPosition( 32 + nEnergy, m_iScreenH - 32 + 10 );
-                m_RectEnergy.SetDimensions( nMaxEnergy - nEnergy, 6 );
-                m_RectEnergy.SetColor( 100, 100, 100, 128 );
-                renderer->Render( &m_RectEnergy );
+                // Draw shields and bullet-time energy indicators
+                m_pHudShields->SetValue( static_cast<int>((float)m_pPlayer->GetHealth() / 2.5f), static_cast<int>((float)kPlayerHealth / 2.5f) );
+                m_pHudEnergy->SetValue( static_cast<int>((float)m_iPlayerBulletTime / 15.0f), static_cast<int>((float)m_iPlayerBulletTimeMax / 15.0f) );
+                m_HudStatus.Render( renderer );
+
+                #ifdef DEBUG_ALLOCATIONS
+                // Report heap allocations done during this frame (after warm-up)
+                unsigned int nAllocations = m_AllocationGuard.End();
+                if ( m_nAllocationFrames < kAllocationWarmupFrames )
+                    m_nAllocationFrames++;
+                else if ( nAllocations > 0 )
+                    cout << "Warning: " << nAllocations << " heap allocation(s) during frame (level " << m_level << ")" << endl;
+                #endif
             }
         },
         {
@@ -1544,8 +1554,7 @@ void SceneLevel::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                m_blankImg.SetColor(0,0,0,255-m_iScreenAlpha);
-                renderer->Render( &m_blankImg );
+                renderer->RenderFade( 0, 0, 0, 255-m_iScreenAlpha );
             }
         },
         {
@@ -1556,8 +1565,7 @@ void SceneLevel::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                m_blankImg.SetColor(0,0,0,255-m_iScreenAlpha);
-                renderer->Render( &m_blankImg );
+                renderer->RenderFade( 0, 0, 0, 255-m_iScreenAlpha );
             }
         },
         {
@@ -1568,8 +1576,7 @@ void SceneLevel::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                m_blankImg.SetColor(0,0,0,255-m_iScreenAlpha);
-                renderer->Render( &m_blankImg );
+                renderer->RenderFade( 0, 0, 0, 255-m_iScreenAlpha );
             }
         }
     };
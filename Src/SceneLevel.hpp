@@ -38,9 +38,13 @@
 #include "DemoEngine/Scene.hpp"
 #include "DemoEngine/Game.hpp"
 #include "DemoEngine/ScrollingBackground.hpp"
-#include "DemoEngine/Rectangle.hpp"
 #include "DemoEngine/Interpolation.hpp"
 #include "DemoEngine/Math.hpp"
+#include "DemoEngine/SpatialGrid.hpp"
+#include "DemoEngine/BulletPattern.hpp"
+#include "DemoEngine/AllocationCounter.hpp"
+#include "DemoEngine/ActivationZone.hpp"
+#include "DemoEngine/Hud.hpp"
 #include "EntityPlayer.hpp"
 #include "EntityEnemy.hpp"
 #include "EntityProjectile.hpp"
@@ -57,7 +61,8 @@ using std::vector;
 
 typedef CGameObjectFloat GameObject_t;
 typedef unordered_map<Uint32, shared_ptr<GameObject_t>> GameObjectList_t;
-typedef forward_list<shared_ptr<GameObject_t>> DeadGameObjectList_t;
+typedef vector<Uint32> DeadGameObjectList_t;    // ids of the dead objects of a pool
+typedef CSpatialGrid<GameObject_t> GameObjectGrid_t;
 
 class SceneLevel : public CScene
 {
@@ -86,6 +91,18 @@ class SceneLevel : public CScene
         const float kfEasyEnemyCooldown = 1.50f;
         const float kfHardEnemyCooldown = 0.30f;
 
+        // Default pool capacities (can be set with Pools/Bullets, Pools/Enemies and Pools/Explosions properties)
+        const Uint32 kDefaultBulletPool = 256;
+        const Uint32 kDefaultEnemyPool = 64;
+        const Uint32 kDefaultExplosionPool = 128;
+
+        // Default distance from the screen edge where sleeping enemies wake up (Game/ActivationMargin property)
+        const Uint32 kDefaultActivationMargin = 130;
+
+        #ifdef DEBUG_ALLOCATIONS
+        const unsigned int kAllocationWarmupFrames = 120;
+        #endif
+
         typedef enum class {
             START = 0,
             FADE_IN,
@@ -94,22 +111,32 @@ class SceneLevel : public CScene
             END = 999           // Stop scene automatically (=999)
         } STATE;
 
-        SceneLevel() : m_umapEnemies(), m_umapDeadEnemies(), m_umapBullets(), m_umapDeadBullets(), m_umapExplosions(), m_umapDeadExplosions(), tmpDeadLst(), m_blankImg(), m_RectShields(), m_RectEnergy() {};
+        typedef CBulletPatternProgram::Spawn_t ProjectileSpawn_t;
+
+        SceneLevel() : m_umapEnemies(), m_umapDeadEnemies(), m_umapBullets(), m_umapDeadBullets(), m_umapExplosions(), m_umapDeadExplosions(), m_vPendingPooled(), m_EnemyGrid(), m_EnemyZone(), m_vFiringEnemies(), m_vFiringOrigins(), m_vProjectileSpawns(), m_PlayerPattern(), m_vEnemyPatterns(), m_HudScore(), m_HudStatus(), m_pHudScore(), m_pHudShields(), m_pHudEnergy() {};
         ~SceneLevel() {};
 
         void Initialize() override;
 
         void InitHandlers() override;
+        using CScene::Update;
+        void Update( float fSeconds, float fRealSeconds ) override;
         void Load() override;
         void OnEnter() override;
         void OnExit() override;
 
+        void BuildPatterns();
         void PlayerFire();
-        void EnemyFire( shared_ptr<GameObject_t> enemy );
+        void EnemyFire();
+        void SpawnProjectiles();
         void DeployEnemy();
         void Explosion( int x, int y, int frame = 0, int fps = 30 );
         void KillPlayer();
         void NextLevel();
+        void UpdateTargetGrid();
+        void PrewarmPools();
+        void AddPooled( const shared_ptr<GameObject_t>& pObject, GameObjectList_t& objects, DeadGameObjectList_t& deadObjects );
+        void RegisterPooled();
 
         shared_ptr<GameObject_t> RespawnBullet();
         shared_ptr<GameObject_t> RespawnEnemy();
@@ -122,7 +149,7 @@ class SceneLevel : public CScene
     private:
         shared_ptr<EntityPlayer> m_pPlayer = nullptr;
 
-        // Enemies
+        // Enemies (pooled objects stay in the maps, the ids of the dead ones are in the free lists)
         GameObjectList_t m_umapEnemies;
         DeadGameObjectList_t m_umapDeadEnemies;
 
@@ -134,7 +161,24 @@ class SceneLevel : public CScene
         GameObjectList_t m_umapExplosions;
         DeadGameObjectList_t m_umapDeadExplosions;
 
-        vector<Uint32> tmpDeadLst;
+        // Pooled objects waiting to be added to the updateables and renderables
+        vector<shared_ptr<GameObject_t>> m_vPendingPooled;
+
+        // Spatial index of targetable enemies (rebuilt every frame)
+        GameObjectGrid_t m_EnemyGrid;
+
+        // Enemies outside of the activation band sleep until they come close to the screen
+        CActivationZone m_EnemyZone;
+        float m_fSceneTime = 0.0f;
+
+        // Enemies that fire this frame and the projectiles they spawn
+        vector<shared_ptr<GameObject_t>> m_vFiringEnemies;
+        vector<CBulletPatternProgram::Origin_t> m_vFiringOrigins;
+        vector<ProjectileSpawn_t> m_vProjectileSpawns;
+
+        // Compiled bullet patterns (rebuilt when the level changes)
+        CBulletPatternProgram m_PlayerPattern;
+        vector<CBulletPatternProgram> m_vEnemyPatterns;
 
         int m_score = 0;
         int m_scoreOld = -1;
@@ -145,7 +189,6 @@ class SceneLevel : public CScene
 
         // unordered_map< shared_ptr<Explosion>> m_umapExplosions;
 
-        CRectangle m_blankImg;
         Uint8 m_iScreenAlpha = 0;
 
         // Keys
@@ -166,6 +209,7 @@ class SceneLevel : public CScene
         int m_iEnemyHitTotal = 0;
         bool m_bLevelStarted = false;
         bool m_bImmortal = false;
+        bool m_bStressPattern = false;
 
         // Firing cool down timer
         bool m_bBulletTime = false;
@@ -182,14 +226,20 @@ class SceneLevel : public CScene
         int m_iScreenW = 0;
         int m_iScreenH = 0;
 
-        // Shields indicator
-        CRectangle m_RectShields;
-
-        // Energy indicator
-        CRectangle m_RectEnergy;
+        // HUD, the score at the top and the shields and bullet-time energy at the bottom
+        CHud m_HudScore;
+        CHud m_HudStatus;
+        shared_ptr<CHudText> m_pHudScore;
+        shared_ptr<CHudBar> m_pHudShields;
+        shared_ptr<CHudBar> m_pHudEnergy;
 
         // Ship deceleration timers
         Uint32 m_iTurnTick = 0;
+
+        #ifdef DEBUG_ALLOCATIONS
+        CAllocationGuard m_AllocationGuard;
+        unsigned int m_nAllocationFrames = 0;
+        #endif
 };
 
 #endif // SCENELEVEL1_HPP
@@ -31,6 +31,7 @@ void SceneSplashScreen::Initialize() {
     #ifdef DEBUG
     cout << "SceneSplashScreen::Initialize() called" << endl;
     #endif
+    SetDirtyRectangles( true );
     InitHandlers();
     SetInitialized( true );
 }
@@ -306,7 +307,7 @@ void SceneSplashScreen::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_INTRO ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_INTRO ) );
                 RenderMenu( renderer );
             }
         },
@@ -318,7 +319,7 @@ void SceneSplashScreen::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_INTRO ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_INTRO ) );
                 RenderMenu( renderer );
             }
         },
@@ -330,7 +331,7 @@ void SceneSplashScreen::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_TITLE ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_TITLE ) );
                 RenderMenu( renderer );
             }
         },
@@ -342,7 +343,7 @@ void SceneSplashScreen::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_TITLE ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_TITLE ) );
                 RenderMenu( renderer );
             }
         },
@@ -354,7 +355,7 @@ void SceneSplashScreen::InitHandlers()
             [&](SDL_Event& ev){
                 DISCARD_UNUNSED_PARAMETER( ev );
                 auto& renderer = CSingleton<CRenderer>::Instance();
-                renderer->Render( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_TITLE ), 0, 0 );
+                renderer->RenderBackground( CSingleton<CResourceFactory<int, CImageAlpha>>::Instance()->Get( RESOURCE::BACKGROUND_TITLE ) );
                 RenderMenu( renderer );
             }
         }
@@ -131,6 +131,63 @@ void CShooterGame::Initialize()
         AnimationFactory::Instance()->Get( RESOURCE::MENU_TEXT )->LoadAnimation( "Assets/Menu/texts.anim" );
     }
 
+    // Pre-rotate the sprites that turn towards their direction of travel (0 angles turns this off),
+    // only the player projectiles change heading. Bake the drop shadows into the plane sprites.
+    int nBankAngles = (Uint32)CSingleton<CProperties>::Instance()->Property( "Video", "SpriteBankAngles", (Uint32)32 );
+    bool bBakedShadows = (bool)CSingleton<CProperties>::Instance()->Property( "Video", "BakedShadows", (bool)true );
+    if ( nBankAngles > 0 )
+    {
+        SpriteBankFactory::Instance()->Get( RESOURCE::PLAYER_PROJECTILE )->Build( "Assets/Sprites/plasma_up_yellow.png", nBankAngles );
+    }
+    if ( bBakedShadows )
+    {
+        // Enemy shadows are drawn 45, 55 from the top left corner of the ship
+        const char* szShadow = "Assets/Sprites/plane_down_shadow_0.5x.png";
+        ShadowedSpriteFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_GREEN )->Build( "Assets/Sprites/plane_green_down.png", szShadow, 45, 55, 50 );
+        ShadowedSpriteFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_RED )->Build( "Assets/Sprites/plane_red_down.png", szShadow, 45, 55, 50 );
+        ShadowedSpriteFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_GREEN_HIT )->Build( "Assets/Sprites/plane_green_down_hit.png", szShadow, 45, 55, 50 );
+        ShadowedSpriteFactory::Instance()->Get( RESOURCE::ENEMY_PLANE_RED_HIT )->Build( "Assets/Sprites/plane_red_down_hit.png", szShadow, 45, 55, 50 );
+
+        // Player animation frames ("Plane" is EntityPlayer::kAnimationName), the shadow is drawn 45, 55 from the plane
+        auto& anim = AnimationFactory::Instance()->Get( RESOURCE::PLAYER_PLANE );
+        auto& animShadow = AnimationFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_SHADOW );
+        vector<SDL_Rect> vRects;
+        vector<SDL_Rect> vShadowRects;
+        for ( Uint32 nFrame = 0; nFrame < anim->GetAnimationFrames( "Plane" ); ++nFrame ) {
+            vRects.push_back( anim->GetAnimationRect( "Plane", nFrame ) );
+            vShadowRects.push_back( animShadow->GetAnimationRect( "Plane", nFrame ) );
+        }
+        szShadow = "Assets/Sprites/player_plane_shadow_0.5x.png";
+        ShadowedSpriteFactory::Instance()->Get( RESOURCE::PLAYER_PLANE )->Build( "Assets/Sprites/player_plane.png", szShadow, 45, 55, 50, vRects, vShadowRects );
+        ShadowedSpriteFactory::Instance()->Get( RESOURCE::PLAYER_PLANE_HIT )->Build( "Assets/Sprites/player_plane_hit.png", szShadow, 45, 55, 50, vRects, vShadowRects );
+    }
+
+    // Pack the small sprites into atlas pages (images too large for a page are left as they are)
+    if ( (bool)CSingleton<CProperties>::Instance()->Property( "Video", "SpriteAtlas", (bool)true ) )
+    {
+        CSpriteAtlas atlas;
+        for ( int id : { RESOURCE::PLAYER_PLANE, RESOURCE::PLAYER_PLANE_HIT, RESOURCE::PLAYER_PLANE_SHADOW,
+                         RESOURCE::PLAYER_PROJECTILE, RESOURCE::PLAYER_PROJECTILE_GUIDED,
+                         RESOURCE::ENEMY_PROJECTILE_SLOW, RESOURCE::ENEMY_PROJECTILE_FAST,
+                         RESOURCE::ENEMY_PLANE_GREEN, RESOURCE::ENEMY_PLANE_RED,
+                         RESOURCE::ENEMY_PLANE_GREEN_HIT, RESOURCE::ENEMY_PLANE_RED_HIT, RESOURCE::ENEMY_PLANE_SHADOW,
+                         RESOURCE::EXPLOSION, RESOURCE::MENU_TEXT, RESOURCE::MENU_TEXT_SELECTED } )
+        {
+            atlas.Add( ImageAlphaFactory::Instance()->Get( id ) );
+        }
+        SpriteBankFactory::Instance()->Get( RESOURCE::PLAYER_PROJECTILE )->AddTo( atlas );
+        for ( int id : { RESOURCE::PLAYER_PLANE, RESOURCE::PLAYER_PLANE_HIT,
+                         RESOURCE::ENEMY_PLANE_GREEN, RESOURCE::ENEMY_PLANE_RED,
+                         RESOURCE::ENEMY_PLANE_GREEN_HIT, RESOURCE::ENEMY_PLANE_RED_HIT } )
+        {
+            ShadowedSpriteFactory::Instance()->Get( id )->AddTo( atlas );
+        }
+        atlas.Pack();
+        #ifdef DEBUG
+        atlas.Print();
+        #endif
+    }
+
     // load backgrounds using Factory pattern
     {
         ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_INTRO )->Load( "Assets/Backgrounds/intro_screen.png" );
@@ -142,8 +199,6 @@ void CShooterGame::Initialize()
         ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_CLOUDS1 )->Load( "Assets/Backgrounds/clouds1_tr50.png" );
         ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_CLOUDS2 )->Load( "Assets/Backgrounds/clouds2_tr50.png" );
         ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_MOONSURFACE )->SetAlpha(255);
-        ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_CLOUDS1 )->SetAlpha(0);
-        ImageAlphaFactory::Instance()->Get( RESOURCE::BACKGROUND_CLOUDS2 )->SetAlpha(0);
         // Create layers and set the bitmaps
         ScrollingBackgroundFactory::Instance()->Get( RESOURCE::SCROLLING_MOONSURFACE )->Initialize(1);
         ScrollingBackgroundFactory::Instance()->Get( RESOURCE::SCROLLING_CLOUDS )->Initialize(2);
@@ -300,6 +355,11 @@ void CShooterGame::Initialize()
         m_noteImgWidth = noteText->GetSurface()->w;
     }
 
+    #ifdef DEBUG
+    // Report how the loaded images were converted to the screen format
+    CSingleton<CDisplayFormat>::Instance()->Print();
+    #endif
+
     // Load scenes into memory and set first scene as running
     {
         unique_ptr<CScene> SplashScene = unique_ptr<SceneSplashScreen>(new SceneSplashScreen);
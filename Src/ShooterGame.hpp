@@ -33,6 +33,9 @@
 #include "DemoEngine/Game.hpp"
 #include "DemoEngine/Font.hpp"
 #include "DemoEngine/Scene.hpp"
+#include "DemoEngine/SpriteAtlas.hpp"
+#include "DemoEngine/SpriteBank.hpp"
+#include "DemoEngine/ShadowedSprite.hpp"
 
 using std::cout;
 using std::endl;
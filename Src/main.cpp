@@ -27,13 +27,68 @@
 
 using namespace DemoEngine;
 
+/** \brief Sets properties from the command line
+ *
+ *  --headless          Render into memory without a window (Video/Headless)
+ *  --frames=N          Quit after N frames (Game/MaxFrames)
+ *  --seed=N            Random seed of headless runs (Game/Seed)
+ *  --dump=DIR          Save frames as DIR/frame_NNNNN.bmp (Video/DumpPath)
+ *  --golden=DIR        Compare frames against DIR/frame_NNNNN.bmp (Video/GoldenPath)
+ *  --interval=N        Dump and compare every Nth frame (Video/CaptureInterval)
+ *  --tolerance=N       Allowed difference per color channel (Video/DiffTolerance)
+ *  --ratio=F           Allowed share of differing pixels (Video/DiffRatio)
+ *  --record=PATH       Record frames to PATH, a directory for bmp or a file for y4m (Video/RecordPath)
+ *  --record-format=F   bmp or y4m (Video/RecordFormat)
+ *  --record-buffer=N   Frames buffered before frames are dropped (Video/RecordBuffer)
+ *
+ * \param argc int
+ * \param argv char**
+ * \return void
+ *
+ */
+static void ParseCommandLine( int argc, char **argv )
+{
+    auto& properties = CSingleton<CProperties>::Instance();
+    for ( int i = 1; i < argc; ++i ) {
+        string sArg( argv[i] );
+        size_t nSplit = sArg.find( '=' );
+        string sName = sArg.substr( 0, nSplit );
+        string sValue = ( nSplit != string::npos ? sArg.substr( nSplit + 1 ) : "" );
+        if ( sName == "--headless" )
+            properties->Property( "Video", "Headless" ) = (bool)true;
+        else if ( sName == "--frames" )
+            properties->Property( "Game", "MaxFrames" ) = (Uint32)strtoul( sValue.c_str(), nullptr, 10 );
+        else if ( sName == "--seed" )
+            properties->Property( "Game", "Seed" ) = (Uint32)strtoul( sValue.c_str(), nullptr, 10 );
+        else if ( sName == "--dump" )
+            properties->Property( "Video", "DumpPath" ) = sValue;
+        else if ( sName == "--golden" )
+            properties->Property( "Video", "GoldenPath" ) = sValue;
+        else if ( sName == "--interval" )
+            properties->Property( "Video", "CaptureInterval" ) = (Uint32)strtoul( sValue.c_str(), nullptr, 10 );
+        else if ( sName == "--tolerance" )
+            properties->Property( "Video", "DiffTolerance" ) = (Uint32)strtoul( sValue.c_str(), nullptr, 10 );
+        else if ( sName == "--ratio" )
+            properties->Property( "Video", "DiffRatio" ) = (float)atof( sValue.c_str() );
+        else if ( sName == "--record" )
+            properties->Property( "Video", "RecordPath" ) = sValue;
+        else if ( sName == "--record-format" )
+            properties->Property( "Video", "RecordFormat" ) = sValue;
+        else if ( sName == "--record-buffer" )
+            properties->Property( "Video", "RecordBuffer" ) = (Uint32)strtoul( sValue.c_str(), nullptr, 10 );
+        else
+            cout << "Unknown argument: " << sArg << endl;
+    }
+}
+
 int main( int argc, char **argv )
 {
-    DISCARD_UNUNSED_PARAMETER( argc );
-    DISCARD_UNUNSED_PARAMETER( argv );
+    int iResult = 0;
 
     try {
 
+        ParseCommandLine( argc, argv );
+
         // Set properties (these are also the edefaults)
         /*
         CSingleton<CProperties>::Instance()->Section("Video") =
@@ -60,12 +115,17 @@ int main( int argc, char **argv )
         CShooterGame app;
         while ( app.Execute() );
 
+        // Failed golden image comparisons fail the run
+        if ( app.GetGoldenFailures() > 0 )
+            iResult = 1;
+
     }
     catch (std::exception &ex ) {
 
         cout << "Runtime Error Exception: " << ex.what() << endl;
+        iResult = 1;
 
     }
 
-	return( 0 );
+	return( iResult );
 }